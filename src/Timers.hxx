@@ -14,11 +14,23 @@
 #include <fstream>
 #include <string>
 #include <list>
+#include <map>
+#include <vector>
 #include <algorithm>
 
 struct Timers : public std::list<std::pair<std::string, Timer>>
 {
+  using Clock = std::chrono::high_resolution_clock;
+
   bool debug = false;
+  // The time spent on each block in each stage of the current
+  // iteration, and the total over num_block_iterations finished
+  // iterations, for write_cost_profile.  Indexed by the stage, and
+  // then by the position of the block in Block_Info::block_indices.
+  std::map<std::string, std::vector<Clock::duration>> block_elapsed,
+    block_total;
+  size_t num_block_iterations = 0;
+
   Timers(const bool &Debug) : debug(Debug) {}
 
   Timer &add_and_start(const std::string &name)
@@ -37,6 +49,50 @@ struct Timers : public std::list<std::pair<std::string, Timer>>
     return back().second;
   }
 
+  // Add a timer that was measured outside of add_and_start(), such
+  // as the total time spent on one block by a set of worker threads.
+  void add_elapsed(const std::string &name,
+                   const std::chrono::high_resolution_clock::duration &elapsed)
+  {
+    emplace_back(name, Timer());
+    back().second.stop_time = back().second.start_time + elapsed;
+  }
+
+  // Only call this from the main thread.
+  void add_block_elapsed(const std::string &stage, const size_t &block,
+                         const Clock::duration &elapsed)
+  {
+    auto &stage_elapsed(block_elapsed[stage]);
+    if(stage_elapsed.size() <= block)
+      {
+        stage_elapsed.resize(block + 1, Clock::duration(0));
+      }
+    stage_elapsed[block] += elapsed;
+  }
+
+  // Called at the end of each iteration.  The times are only added to
+  // block_total if is_counted, so that an iteration that stops part
+  // way through, or a first iteration where many quantities are
+  // still zero, does not skew it.
+  void finish_block_iteration(const bool &is_counted)
+  {
+    if(is_counted)
+      {
+        for(auto &stage : block_elapsed)
+          {
+            auto &total(block_total[stage.first]);
+            total.resize(std::max(total.size(), stage.second.size()),
+                         Clock::duration(0));
+            for(size_t block = 0; block < stage.second.size(); ++block)
+              {
+                total[block] += stage.second[block];
+              }
+          }
+        ++num_block_iterations;
+      }
+    block_elapsed.clear();
+  }
+
   void write_profile(const std::string &filename) const
   {
     std::ofstream f(filename);
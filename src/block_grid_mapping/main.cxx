@@ -1,51 +1,170 @@
 #include "../compute_block_grid_mapping.hxx"
 
 #include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <string>
+
+// Compare the mapping from greedy_block_grid_mapping with the one from
+// compute_block_grid_mapping, for costs given either on the command
+// line or in a block_timings file written by sdpb.
+//
+// Given a second file, estimated_block_timings from sdpb
+// --verbosity=2, also show the mapping that sdpb computes from the
+// cost model, with the groups timed by the first file.  The last line
+// is the time of its slowest group divided by that of the mapping
+// from the first file.  If every block in the first file took at most
+// 1 ms, this is an error, because the times can not tell the mappings
+// apart.
+
+namespace
+{
+  void print_mapping(const std::string &name,
+                     const std::vector<std::vector<Block_Map>> &mapping,
+                     const std::vector<Block_Cost> &costs)
+  {
+    std::cout << name << "\n";
+    for(size_t node = 0; node < mapping.size(); ++node)
+      {
+        for(auto &m : mapping[node])
+          {
+            std::cout << node << " " << m.num_procs << ": "
+                      << m.cost / static_cast<double>(m.num_procs) << ", {";
+            for(size_t ii = 0; ii < m.block_indices.size(); ++ii)
+              {
+                if(ii != 0)
+                  {
+                    std::cout << ",";
+                  }
+                std::cout << "(" << m.block_indices[ii] << ",";
+                for(auto &cost : costs)
+                  {
+                    if(cost.index == m.block_indices[ii])
+                      {
+                        std::cout << cost.cost;
+                        break;
+                      }
+                  }
+                std::cout << ")";
+              }
+            std::cout << "}\n";
+          }
+        std::cout << "\n";
+      }
+    double makespan, ideal;
+    block_grid_mapping_makespan(mapping, makespan, ideal);
+    std::cout << "Slowest group: " << makespan << "\n"
+              << "Balanced: " << ideal << "\n"
+              << "Imbalance: " << (ideal == 0 ? 1 : makespan / ideal)
+              << "\n\n";
+  }
+
+  std::vector<Block_Cost> read_block_timings(const std::string &filename)
+  {
+    std::ifstream block_timings(filename);
+    if(!block_timings.good())
+      {
+        std::cerr << "Could not open '" << filename << "'\n";
+        exit(1);
+      }
+    std::vector<Block_Cost> result;
+    size_t cost;
+    block_timings >> cost;
+    while(block_timings.good())
+      {
+        result.emplace_back(cost, result.size());
+        block_timings >> cost;
+      }
+    return result;
+  }
+
+  bool is_filename(const std::string &argument)
+  {
+    return argument.find_first_not_of("0123456789") != std::string::npos;
+  }
+}
 
 int main(int argc, char *argv[])
 {
   if(argc < 4)
     {
-      std::cerr
-        << "Need at least 3 arguments: procs_per_node, num_nodes, costs...\n";
+      std::cerr << "Need at least 3 arguments: procs_per_node, num_nodes, "
+                   "and either costs... or a block_timings file, "
+                   "optionally followed by an estimated_block_timings "
+                   "file\n";
       exit(1);
     }
-  size_t num_procs(std::stoi(argv[1])), procs_per_node(std::stoi(argv[2]));
-  std::vector<Block_Cost> costs;
-  for(int ii = 3; ii < argc; ++ii)
+  size_t procs_per_node(std::stoi(argv[1])), num_nodes(std::stoi(argv[2]));
+  std::vector<Block_Cost> costs, estimated_costs;
+  const std::string first_cost(argv[3]);
+  if(argc <= 5 && is_filename(first_cost))
+    {
+      costs = read_block_timings(first_cost);
+      if(argc == 5)
+        {
+          // Times are in whole milliseconds, so blocks that took less
+          // than 1 ms all look the same, and any mapping is as good as
+          // any other.
+          if(std::all_of(
+               costs.begin(), costs.end(),
+               [](const Block_Cost &cost) { return cost.cost <= 1; }))
+            {
+              std::cerr << "Every block in '" << first_cost
+                        << "' took at most 1 ms, which is too short to "
+                           "compare mappings\n";
+              exit(1);
+            }
+          estimated_costs = read_block_timings(argv[4]);
+          if(estimated_costs.size() != costs.size())
+            {
+              std::cerr << "'" << first_cost << "' and '" << argv[4]
+                        << "' have different numbers of blocks\n";
+              exit(1);
+            }
+        }
+    }
+  else
     {
-      costs.emplace_back(std::stoi(argv[ii]), ii - 3);
+      for(int ii = 3; ii < argc; ++ii)
+        {
+          costs.emplace_back(std::stoi(argv[ii]), ii - 3);
+        }
     }
   std::sort(costs.rbegin(), costs.rend());
-  std::vector<std::vector<Block_Map>> mapping(
-    compute_block_grid_mapping(num_procs, procs_per_node, costs));
 
-  for(size_t node = 0; node < mapping.size(); ++node)
+  print_mapping("Greedy",
+                greedy_block_grid_mapping(procs_per_node, num_nodes, costs),
+                costs);
+  const std::vector<std::vector<Block_Map>> refined(
+    compute_block_grid_mapping(procs_per_node, num_nodes, costs));
+  print_mapping("Refined", refined, costs);
+
+  if(!estimated_costs.empty())
     {
-      for(auto &m : mapping[node])
+      std::vector<size_t> timed(costs.size());
+      for(auto &cost : costs)
         {
-          std::cout << node << " " << m.num_procs << ": "
-                    << m.cost / static_cast<double>(m.num_procs) << ", {";
-          for(size_t ii = 0; ii < m.block_indices.size(); ++ii)
-            {
-              if(ii != 0)
-                {
-                  std::cout << ",";
-                }
-              std::cout << "(" << m.block_indices[ii] << ",";
-              for(auto &cost: costs)
-                {
-                  if(cost.index==m.block_indices[ii])
-                    {
-                      std::cout << cost.cost;
-                      break;
-                    }
-                }
-              std::cout << ")";
-            }
-          std::cout << "}\n";
+          timed[cost.index] = cost.cost;
         }
-      std::cout << "\n";
+      std::sort(estimated_costs.rbegin(), estimated_costs.rend());
+      std::vector<std::vector<Block_Map>> estimated(
+        compute_block_grid_mapping(procs_per_node, num_nodes,
+                                   estimated_costs));
+      for(auto &groups : estimated)
+        for(auto &block_map : groups)
+          {
+            block_map.cost = 0;
+            for(auto &block : block_map.block_indices)
+              {
+                block_map.cost += timed[block];
+              }
+          }
+      print_mapping("Estimated", estimated, costs);
+
+      double makespan, estimated_makespan, ideal;
+      block_grid_mapping_makespan(refined, makespan, ideal);
+      block_grid_mapping_makespan(estimated, estimated_makespan, ideal);
+      std::cout << "Estimated / refined: " << estimated_makespan / makespan
+                << "\n";
     }
 }
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Block_Cost.hxx"
+#include "Block_Map.hxx"
+
+#include <vector>
+
+// Allocate blocks to groups of procs on each node.  block_costs must
+// be sorted with the largest first.  The result has an entry for each
+// node, and the groups on each node cover all of its procs.
+std::vector<std::vector<Block_Map>>
+compute_block_grid_mapping(const size_t &procs_per_node,
+                           const size_t &num_nodes,
+                           const std::vector<Block_Cost> &block_costs);
+
+// The original Worst Fit First allocation, which
+// compute_block_grid_mapping starts from.
+std::vector<std::vector<Block_Map>>
+greedy_block_grid_mapping(const size_t &procs_per_node,
+                          const size_t &num_nodes,
+                          const std::vector<Block_Cost> &block_costs);
+
+// Local search that moves blocks and procs between the slowest group
+// and other groups, or merges and splits it with another group on the
+// same node, as long as that makes the slowest group faster.
+void refine_block_grid_mapping(const std::vector<Block_Cost> &block_costs,
+                               std::vector<std::vector<Block_Map>> &mapping);
+
+// Replace mapping with an optimal assignment of blocks to single
+// procs, if there are few enough blocks and it is faster.
+void exact_block_grid_mapping(const size_t &procs_per_node,
+                              const std::vector<Block_Cost> &block_costs,
+                              std::vector<std::vector<Block_Map>> &mapping);
+
+// The predicted time of the slowest group, max(cost/num_procs), and
+// the time if the work were perfectly balanced, total cost/total
+// procs.  makespan/ideal is the imbalance.
+void block_grid_mapping_makespan(
+  const std::vector<std::vector<Block_Map>> &mapping, double &makespan,
+  double &ideal);
+
+// The memory needed on each node by mapping, where each block needs
+// block_memory[index], each group group_memory, and each proc
+// proc_memory.
+std::vector<size_t>
+block_grid_mapping_memory(const std::vector<std::vector<Block_Map>> &mapping,
+                          const std::vector<size_t> &block_memory,
+                          const size_t &group_memory,
+                          const size_t &proc_memory);
+
+// Move groups and blocks between nodes until every node needs at
+// most max_memory.  Returns false if that could not be done.
+bool fit_block_grid_mapping_memory(
+  const std::vector<Block_Cost> &block_costs,
+  const std::vector<size_t> &block_memory, const size_t &group_memory,
+  const size_t &proc_memory, const size_t &max_memory,
+  std::vector<std::vector<Block_Map>> &mapping);
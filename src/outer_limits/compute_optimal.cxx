@@ -14,6 +14,8 @@ compute_optimal(const std::vector<Positive_Matrix_With_Prefactor> &matrices,
                 const SDP_Solver_Parameters &parameters_in)
 {
   SDP_Solver_Parameters parameters(parameters_in);
+  // The blocks are allocated once, for every SDP in the loop below.
+  parameters.rebalance_threshold = 0;
 
   size_t num_weights(normalization.size());
 
@@ -1,6 +1,7 @@
 #include "Mesh.hxx"
 #include "../sdp_read.hxx"
 #include "../sdp_solve.hxx"
+#include "../sdp_solve/MPI_Thread_Environment.hxx"
 
 #include "../ostream_vector.hxx"
 
@@ -60,12 +61,14 @@ compute_optimal(const std::vector<Positive_Matrix_With_Prefactor> &matrices,
 
 int main(int argc, char **argv)
 {
+  MPI_Thread_Environment mpi_env(argc, argv);
   El::Environment env(argc, argv);
   SDP_Solver_Parameters parameters(argc, argv);
   if(!parameters.is_valid())
     {
       return 0;
     }
+  mpi_env.check_num_threads(parameters.num_threads);
 
   const int64_t precision(parameters.precision);
   El::gmp::SetPrecision(precision);
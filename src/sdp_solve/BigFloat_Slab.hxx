@@ -0,0 +1,72 @@
+#pragma once
+
+#include <El.hpp>
+
+// Contiguous storage for the limbs of El::BigFloat matrices.
+//
+// Every El::BigFloat owns a separate heap allocation for its limbs,
+// so the elements of a block are normally scattered across the heap,
+// and each one pays for malloc's bookkeeping.  While a
+// BigFloat_Slab_Scope is alive, GMP allocations made by the current
+// thread are instead carved out of a single slab sized for
+// num_elements numbers at the current default precision.  Matrices
+// constructed inside the scope then have all of their limbs in one
+// contiguous region.
+//
+// This works underneath Elemental by replacing GMP's memory
+// functions, so El::Matrix<El::BigFloat> and every Elemental routine
+// work unchanged.  Elements that are later moved or swapped out of
+// the matrix keep pointing into the slab, and the slab is only
+// released once every number allocated from it has been freed.
+// Allocations that do not fit in the slab, all allocations made
+// outside of a scope, and scopes for less than a page of numbers, go
+// to malloc.
+
+class BigFloat_Slab_Scope
+{
+public:
+  explicit BigFloat_Slab_Scope(const size_t &num_elements);
+  ~BigFloat_Slab_Scope();
+  BigFloat_Slab_Scope(const BigFloat_Slab_Scope &) = delete;
+  BigFloat_Slab_Scope &operator=(const BigFloat_Slab_Scope &) = delete;
+
+private:
+  void *slab, *previous_slab;
+};
+
+// An upper bound on the number of local elements of a height x width
+// El::DistMatrix on grid.
+inline size_t
+max_local_elements(const size_t &height, const size_t &width,
+                   const El::Grid &grid)
+{
+  return ((height + grid.Height() - 1) / grid.Height())
+         * ((width + grid.Width() - 1) / grid.Width());
+}
+
+// Install the GMP memory functions used by BigFloat_Slab_Scope.
+// These also count the number of allocations.  It is safe to call
+// this more than once, and after numbers have already been allocated.
+void install_gmp_memory_functions();
+
+// Number of calls to GMP's allocation functions since
+// install_gmp_memory_functions() was first called.
+size_t gmp_allocation_count();
+
+// Marks code where the solver sets up its own matrices, as opposed to
+// the temporaries that Elemental allocates inside routines like Gemm.
+// While one is alive, GMP allocations made by the current thread are
+// also counted in solver_allocation_count().  Scopes can nest.
+class Solver_Allocation_Scope
+{
+public:
+  Solver_Allocation_Scope();
+  ~Solver_Allocation_Scope();
+  Solver_Allocation_Scope(const Solver_Allocation_Scope &) = delete;
+  Solver_Allocation_Scope &operator=(const Solver_Allocation_Scope &)
+    = delete;
+};
+
+// Number of GMP allocations made inside a Solver_Allocation_Scope
+// since install_gmp_memory_functions() was first called.
+size_t solver_allocation_count();
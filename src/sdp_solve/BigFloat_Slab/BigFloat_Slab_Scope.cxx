@@ -0,0 +1,60 @@
+#include "gmp_memory_functions.hxx"
+
+#include <cstdlib>
+#include <new>
+
+BigFloat_Slab_Scope::BigFloat_Slab_Scope(const size_t &num_elements)
+    : slab(nullptr), previous_slab(current_slab)
+{
+  install_gmp_memory_functions();
+
+  // Find the number of bytes in a number at the current precision.
+  // This has to happen before the slab becomes current.
+  mpf_t sample;
+  mpf_init(sample);
+  const size_t element_bytes(
+    slab_round_up((sample->_mp_prec + 1) * sizeof(mp_limb_t)));
+  mpf_clear(sample);
+
+  // A slab takes at least a whole page, so a few numbers are cheaper
+  // to get from malloc.
+  const size_t header_bytes(slab_round_up(sizeof(Slab))),
+    number_bytes(num_elements * element_bytes);
+  if(number_bytes < slab_page_bytes)
+    {
+      current_slab = nullptr;
+      return;
+    }
+  const size_t total_bytes((header_bytes + number_bytes + slab_page_bytes - 1)
+                           / slab_page_bytes * slab_page_bytes);
+  char *memory(
+    static_cast<char *>(std::aligned_alloc(slab_page_bytes, total_bytes)));
+  if(memory == nullptr)
+    {
+      throw std::bad_alloc();
+    }
+  Slab *new_slab(new(memory) Slab);
+  new_slab->live = 1;
+  new_slab->begin = memory + header_bytes;
+  new_slab->next = new_slab->begin;
+  new_slab->end = new_slab->begin + number_bytes;
+  if(!register_slab(new_slab))
+    {
+      new_slab->~Slab();
+      std::free(memory);
+      current_slab = nullptr;
+      return;
+    }
+
+  slab = new_slab;
+  current_slab = new_slab;
+}
+
+BigFloat_Slab_Scope::~BigFloat_Slab_Scope()
+{
+  current_slab = static_cast<Slab *>(previous_slab);
+  if(slab != nullptr)
+    {
+      release_slab(static_cast<Slab *>(slab));
+    }
+}
@@ -0,0 +1,11 @@
+#include "gmp_memory_functions.hxx"
+
+Solver_Allocation_Scope::Solver_Allocation_Scope()
+{
+  ++solver_allocation_depth;
+}
+
+Solver_Allocation_Scope::~Solver_Allocation_Scope()
+{
+  --solver_allocation_depth;
+}
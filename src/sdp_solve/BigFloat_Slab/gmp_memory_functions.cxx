@@ -0,0 +1,188 @@
+#include "gmp_memory_functions.hxx"
+
+#include <gmp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+// Numbers are not given a header, so free and realloc find the slab,
+// if any, that a number came from by the page that it is on.
+// Everything else came from malloc, including numbers that GMP's
+// default functions allocated before ours were installed.
+//
+// Every free and realloc looks up its page, so the lookup takes no
+// lock.  The map has two levels, like a page table, and covers the
+// lowest 2^48 bytes of the address space.  Leaves are created when a
+// slab first needs them and are never freed.  Entries are only
+// written for pages of a slab while no number on them is alive, so a
+// lookup for a live number always sees its own slab, and one for a
+// number from malloc always sees nullptr.
+
+namespace
+{
+  std::atomic<size_t> allocation_count(0), solver_allocations(0);
+  std::once_flag install_flag;
+
+  constexpr size_t page_bits(12), leaf_bits(18), root_bits(18);
+  static_assert(size_t(1) << page_bits == slab_page_bytes,
+                "page_bits does not match slab_page_bytes");
+  constexpr uintptr_t num_pages(uintptr_t(1) << (leaf_bits + root_bits)),
+    leaf_mask((uintptr_t(1) << leaf_bits) - 1);
+
+  std::atomic<std::atomic<Slab *> *> page_map[size_t(1) << root_bits];
+  // Only held while creating a leaf.
+  std::mutex leaf_mutex;
+
+  Slab *find_slab(void *pointer)
+  {
+    const uintptr_t page(reinterpret_cast<uintptr_t>(pointer) >> page_bits);
+    if(page >= num_pages)
+      {
+        return nullptr;
+      }
+    std::atomic<Slab *> *leaf(
+      page_map[page >> leaf_bits].load(std::memory_order_acquire));
+    return leaf == nullptr
+             ? nullptr
+             : leaf[page & leaf_mask].load(std::memory_order_acquire);
+  }
+
+  // Set the entry of every page in [begin, end) to slab.
+  void set_pages(const char *begin, const char *end, Slab *slab)
+  {
+    const uintptr_t first(reinterpret_cast<uintptr_t>(begin) >> page_bits),
+      last((reinterpret_cast<uintptr_t>(end) - 1) >> page_bits);
+    for(uintptr_t page(first); page <= last; ++page)
+      {
+        std::atomic<std::atomic<Slab *> *> &root(page_map[page >> leaf_bits]);
+        std::atomic<Slab *> *leaf(root.load(std::memory_order_acquire));
+        if(leaf == nullptr)
+          {
+            std::lock_guard<std::mutex> lock(leaf_mutex);
+            leaf = root.load(std::memory_order_acquire);
+            if(leaf == nullptr)
+              {
+                leaf = new std::atomic<Slab *>[size_t(1) << leaf_bits]();
+                root.store(leaf, std::memory_order_release);
+              }
+          }
+        leaf[page & leaf_mask].store(slab, std::memory_order_release);
+      }
+  }
+
+  // GMP calls these functions from C, so an exception must not leave
+  // them.  Fail the same way that GMP's default functions do.
+  [[noreturn]] void out_of_memory(const size_t &size)
+  {
+    std::fprintf(stderr, "GNU MP: Cannot allocate memory (size=%zu)\n",
+                 size);
+    std::abort();
+  }
+
+  void count_allocation()
+  {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if(solver_allocation_depth > 0)
+      {
+        solver_allocations.fetch_add(1, std::memory_order_relaxed);
+      }
+  }
+
+  void *allocate(size_t size)
+  {
+    count_allocation();
+    Slab *slab(current_slab);
+    const size_t rounded(slab_round_up(size));
+    if(slab != nullptr && rounded <= size_t(slab->end - slab->next))
+      {
+        char *memory(slab->next);
+        slab->next += rounded;
+        slab->live.fetch_add(1, std::memory_order_relaxed);
+        return memory;
+      }
+    void *memory(std::malloc(size));
+    if(memory == nullptr)
+      {
+        out_of_memory(size);
+      }
+    return memory;
+  }
+
+  void deallocate(void *pointer, size_t)
+  {
+    if(pointer == nullptr)
+      {
+        return;
+      }
+    Slab *slab(find_slab(pointer));
+    if(slab == nullptr)
+      {
+        std::free(pointer);
+      }
+    else
+      {
+        release_slab(slab);
+      }
+  }
+
+  void *reallocate(void *pointer, size_t old_size, size_t new_size)
+  {
+    Slab *slab(find_slab(pointer));
+    if(slab == nullptr)
+      {
+        count_allocation();
+        void *result(std::realloc(pointer, new_size));
+        if(result == nullptr)
+          {
+            out_of_memory(new_size);
+          }
+        return result;
+      }
+    void *result(allocate(new_size));
+    std::memcpy(result, pointer, std::min(old_size, new_size));
+    release_slab(slab);
+    return result;
+  }
+}
+
+thread_local Slab *current_slab(nullptr);
+thread_local size_t solver_allocation_depth(0);
+
+// The slab starts with its own header, so its pages run from the
+// header to the end of its numbers.
+bool register_slab(Slab *slab)
+{
+  if(reinterpret_cast<uintptr_t>(slab->end) > (num_pages << page_bits))
+    {
+      return false;
+    }
+  set_pages(reinterpret_cast<char *>(slab), slab->end, slab);
+  return true;
+}
+
+// Every number in the slab has been freed, so no other thread can be
+// looking for it in find_slab().
+void release_slab(Slab *slab)
+{
+  if(slab->live.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      set_pages(reinterpret_cast<char *>(slab), slab->end, nullptr);
+      slab->~Slab();
+      std::free(slab);
+    }
+}
+
+void install_gmp_memory_functions()
+{
+  std::call_once(install_flag, []() {
+    mp_set_memory_functions(allocate, reallocate, deallocate);
+  });
+}
+
+size_t gmp_allocation_count() { return allocation_count; }
+
+size_t solver_allocation_count() { return solver_allocations; }
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../BigFloat_Slab.hxx"
+
+#include <atomic>
+
+// A block of memory that numbers are carved out of.  'live' counts
+// the numbers allocated from the slab that have not been freed, plus
+// one for the BigFloat_Slab_Scope that created it.
+struct Slab
+{
+  std::atomic<size_t> live;
+  char *begin, *next, *end;
+};
+
+// The slab that the current thread allocates from, if any.
+extern thread_local Slab *current_slab;
+
+// The number of Solver_Allocation_Scope's alive on the current thread
+extern thread_local size_t solver_allocation_depth;
+
+// Slabs are allocated in whole pages, aligned to a page, so that no
+// other allocation shares a page with a slab.
+constexpr size_t slab_page_bytes(4096);
+
+// Make the pages of a slab known to GMP's free and realloc.  Returns
+// false, without registering it, if the slab is outside of the
+// addresses that can be registered.  Slabs are removed when they are
+// released.
+bool register_slab(Slab *slab);
+void release_slab(Slab *slab);
+
+// Round allocations up so that every number stays 16 byte aligned.
+inline size_t slab_round_up(const size_t &size)
+{
+  return (size + 15) & ~size_t(15);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+// How to compute the bilinear pairings of Y.
+//
+// - gemm: Multiply Y by the bilinear bases on both sides with Gemm's.
+//
+// - cholesky: Write Y = L L^T, so that the pairings are
+//   (L^T W)^T (L^T W), where W is the bilinear basis.  This needs one
+//   triangular multiply and one Syrk, which fills only half of the
+//   result.  It uses fewer flops when the blocks have few copies of
+//   the bilinear basis (small m_j).
+//
+// - cholesky_check: Use cholesky, but also compute the gemm result
+//   and throw an exception if they differ by more than the working
+//   precision.
+
+enum class Bilinear_Pairings_Y_Method
+{
+  gemm,
+  cholesky,
+  cholesky_check
+};
+
+Bilinear_Pairings_Y_Method
+to_bilinear_pairings_Y_method(const std::string &name);
+
+std::ostream &
+operator<<(std::ostream &os, const Bilinear_Pairings_Y_Method &method);
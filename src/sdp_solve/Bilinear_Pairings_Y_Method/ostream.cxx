@@ -0,0 +1,15 @@
+#include "../Bilinear_Pairings_Y_Method.hxx"
+
+std::ostream &
+operator<<(std::ostream &os, const Bilinear_Pairings_Y_Method &method)
+{
+  switch(method)
+    {
+    case Bilinear_Pairings_Y_Method::gemm: os << "gemm"; break;
+    case Bilinear_Pairings_Y_Method::cholesky: os << "cholesky"; break;
+    case Bilinear_Pairings_Y_Method::cholesky_check:
+      os << "cholesky_check";
+      break;
+    }
+  return os;
+}
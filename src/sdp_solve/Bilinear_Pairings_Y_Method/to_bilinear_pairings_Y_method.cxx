@@ -0,0 +1,24 @@
+#include "../Bilinear_Pairings_Y_Method.hxx"
+
+#include <stdexcept>
+
+Bilinear_Pairings_Y_Method
+to_bilinear_pairings_Y_method(const std::string &name)
+{
+  if(name == "gemm")
+    {
+      return Bilinear_Pairings_Y_Method::gemm;
+    }
+  else if(name == "cholesky")
+    {
+      return Bilinear_Pairings_Y_Method::cholesky;
+    }
+  else if(name == "cholesky_check")
+    {
+      return Bilinear_Pairings_Y_Method::cholesky_check;
+    }
+  throw std::runtime_error("Invalid argument for bilinearPairingsY.  "
+                           "Expected one of gemm, cholesky, or "
+                           "cholesky_check, but found: "
+                           + name);
+}
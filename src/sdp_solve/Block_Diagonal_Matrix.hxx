@@ -7,16 +7,24 @@
 
 #pragma once
 
+#include "BigFloat_Slab.hxx"
+
 #include <El.hpp>
 
 #include <list>
 
+// M := (M + M^T)/2 for a single block.  Blocks on a single rank are
+// averaged in place, without any temporaries.
+void symmetrize_block(El::Matrix<El::BigFloat> &block);
+void symmetrize_block(El::DistMatrix<El::BigFloat> &block);
+
 // A block-diagonal square matrix
 //
 //   M = Diagonal(M_0, M_1, ..., M_{bMax-1})
 //
 // where each block M_b is a square-matrix (of possibly different
-// sizes).
+// sizes).  The limbs of each block are stored contiguously (see
+// BigFloat_Slab.hxx).
 class Block_Diagonal_Matrix
 {
 public:
@@ -46,8 +54,24 @@ public:
       }
   }
 
+  Block_Diagonal_Matrix(const Block_Diagonal_Matrix &A)
+  {
+    blocks.reserve(A.blocks.size());
+    for(auto &block : A.blocks)
+      {
+        BigFloat_Slab_Scope slab_scope(block.LocalHeight()
+                                       * block.LocalWidth());
+        blocks.emplace_back(block);
+      }
+  }
+  Block_Diagonal_Matrix(Block_Diagonal_Matrix &&) = default;
+  Block_Diagonal_Matrix &operator=(const Block_Diagonal_Matrix &) = default;
+  Block_Diagonal_Matrix &operator=(Block_Diagonal_Matrix &&) = default;
+
   void add_block(const size_t &block_size, const El::Grid &grid)
   {
+    BigFloat_Slab_Scope slab_scope(
+      max_local_elements(block_size, block_size, grid));
     blocks.emplace_back(block_size, block_size, grid);
   }
 
@@ -92,21 +116,8 @@ public:
       }
   }
 
-  void symmetrize()
-  {
-    for(auto &block : blocks)
-      {
-        // FIXME: This feels expensive
-
-        // We can not use El::MakeSymmetric() because that just copies
-        // the lower part to the upper part.  We need to average the
-        // upper and lower parts.
-        block *= 0.5;
-        El::DistMatrix<El::BigFloat> transpose(block.Grid());
-        El::Transpose(block, transpose, false);
-        block += transpose;
-      }
-  }
+  // M := (M + M^T)/2, using symmetrize_block()
+  void symmetrize();
 
   // The maximal absolute value of the elements of M
   El::BigFloat max_abs() const
@@ -119,6 +130,12 @@ public:
     return max;
   }
 
+  // The maximal absolute value of the elements in the lower triangle
+  // of a symmetric M that live on this rank.  Unlike max_abs(), there
+  // is no communication: the maximum over all ranks is left to the
+  // caller, so that it can be batched with other reductions.
+  El::BigFloat local_symmetric_max_abs() const;
+
   friend std::ostream &
   operator<<(std::ostream &os, const Block_Diagonal_Matrix &A);
 };
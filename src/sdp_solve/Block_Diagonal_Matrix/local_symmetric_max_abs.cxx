@@ -0,0 +1,29 @@
+#include "../Block_Diagonal_Matrix.hxx"
+
+El::BigFloat Block_Diagonal_Matrix::local_symmetric_max_abs() const
+{
+  El::BigFloat max(0), element;
+  for(auto &block : blocks)
+    {
+      const El::Matrix<El::BigFloat> &local(block.LockedMatrix());
+      for(int64_t local_column = 0; local_column < local.Width();
+          ++local_column)
+        {
+          const int64_t column(block.GlobalCol(local_column));
+          for(int64_t local_row = 0; local_row < local.Height(); ++local_row)
+            {
+              if(block.GlobalRow(local_row) >= column)
+                {
+                  mpf_abs(
+                    element.gmp_float.get_mpf_t(),
+                    local(local_row, local_column).gmp_float.get_mpf_t());
+                  if(element > max)
+                    {
+                      max = element;
+                    }
+                }
+            }
+        }
+    }
+  return max;
+}
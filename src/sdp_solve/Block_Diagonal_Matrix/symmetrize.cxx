@@ -0,0 +1,43 @@
+#include "../Block_Diagonal_Matrix.hxx"
+
+void symmetrize_block(El::Matrix<El::BigFloat> &block)
+{
+  // M_rc = M_cr = (M_rc + M_cr)/2.  Halving is exact, so this gives
+  // the same result as averaging M and M^T.
+  for(int64_t column = 0; column < block.Width(); ++column)
+    for(int64_t row = column + 1; row < block.Height(); ++row)
+      {
+        mpf_ptr lower(block(row, column).gmp_float.get_mpf_t()),
+          upper(block(column, row).gmp_float.get_mpf_t());
+        mpf_add(lower, lower, upper);
+        mpf_div_2exp(lower, lower, 1);
+        mpf_set(upper, lower);
+      }
+}
+
+void symmetrize_block(El::DistMatrix<El::BigFloat> &block)
+{
+  if(block.Grid().Size() == 1)
+    {
+      symmetrize_block(block.Matrix());
+    }
+  else
+    {
+      // The transpose of a distributed block lives on other ranks.
+      // We can not use El::MakeSymmetric() because that just copies
+      // the lower part to the upper part.  We need to average the
+      // upper and lower parts.
+      block *= 0.5;
+      El::DistMatrix<El::BigFloat> transpose(block.Grid());
+      El::Transpose(block, transpose, false);
+      block += transpose;
+    }
+}
+
+void Block_Diagonal_Matrix::symmetrize()
+{
+  for(auto &block : blocks)
+    {
+      symmetrize_block(block);
+    }
+}
@@ -43,6 +43,10 @@ class Block_Info
 {
 public:
   boost::filesystem::path block_timings_filename;
+  // Set if the costs came from a Cost_Profile instead.
+  boost::filesystem::path cost_profile_filename;
+  // Set if the costs came from estimate_block_costs instead.
+  std::vector<Block_Cost> estimated_costs;
   size_t file_num_procs;
   std::vector<std::vector<size_t>> file_block_indices;
 
@@ -62,6 +66,12 @@ public:
     // (0 <= b < bMax)
     bilinear_pairing_block_sizes;
 
+  // Estimated bytes for the matrices of each block, for each group of
+  // processes, and for each process (see estimate_block_memory).
+  // Only set when there is a memory limit.
+  std::vector<size_t> block_memory;
+  size_t group_memory = 0, proc_memory = 0;
+
   std::vector<size_t> block_indices;
   MPI_Group_Wrapper mpi_group;
   MPI_Comm_Wrapper mpi_comm;
@@ -69,22 +79,28 @@ public:
   Block_Info() = delete;
   Block_Info(const boost::filesystem::path &sdp_directory,
              const boost::filesystem::path &checkpoint_in,
+             const boost::filesystem::path &cost_profile_directory,
              const size_t &procs_per_node, const size_t &proc_granularity,
-             const Verbosity &verbosity);
+             const size_t &max_memory_per_node, const Verbosity &verbosity);
   Block_Info(const boost::filesystem::path &sdp_directory,
              const El::Matrix<int32_t> &block_timings,
              const size_t &procs_per_node, const size_t &proc_granularity,
-             const Verbosity &verbosity);
+             const size_t &max_memory_per_node, const Verbosity &verbosity);
   Block_Info(const std::vector<size_t> &matrix_dimensions,
              const size_t &procs_per_node, const size_t &proc_granularity,
              const Verbosity &verbosity);
   void read_block_info(const boost::filesystem::path &sdp_directory);
   std::vector<Block_Cost>
   read_block_costs(const boost::filesystem::path &sdp_directory,
-                   const boost::filesystem::path &checkpoint_in);
+                   const boost::filesystem::path &checkpoint_in,
+                   const boost::filesystem::path &cost_profile_directory);
+  std::vector<Block_Cost>
+  estimate_block_costs(const boost::filesystem::path &sdp_directory);
+  void estimate_block_memory(const boost::filesystem::path &sdp_directory);
   void
   allocate_blocks(const std::vector<Block_Cost> &block_costs,
                   const size_t &procs_per_node, const size_t &proc_granularity,
+                  const size_t &max_memory_per_node,
                   const Verbosity &verbosity);
 };
 
@@ -102,6 +118,8 @@ namespace std
   inline void swap(Block_Info &a, Block_Info &b)
   {
     swap(a.block_timings_filename, b.block_timings_filename);
+    swap(a.cost_profile_filename, b.cost_profile_filename);
+    swap(a.estimated_costs, b.estimated_costs);
     swap(a.file_num_procs, b.file_num_procs);
     swap(a.file_block_indices, b.file_block_indices);
     swap(a.dimensions, b.dimensions);
@@ -109,6 +127,9 @@ namespace std
     swap(a.schur_block_sizes, b.schur_block_sizes);
     swap(a.psd_matrix_block_sizes, b.psd_matrix_block_sizes);
     swap(a.bilinear_pairing_block_sizes, b.bilinear_pairing_block_sizes);
+    swap(a.block_memory, b.block_memory);
+    swap(a.group_memory, b.group_memory);
+    swap(a.proc_memory, b.proc_memory);
     swap(a.block_indices, b.block_indices);
     swap(a.mpi_group, b.mpi_group);
     swap(a.mpi_comm, b.mpi_comm);
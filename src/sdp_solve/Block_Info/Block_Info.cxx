@@ -2,29 +2,42 @@
 
 Block_Info::Block_Info(const boost::filesystem::path &sdp_directory,
                        const boost::filesystem::path &checkpoint_in,
+                       const boost::filesystem::path &cost_profile_directory,
                        const size_t &procs_per_node,
                        const size_t &proc_granularity,
+                       const size_t &max_memory_per_node,
                        const Verbosity &verbosity)
 {
   read_block_info(sdp_directory);
+  if(max_memory_per_node != 0)
+    {
+      estimate_block_memory(sdp_directory);
+    }
   std::vector<Block_Cost> block_costs(
-    read_block_costs(sdp_directory, checkpoint_in));
-  allocate_blocks(block_costs, procs_per_node, proc_granularity, verbosity);
+    read_block_costs(sdp_directory, checkpoint_in, cost_profile_directory));
+  allocate_blocks(block_costs, procs_per_node, proc_granularity,
+                  max_memory_per_node, verbosity);
 }
 
 Block_Info::Block_Info(const boost::filesystem::path &sdp_directory,
                        const El::Matrix<int32_t> &block_timings,
                        const size_t &procs_per_node,
                        const size_t &proc_granularity,
+                       const size_t &max_memory_per_node,
                        const Verbosity &verbosity)
 {
   read_block_info(sdp_directory);
+  if(max_memory_per_node != 0)
+    {
+      estimate_block_memory(sdp_directory);
+    }
   std::vector<Block_Cost> block_costs;
   for(int64_t block = 0; block < block_timings.Height(); ++block)
     {
       block_costs.emplace_back(block_timings(block, 0), block);
     }
-  allocate_blocks(block_costs, procs_per_node, proc_granularity, verbosity);
+  allocate_blocks(block_costs, procs_per_node, proc_granularity,
+                  max_memory_per_node, verbosity);
 }
 
 Block_Info::Block_Info(const std::vector<size_t> &matrix_dimensions,
@@ -57,5 +70,6 @@ Block_Info::Block_Info(const std::vector<size_t> &matrix_dimensions,
       block_costs.emplace_back(
         schur_block_sizes[block] * schur_block_sizes[block], block);
     }
-  allocate_blocks(block_costs, procs_per_node, proc_granularity, verbosity);
+  allocate_blocks(block_costs, procs_per_node, proc_granularity, 0,
+                  verbosity);
 }
@@ -1,15 +1,59 @@
-#include "../../../Block_Cost.hxx"
-#include "../../../Block_Map.hxx"
+#include "../../../compute_block_grid_mapping.hxx"
 #include "../../Block_Info.hxx"
 
-std::vector<std::vector<Block_Map>>
-compute_block_grid_mapping(const size_t &procs_per_node,
-                           const size_t &num_nodes,
-                           const std::vector<Block_Cost> &block_costs);
+#include <iomanip>
+
+namespace
+{
+  std::string format_bytes(const size_t &bytes)
+  {
+    std::stringstream ss;
+    ss << std::setprecision(3) << bytes / (1024.0 * 1024.0 * 1024.0)
+       << " GiB";
+    return ss.str();
+  }
+
+  // Explain why the blocks do not fit in max_memory_per_node, with the
+  // predicted memory of each node, and the largest blocks.
+  std::string
+  memory_report(const std::string &reason, const size_t &max_memory_per_node,
+                const std::vector<size_t> &node_memory,
+                const std::vector<size_t> &block_memory,
+                const size_t &group_memory, const size_t &proc_memory)
+  {
+    std::stringstream ss;
+    ss << "The SDP does not fit in maxMemoryPerNode = "
+       << format_bytes(max_memory_per_node) << ": " << reason << "\n";
+    for(size_t node = 0; node < node_memory.size(); ++node)
+      {
+        ss << "\tnode " << node << ": " << format_bytes(node_memory[node])
+           << "\n";
+      }
+    std::vector<size_t> blocks(block_memory.size());
+    std::iota(blocks.begin(), blocks.end(), 0);
+    std::sort(blocks.begin(), blocks.end(),
+              [&](const size_t &a, const size_t &b) {
+                return block_memory[a] > block_memory[b];
+              });
+    blocks.resize(std::min(blocks.size(), size_t(10)));
+    ss << "Largest blocks:\n";
+    for(auto &block : blocks)
+      {
+        ss << "\tblock " << block << ": " << format_bytes(block_memory[block])
+           << "\n";
+      }
+    ss << "Every group of processes also needs "
+       << format_bytes(group_memory) << ", and every process "
+       << format_bytes(proc_memory)
+       << ".  Use more nodes, or a lower precision.";
+    return ss.str();
+  }
+}
 
 void Block_Info::allocate_blocks(const std::vector<Block_Cost> &block_costs,
                                  const size_t &procs_per_node,
                                  const size_t &proc_granularity,
+                                 const size_t &max_memory_per_node,
                                  const Verbosity &verbosity)
 {
   // Reverse sort, with largest first
@@ -34,8 +78,45 @@ void Block_Info::allocate_blocks(const std::vector<Block_Cost> &block_costs,
         + "\n\tprocGranularity: " + std::to_string(proc_granularity));
     }
   const size_t num_nodes(num_procs / procs_per_node);
+  // Fail before anything is allocated if no mapping could fit, either
+  // because a block is too large for any node, or because all of the
+  // blocks are too large for all of the nodes.
+  if(max_memory_per_node != 0)
+    {
+      const size_t node_overhead(group_memory
+                                 + proc_memory * procs_per_node);
+      size_t total(node_overhead * num_nodes), largest(0);
+      for(auto &memory : block_memory)
+        {
+          total += memory;
+          largest = std::max(largest, memory);
+        }
+      if(node_overhead + largest > max_memory_per_node
+         || total > max_memory_per_node * num_nodes)
+        {
+          throw std::runtime_error(memory_report(
+            node_overhead + largest > max_memory_per_node
+              ? "the largest block does not fit on a node."
+              : "all of the blocks need more than all of the nodes.",
+            max_memory_per_node,
+            std::vector<size_t>(num_nodes, total / num_nodes), block_memory,
+            group_memory, proc_memory));
+        }
+    }
   std::vector<std::vector<Block_Map>> mapping(compute_block_grid_mapping(
     procs_per_node / proc_granularity, num_nodes, sorted_costs));
+  if(max_memory_per_node != 0
+     && !fit_block_grid_mapping_memory(
+       block_costs, block_memory, group_memory,
+       proc_memory * proc_granularity, max_memory_per_node, mapping))
+    {
+      throw std::runtime_error(memory_report(
+        "the blocks could not be arranged to fit on every node.",
+        max_memory_per_node,
+        block_grid_mapping_memory(mapping, block_memory, group_memory,
+                                  proc_memory * proc_granularity),
+        block_memory, group_memory, proc_memory));
+    }
 
   for(auto &block_vector : mapping)
     for(auto &block_map : block_vector)
@@ -74,6 +155,22 @@ void Block_Info::allocate_blocks(const std::vector<Block_Cost> &block_costs,
             }
           ss << "\n";
         }
+      double makespan, ideal;
+      block_grid_mapping_makespan(mapping, makespan, ideal);
+      ss << "Predicted cost of the slowest group: " << makespan
+         << "\nPerfectly balanced cost: " << ideal
+         << "\nImbalance: " << (ideal == 0 ? 1 : makespan / ideal) << "\n";
+      if(max_memory_per_node != 0)
+        {
+          const std::vector<size_t> node_memory(block_grid_mapping_memory(
+            mapping, block_memory, group_memory, proc_memory));
+          ss << "Predicted memory per node:";
+          for(auto &memory : node_memory)
+            {
+              ss << " " << format_bytes(memory);
+            }
+          ss << " (limit " << format_bytes(max_memory_per_node) << ")\n";
+        }
       El::Output(ss.str());
     }
 
@@ -0,0 +1,20 @@
+#include "../../../../compute_block_grid_mapping.hxx"
+
+#include <algorithm>
+
+void block_grid_mapping_makespan(
+  const std::vector<std::vector<Block_Map>> &mapping, double &makespan,
+  double &ideal)
+{
+  size_t total_cost(0), total_procs(0);
+  makespan = 0;
+  for(auto &node : mapping)
+    for(auto &block_map : node)
+      {
+        total_cost += block_map.cost;
+        total_procs += block_map.num_procs;
+        makespan = std::max(
+          makespan, block_map.cost / static_cast<double>(block_map.num_procs));
+      }
+  ideal = (total_procs == 0 ? 0 : total_cost / double(total_procs));
+}
@@ -0,0 +1,20 @@
+#include "../../../../compute_block_grid_mapping.hxx"
+
+std::vector<size_t>
+block_grid_mapping_memory(const std::vector<std::vector<Block_Map>> &mapping,
+                          const std::vector<size_t> &block_memory,
+                          const size_t &group_memory,
+                          const size_t &proc_memory)
+{
+  std::vector<size_t> result(mapping.size(), 0);
+  for(size_t node = 0; node < mapping.size(); ++node)
+    for(auto &block_map : mapping[node])
+      {
+        result[node] += group_memory + proc_memory * block_map.num_procs;
+        for(auto &block : block_map.block_indices)
+          {
+            result[node] += block_memory[block];
+          }
+      }
+  return result;
+}
@@ -0,0 +1,33 @@
+#include "../../../../compute_block_grid_mapping.hxx"
+
+// Allocate blocks to MPI processes, minimizing the predicted time of
+// the slowest group of processes, cost/num_procs.
+//
+// 1) greedy_block_grid_mapping gives a starting point, using Worst
+//    Fit First.
+//
+// 2) refine_block_grid_mapping repeatedly takes the slowest group and
+//    moves or swaps its blocks with other single proc groups, gives it
+//    procs from other groups on the same node, or merges it with
+//    another group on the same node and splits them again.  This fixes
+//    the imbalance when block_maps are split, and lets large blocks
+//    that were forced onto a crowded node share its procs.
+//
+// 3) With only a few blocks, exact_block_grid_mapping searches for the
+//    best assignment of blocks to single procs, and uses it if it is
+//    faster.
+//
+// Every step uses integer arithmetic and deterministic tie breaking,
+// so that every rank computes the same mapping.
+
+std::vector<std::vector<Block_Map>>
+compute_block_grid_mapping(const size_t &procs_per_node,
+                           const size_t &num_nodes,
+                           const std::vector<Block_Cost> &block_costs)
+{
+  std::vector<std::vector<Block_Map>> result(
+    greedy_block_grid_mapping(procs_per_node, num_nodes, block_costs));
+  refine_block_grid_mapping(block_costs, result);
+  exact_block_grid_mapping(procs_per_node, block_costs, result);
+  return result;
+}
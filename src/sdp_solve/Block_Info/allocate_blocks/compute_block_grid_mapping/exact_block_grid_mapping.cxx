@@ -0,0 +1,129 @@
+#include "../../../../compute_block_grid_mapping.hxx"
+
+#include <algorithm>
+#include <numeric>
+
+// Depth first branch and bound over all assignments of blocks to
+// single procs, largest block first, minimizing the largest total
+// cost on a proc.  This is only attempted when there are more blocks
+// than procs, and at most max_blocks of them.  Procs with the same
+// load are interchangeable, so only the first of them is tried.  The
+// search gives up after max_nodes assignments, so that it always
+// finishes quickly, and stops early once it reaches the lower bound
+// max(largest cost, total cost/num_procs).
+//
+// mapping is only replaced if the result is strictly faster than its
+// slowest group.  Procs are numbered consecutively across nodes, so
+// the result respects node boundaries trivially.
+
+namespace
+{
+  const size_t max_blocks(16), max_nodes(1000000);
+
+  struct Search
+  {
+    const std::vector<size_t> &costs;
+    std::vector<size_t> loads, assignment, best_assignment;
+    size_t limit, lower_bound, num_nodes = 0;
+
+    Search(const std::vector<size_t> &Costs, const size_t &num_procs,
+           const size_t &Limit, const size_t &Lower_bound)
+        : costs(Costs), loads(num_procs, 0), assignment(Costs.size()),
+          limit(Limit), lower_bound(Lower_bound)
+    {}
+
+    // Returns false if the search should stop.
+    bool search(const size_t &block)
+    {
+      if(block == costs.size())
+        {
+          limit = *std::max_element(loads.begin(), loads.end());
+          best_assignment = assignment;
+          return limit > lower_bound;
+        }
+      for(size_t proc = 0; proc < loads.size(); ++proc)
+        {
+          if(loads[proc] + costs[block] >= limit
+             || std::find(loads.begin(), loads.begin() + proc, loads[proc])
+                  != loads.begin() + proc)
+            {
+              continue;
+            }
+          if(++num_nodes > max_nodes)
+            {
+              return false;
+            }
+          loads[proc] += costs[block];
+          assignment[block] = proc;
+          const bool is_continuing(search(block + 1));
+          loads[proc] -= costs[block];
+          if(!is_continuing)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  };
+}
+
+void exact_block_grid_mapping(const size_t &procs_per_node,
+                              const std::vector<Block_Cost> &block_costs,
+                              std::vector<std::vector<Block_Map>> &mapping)
+{
+  const size_t num_procs(procs_per_node * mapping.size());
+  if(block_costs.size() <= num_procs || block_costs.size() > max_blocks)
+    {
+      return;
+    }
+
+  // Only accept a maximum load M if M < cost/num_procs of the slowest
+  // group, i.e. M < ceil(cost/num_procs).
+  const Block_Map *slowest(nullptr);
+  for(auto &groups : mapping)
+    for(auto &block_map : groups)
+      {
+        if(slowest == nullptr || *slowest < block_map)
+          {
+            slowest = &block_map;
+          }
+      }
+  if(slowest == nullptr)
+    {
+      return;
+    }
+  const size_t limit((slowest->cost + slowest->num_procs - 1)
+                     / slowest->num_procs);
+
+  std::vector<Block_Cost> sorted_costs(block_costs);
+  std::sort(sorted_costs.rbegin(), sorted_costs.rend());
+  std::vector<size_t> costs;
+  for(auto &block_cost : sorted_costs)
+    {
+      costs.push_back(block_cost.cost);
+    }
+  const size_t total(std::accumulate(costs.begin(), costs.end(), size_t(0)));
+  Search search(costs, num_procs, limit,
+                std::max(costs.front(), (total + num_procs - 1) / num_procs));
+  search.search(0);
+  if(search.best_assignment.empty())
+    {
+      return;
+    }
+
+  std::vector<std::vector<Block_Map>> result(mapping.size());
+  for(size_t proc = 0; proc < num_procs; ++proc)
+    {
+      result[proc / procs_per_node].emplace_back();
+      result[proc / procs_per_node].back().num_procs = 1;
+    }
+  for(size_t block = 0; block < costs.size(); ++block)
+    {
+      const size_t proc(search.best_assignment[block]);
+      Block_Map &block_map(result[proc / procs_per_node]
+                                 [proc % procs_per_node]);
+      block_map.cost += costs[block];
+      block_map.block_indices.push_back(sorted_costs[block].index);
+    }
+  std::swap(mapping, result);
+}
@@ -0,0 +1,363 @@
+#include "../../../../compute_block_grid_mapping.hxx"
+
+#include <algorithm>
+#include <numeric>
+
+// Repair a mapping, from compute_block_grid_mapping, so that no node
+// needs more than max_memory.  Each step takes the node that needs
+// the most memory, and if it is over the limit, tries, in order:
+//
+// 1) Swapping some of its groups with groups on another node that use
+//    the same number of procs, but less memory.  Either one group for
+//    one group, one multi-proc group for the same number of single
+//    proc groups with the least memory, or the reverse.  This leaves
+//    every group with the same blocks and procs, so the predicted
+//    times do not change.  The swap that saves the most memory is
+//    taken.
+//
+// 2) Moving one block from one of its single proc groups to a single
+//    proc group on another node.  Of all such moves, the one that
+//    leaves the receiving group fastest is taken.
+//
+// 3) If no other node has a single proc group with room for one of
+//    those blocks, splitting a proc off of the largest group on the
+//    node with the most room, to make an empty single proc group.
+//    The block that was in the larger group gets slower, but this is
+//    only done when nothing else fits.
+//
+// Steps 1 and 2 are only taken if the other node stays within
+// max_memory, and they always reduce the memory of the node that is
+// over, so the total excess goes down.  Step 3 can only be taken
+// until every group has a single proc.  The node boundaries and the
+// number of procs on each node never change.
+
+namespace
+{
+  size_t memory_of(const Block_Map &block_map,
+                   const std::vector<size_t> &block_memory,
+                   const size_t &group_memory, const size_t &proc_memory)
+  {
+    size_t result(group_memory + proc_memory * block_map.num_procs);
+    for(auto &block : block_map.block_indices)
+      {
+        result += block_memory[block];
+      }
+    return result;
+  }
+
+  // Groups on two nodes that trade places
+  struct Swap
+  {
+    size_t node = 0, other_node = 0, saved = 0;
+    std::vector<size_t> groups, other_groups;
+  };
+
+  // The single proc groups on a node, with the least memory first
+  std::vector<size_t>
+  single_proc_groups(const std::vector<Block_Map> &groups,
+                     const std::vector<size_t> &memory)
+  {
+    std::vector<size_t> result;
+    for(size_t group = 0; group < groups.size(); ++group)
+      {
+        if(groups[group].num_procs == 1)
+          {
+            result.push_back(group);
+          }
+      }
+    std::stable_sort(result.begin(), result.end(),
+                     [&](const size_t &a, const size_t &b) {
+                       return memory[a] < memory[b];
+                     });
+    return result;
+  }
+
+  // Consider trading groups on node for other_groups on other_node,
+  // where the memory of each group is in memory and other_memory.
+  void
+  consider_swap(const size_t &node, const std::vector<size_t> &groups,
+                const std::vector<size_t> &memory, const size_t &other_node,
+                const std::vector<size_t> &other_groups,
+                const std::vector<size_t> &other_memory,
+                const std::vector<size_t> &node_memory,
+                const size_t &max_memory, Swap &best)
+  {
+    size_t outgoing(0), incoming(0);
+    for(auto &group : groups)
+      {
+        outgoing += memory[group];
+      }
+    for(auto &group : other_groups)
+      {
+        incoming += other_memory[group];
+      }
+    if(incoming < outgoing
+       && node_memory[other_node] - incoming + outgoing <= max_memory
+       && outgoing - incoming > best.saved)
+      {
+        best.node = node;
+        best.other_node = other_node;
+        best.saved = outgoing - incoming;
+        best.groups = groups;
+        best.other_groups = other_groups;
+      }
+  }
+
+  // Remove the given groups from a node, and return them.
+  std::vector<Block_Map> take_groups(std::vector<size_t> indices,
+                                     std::vector<Block_Map> &groups)
+  {
+    std::vector<Block_Map> result;
+    std::sort(indices.rbegin(), indices.rend());
+    for(auto &index : indices)
+      {
+        result.push_back(groups[index]);
+        groups.erase(groups.begin() + index);
+      }
+    return result;
+  }
+
+  bool swap_groups(const std::vector<size_t> &block_memory,
+                   const size_t &group_memory, const size_t &proc_memory,
+                   const size_t &max_memory, const size_t &node,
+                   const std::vector<size_t> &node_memory,
+                   std::vector<std::vector<Block_Map>> &mapping)
+  {
+    std::vector<std::vector<size_t>> memory(mapping.size());
+    for(size_t other = 0; other < mapping.size(); ++other)
+      for(auto &block_map : mapping[other])
+        {
+          memory[other].push_back(
+            memory_of(block_map, block_memory, group_memory, proc_memory));
+        }
+
+    const std::vector<size_t> singles(
+      single_proc_groups(mapping[node], memory[node]));
+    Swap best;
+    for(size_t other = 0; other < mapping.size(); ++other)
+      {
+        if(other == node)
+          {
+            continue;
+          }
+        const std::vector<size_t> other_singles(
+          single_proc_groups(mapping[other], memory[other]));
+        for(size_t group = 0; group < mapping[node].size(); ++group)
+          {
+            const size_t num_procs(mapping[node][group].num_procs);
+            for(size_t other_group = 0; other_group < mapping[other].size();
+                ++other_group)
+              {
+                if(mapping[other][other_group].num_procs == num_procs)
+                  {
+                    consider_swap(node, {group}, memory[node], other,
+                                  {other_group}, memory[other], node_memory,
+                                  max_memory, best);
+                  }
+              }
+            if(num_procs > 1 && other_singles.size() >= num_procs)
+              {
+                consider_swap(node, {group}, memory[node], other,
+                              std::vector<size_t>(other_singles.begin(),
+                                                  other_singles.begin()
+                                                    + num_procs),
+                              memory[other], node_memory, max_memory, best);
+              }
+          }
+        for(size_t other_group = 0; other_group < mapping[other].size();
+            ++other_group)
+          {
+            const size_t num_procs(mapping[other][other_group].num_procs);
+            if(num_procs > 1 && singles.size() >= num_procs)
+              {
+                consider_swap(node,
+                              std::vector<size_t>(singles.end() - num_procs,
+                                                  singles.end()),
+                              memory[node], other, {other_group},
+                              memory[other], node_memory, max_memory, best);
+              }
+          }
+      }
+    if(best.saved == 0)
+      {
+        return false;
+      }
+    std::vector<Block_Map> outgoing(
+      take_groups(best.groups, mapping[best.node])),
+      incoming(take_groups(best.other_groups, mapping[best.other_node]));
+    mapping[best.other_node].insert(mapping[best.other_node].end(),
+                                    outgoing.begin(), outgoing.end());
+    mapping[best.node].insert(mapping[best.node].end(), incoming.begin(),
+                              incoming.end());
+    return true;
+  }
+
+  bool move_block(const std::vector<size_t> &costs,
+                  const std::vector<size_t> &block_memory,
+                  const size_t &max_memory, const size_t &node,
+                  const std::vector<size_t> &node_memory,
+                  std::vector<std::vector<Block_Map>> &mapping)
+  {
+    bool is_found(false);
+    size_t best_group(0), best_block(0), best_node(0), best_target(0),
+      best_time(0);
+    for(size_t group = 0; group < mapping[node].size(); ++group)
+      {
+        const Block_Map &source(mapping[node][group]);
+        if(source.num_procs != 1)
+          {
+            continue;
+          }
+        for(auto &block : source.block_indices)
+          for(size_t other = 0; other < mapping.size(); ++other)
+            {
+              if(other == node
+                 || node_memory[other] + block_memory[block] > max_memory)
+                {
+                  continue;
+                }
+              for(size_t target = 0; target < mapping[other].size();
+                  ++target)
+                {
+                  const Block_Map &block_map(mapping[other][target]);
+                  const size_t time(block_map.cost + costs[block]);
+                  if(block_map.num_procs == 1
+                     && (!is_found || time < best_time
+                         || (time == best_time
+                             && block_memory[block]
+                                  > block_memory[best_block])))
+                    {
+                      is_found = true;
+                      best_group = group;
+                      best_block = block;
+                      best_node = other;
+                      best_target = target;
+                      best_time = time;
+                    }
+                }
+            }
+      }
+    if(is_found)
+      {
+        Block_Map &source(mapping[node][best_group]),
+          &target(mapping[best_node][best_target]);
+        source.block_indices.erase(std::find(source.block_indices.begin(),
+                                             source.block_indices.end(),
+                                             best_block));
+        source.cost -= costs[best_block];
+        target.block_indices.push_back(best_block);
+        target.cost += costs[best_block];
+      }
+    return is_found;
+  }
+
+  bool split_group(const std::vector<size_t> &block_memory,
+                   const size_t &group_memory, const size_t &max_memory,
+                   const size_t &node, const std::vector<size_t> &node_memory,
+                   std::vector<std::vector<Block_Map>> &mapping)
+  {
+    // The smallest block that could move off of node
+    bool has_block(false);
+    size_t smallest_block(0);
+    for(auto &block_map : mapping[node])
+      {
+        if(block_map.num_procs != 1)
+          {
+            continue;
+          }
+        for(auto &block : block_map.block_indices)
+          {
+            if(!has_block || block_memory[block] < smallest_block)
+              {
+                has_block = true;
+                smallest_block = block_memory[block];
+              }
+          }
+      }
+    if(!has_block)
+      {
+        return false;
+      }
+
+    bool is_found(false);
+    size_t best_node(0), best_group(0);
+    for(size_t other = 0; other < mapping.size(); ++other)
+      {
+        if(other == node
+           || node_memory[other] + group_memory + smallest_block
+                > max_memory
+           || (is_found && node_memory[other] >= node_memory[best_node]))
+          {
+            continue;
+          }
+        for(size_t group = 0; group < mapping[other].size(); ++group)
+          {
+            if(mapping[other][group].num_procs > 1
+               && (!is_found || best_node != other
+                   || mapping[other][group].num_procs
+                        > mapping[other][best_group].num_procs))
+              {
+                is_found = true;
+                best_node = other;
+                best_group = group;
+              }
+          }
+      }
+    if(is_found)
+      {
+        --mapping[best_node][best_group].num_procs;
+        mapping[best_node].push_back(Block_Map(1, 0, {}));
+      }
+    return is_found;
+  }
+}
+
+bool fit_block_grid_mapping_memory(
+  const std::vector<Block_Cost> &block_costs,
+  const std::vector<size_t> &block_memory, const size_t &group_memory,
+  const size_t &proc_memory, const size_t &max_memory,
+  std::vector<std::vector<Block_Map>> &mapping)
+{
+  std::vector<size_t> costs;
+  for(auto &block_cost : block_costs)
+    {
+      if(block_cost.index >= costs.size())
+        {
+          costs.resize(block_cost.index + 1, 0);
+        }
+      costs[block_cost.index] = block_cost.cost;
+    }
+
+  // Each step makes progress, but bound the number of steps anyway.
+  size_t num_groups(0);
+  for(auto &groups : mapping)
+    {
+      num_groups += groups.size();
+    }
+  for(size_t step = 0; step < 100 * (num_groups + block_costs.size());
+      ++step)
+    {
+      const std::vector<size_t> node_memory(block_grid_mapping_memory(
+        mapping, block_memory, group_memory, proc_memory));
+      const size_t node(std::distance(
+        node_memory.begin(),
+        std::max_element(node_memory.begin(), node_memory.end())));
+      if(node_memory[node] <= max_memory)
+        {
+          return true;
+        }
+      if(!(swap_groups(block_memory, group_memory, proc_memory, max_memory,
+                       node, node_memory, mapping)
+           || move_block(costs, block_memory, max_memory, node, node_memory,
+                         mapping)
+           || split_group(block_memory, group_memory, max_memory, node,
+                          node_memory, mapping)))
+        {
+          return false;
+        }
+    }
+  const std::vector<size_t> node_memory(block_grid_mapping_memory(
+    mapping, block_memory, group_memory, proc_memory));
+  return *std::max_element(node_memory.begin(), node_memory.end())
+         <= max_memory;
+}
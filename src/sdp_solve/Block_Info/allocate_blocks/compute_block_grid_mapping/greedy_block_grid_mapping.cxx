@@ -43,20 +43,23 @@
 //
 // 2) When large blocks are forced to fit into a node, there is no
 // sharing of procs between the existing block_maps and the new entry.
+//
+// compute_block_grid_mapping uses this as a starting point, and then
+// improves on it.  block_costs must be sorted with the largest first.
 
-#include "../../../Block_Cost.hxx"
-#include "../../../Block_Map.hxx"
+#include "../../../../compute_block_grid_mapping.hxx"
 
 #include <numeric>
 #include <algorithm>
 #include <stdexcept>
+#include <limits>
 
 #include <iostream>
 
 std::vector<std::vector<Block_Map>>
-compute_block_grid_mapping(const size_t &procs_per_node,
-                           const size_t &num_nodes,
-                           const std::vector<Block_Cost> &block_costs)
+greedy_block_grid_mapping(const size_t &procs_per_node,
+                          const size_t &num_nodes,
+                          const std::vector<Block_Cost> &block_costs)
 {
   // We do computations in integers to make sure that the results are
   // the same on different processers.
@@ -0,0 +1,414 @@
+#include "../../../../compute_block_grid_mapping.hxx"
+
+#include <algorithm>
+
+// Local search on a mapping.  Each step takes the slowest group, with
+// the largest cost/num_procs, and tries, in order:
+//
+// 1) If it is a single proc with several blocks, the best move of one
+//    of its blocks to another single proc group, or the best swap with
+//    a smaller block in another single proc group.
+//
+// 2) If it has a single block, or several blocks on several procs,
+//    to take a proc from another group on the same node.  The donor is
+//    either a group with no blocks, a multi-proc group that stays
+//    faster than the slowest group with one fewer proc, or a single
+//    proc group whose blocks can all be moved to other single proc
+//    groups.
+//
+// 3) To pool its blocks and procs with another group on the same node,
+//    and either merge them into one group, or split them again into
+//    two groups with a different division of the procs and blocks.
+//    This lets blocks that are each too large for their own procs
+//    share a larger group, e.g. two blocks of cost 50 on 1 and 2
+//    procs take 50 each way, but 33.3 together on 3 procs.
+//
+// A step is only taken if every group that it changes ends up faster
+// than the slowest group was, so the number of groups at the maximum
+// time goes down, or the maximum itself goes down.  The search stops
+// when no step applies.  Procs never move between nodes, so every
+// node stays fully covered.
+
+namespace
+{
+  // cost_a/procs_a < cost_b/procs_b
+  bool is_faster(const size_t &cost_a, const size_t &procs_a,
+                 const size_t &cost_b, const size_t &procs_b)
+  {
+    return cost_a * procs_b < cost_b * procs_a;
+  }
+
+  bool is_single_proc(const Block_Map &block_map)
+  {
+    return block_map.num_procs == 1;
+  }
+
+  void remove_block(const size_t &block, const size_t &cost,
+                    Block_Map &block_map)
+  {
+    block_map.block_indices.erase(std::find(block_map.block_indices.begin(),
+                                            block_map.block_indices.end(),
+                                            block));
+    block_map.cost -= cost;
+  }
+
+  void add_block(const size_t &block, const size_t &cost,
+                 Block_Map &block_map)
+  {
+    block_map.block_indices.push_back(block);
+    block_map.cost += cost;
+  }
+
+  bool move_blocks(const std::vector<size_t> &costs, const size_t &node,
+                   const size_t &group,
+                   std::vector<std::vector<Block_Map>> &mapping)
+  {
+    Block_Map &slowest(mapping[node][group]);
+    if(!is_single_proc(slowest) || slowest.block_indices.size() < 2)
+      {
+        return false;
+      }
+
+    // The best step so far, and the new time of the slower of the two
+    // groups that it changes.
+    size_t best_time(slowest.cost), best_node(0), best_group(0),
+      best_block(0), best_swap(0);
+    bool is_found(false), is_swap(false);
+    for(size_t target_node = 0; target_node < mapping.size(); ++target_node)
+      for(size_t target_group = 0;
+          target_group < mapping[target_node].size(); ++target_group)
+        {
+          const Block_Map &target(mapping[target_node][target_group]);
+          if(!is_single_proc(target)
+             || (target_node == node && target_group == group))
+            {
+              continue;
+            }
+          for(auto &block : slowest.block_indices)
+            {
+              const size_t time(std::max(slowest.cost - costs[block],
+                                         target.cost + costs[block]));
+              if(time < best_time)
+                {
+                  best_time = time;
+                  best_node = target_node;
+                  best_group = target_group;
+                  best_block = block;
+                  is_found = true;
+                  is_swap = false;
+                }
+              for(auto &swap : target.block_indices)
+                {
+                  if(costs[swap] >= costs[block])
+                    {
+                      continue;
+                    }
+                  const size_t swap_time(std::max(
+                    slowest.cost - costs[block] + costs[swap],
+                    target.cost - costs[swap] + costs[block]));
+                  if(swap_time < best_time)
+                    {
+                      best_time = swap_time;
+                      best_node = target_node;
+                      best_group = target_group;
+                      best_block = block;
+                      best_swap = swap;
+                      is_found = true;
+                      is_swap = true;
+                    }
+                }
+            }
+        }
+    if(is_found)
+      {
+        Block_Map &target(mapping[best_node][best_group]);
+        remove_block(best_block, costs[best_block], slowest);
+        add_block(best_block, costs[best_block], target);
+        if(is_swap)
+          {
+            remove_block(best_swap, costs[best_swap], target);
+            add_block(best_swap, costs[best_swap], slowest);
+          }
+      }
+    return is_found;
+  }
+
+  // Try to move all of the blocks of donor to other single proc
+  // groups, largest first, each to the least loaded one, so that
+  // every group that receives a block stays faster than slowest.
+  // Returns false, leaving mapping unchanged, if that is not
+  // possible.
+  bool evacuate(const std::vector<size_t> &costs, const Block_Map &slowest,
+                const size_t &donor_node, const size_t &donor_group,
+                std::vector<std::vector<Block_Map>> &mapping)
+  {
+    const Block_Map &donor(mapping[donor_node][donor_group]);
+    std::vector<size_t> blocks(donor.block_indices);
+    std::sort(blocks.begin(), blocks.end(),
+              [&](const size_t &a, const size_t &b) {
+                return costs[a] > costs[b]
+                       || (costs[a] == costs[b] && a < b);
+              });
+
+    // Tentative loads of the single proc groups that can receive
+    // blocks
+    struct Target
+    {
+      size_t node, group, cost;
+      std::vector<size_t> blocks;
+    };
+    std::vector<Target> targets;
+    for(size_t node = 0; node < mapping.size(); ++node)
+      for(size_t group = 0; group < mapping[node].size(); ++group)
+        {
+          const Block_Map &block_map(mapping[node][group]);
+          if(is_single_proc(block_map) && &block_map != &slowest
+             && !(node == donor_node && group == donor_group))
+            {
+              targets.push_back({node, group, block_map.cost, {}});
+            }
+        }
+    if(targets.empty())
+      {
+        return false;
+      }
+    for(auto &block : blocks)
+      {
+        Target &target(*std::min_element(
+          targets.begin(), targets.end(),
+          [](const Target &a, const Target &b) { return a.cost < b.cost; }));
+        target.cost += costs[block];
+        if(!is_faster(target.cost, 1, slowest.cost, slowest.num_procs))
+          {
+            return false;
+          }
+        target.blocks.push_back(block);
+      }
+    for(auto &target : targets)
+      for(auto &block : target.blocks)
+        {
+          add_block(block, costs[block],
+                    mapping[target.node][target.group]);
+        }
+    Block_Map &emptied(mapping[donor_node][donor_group]);
+    emptied.block_indices.clear();
+    emptied.cost = 0;
+    return true;
+  }
+
+  bool add_proc(const std::vector<size_t> &costs, const size_t &node,
+                const size_t &group,
+                std::vector<std::vector<Block_Map>> &mapping)
+  {
+    std::vector<Block_Map> &groups(mapping[node]);
+    if(groups[group].block_indices.empty()
+       || (is_single_proc(groups[group])
+           && groups[group].block_indices.size() > 1))
+      {
+        return false;
+      }
+    const Block_Map &slowest(groups[group]);
+
+    // Prefer a donor with no blocks, then the multi-proc donor that
+    // is fastest after giving up a proc, and finally a single proc
+    // donor whose blocks can go elsewhere.
+    size_t donor(groups.size());
+    for(size_t candidate = 0; candidate < groups.size(); ++candidate)
+      {
+        if(candidate != group && groups[candidate].block_indices.empty())
+          {
+            donor = candidate;
+            break;
+          }
+      }
+    if(donor == groups.size())
+      {
+        for(size_t candidate = 0; candidate < groups.size(); ++candidate)
+          {
+            const Block_Map &block_map(groups[candidate]);
+            if(candidate == group || block_map.num_procs < 2
+               || !is_faster(block_map.cost, block_map.num_procs - 1,
+                             slowest.cost, slowest.num_procs))
+              {
+                continue;
+              }
+            if(donor == groups.size()
+               || is_faster(block_map.cost, block_map.num_procs - 1,
+                            groups[donor].cost, groups[donor].num_procs - 1))
+              {
+                donor = candidate;
+              }
+          }
+      }
+    if(donor == groups.size())
+      {
+        for(size_t candidate = 0; candidate < groups.size(); ++candidate)
+          {
+            if(candidate != group && is_single_proc(groups[candidate])
+               && evacuate(costs, slowest, node, candidate, mapping))
+              {
+                donor = candidate;
+                break;
+              }
+          }
+      }
+    if(donor == groups.size())
+      {
+        return false;
+      }
+
+    ++groups[group].num_procs;
+    --groups[donor].num_procs;
+    if(groups[donor].num_procs == 0)
+      {
+        groups.erase(groups.begin() + donor);
+      }
+    return true;
+  }
+
+  // Split blocks between a group with procs_a procs and one with
+  // procs_b, largest first, each to the group where it finishes
+  // sooner.  procs_b may be 0, in which case everything goes to a.
+  void split_blocks(const std::vector<size_t> &costs,
+                    const std::vector<size_t> &blocks, const size_t &procs_a,
+                    const size_t &procs_b, Block_Map &a, Block_Map &b)
+  {
+    a.clear();
+    b.clear();
+    a.num_procs = procs_a;
+    b.num_procs = procs_b;
+    for(auto &block : blocks)
+      {
+        if(procs_b == 0
+           || !is_faster(b.cost + costs[block], procs_b, a.cost + costs[block],
+                         procs_a))
+          {
+            add_block(block, costs[block], a);
+          }
+        else
+          {
+            add_block(block, costs[block], b);
+          }
+      }
+  }
+
+  // The slower of a and b, as a fraction cost/procs.  An empty
+  // group takes no time.
+  void slower(const Block_Map &a, const Block_Map &b, size_t &cost,
+              size_t &procs)
+  {
+    cost = a.cost;
+    procs = a.num_procs;
+    if(b.num_procs != 0 && is_faster(cost, procs, b.cost, b.num_procs))
+      {
+        cost = b.cost;
+        procs = b.num_procs;
+      }
+  }
+
+  bool regroup(const std::vector<size_t> &costs, const size_t &node,
+               const size_t &group,
+               std::vector<std::vector<Block_Map>> &mapping)
+  {
+    std::vector<Block_Map> &groups(mapping[node]);
+    const Block_Map &slowest(groups[group]);
+
+    // The best regrouping so far, and the time of its slower group
+    size_t best_cost(slowest.cost), best_procs(slowest.num_procs),
+      best_other(groups.size());
+    Block_Map best_a, best_b;
+    for(size_t other = 0; other < groups.size(); ++other)
+      {
+        if(other == group)
+          {
+            continue;
+          }
+        std::vector<size_t> blocks(slowest.block_indices);
+        blocks.insert(blocks.end(), groups[other].block_indices.begin(),
+                      groups[other].block_indices.end());
+        std::sort(blocks.begin(), blocks.end(),
+                  [&](const size_t &a, const size_t &b) {
+                    return costs[a] > costs[b]
+                           || (costs[a] == costs[b] && a < b);
+                  });
+        const size_t total_procs(slowest.num_procs
+                                 + groups[other].num_procs);
+        // procs_b == 0 merges the two groups.
+        for(size_t procs_b = 0; procs_b < total_procs; ++procs_b)
+          {
+            Block_Map a, b;
+            split_blocks(costs, blocks, total_procs - procs_b, procs_b, a,
+                         b);
+            size_t cost, procs;
+            slower(a, b, cost, procs);
+            if(is_faster(cost, procs, best_cost, best_procs))
+              {
+                best_cost = cost;
+                best_procs = procs;
+                best_other = other;
+                best_a = a;
+                best_b = b;
+              }
+          }
+      }
+    if(best_other == groups.size())
+      {
+        return false;
+      }
+    groups[group] = best_a;
+    if(best_b.num_procs == 0)
+      {
+        groups.erase(groups.begin() + best_other);
+      }
+    else
+      {
+        groups[best_other] = best_b;
+      }
+    return true;
+  }
+}
+
+void refine_block_grid_mapping(const std::vector<Block_Cost> &block_costs,
+                               std::vector<std::vector<Block_Map>> &mapping)
+{
+  std::vector<size_t> costs;
+  for(auto &block_cost : block_costs)
+    {
+      if(block_cost.index >= costs.size())
+        {
+          costs.resize(block_cost.index + 1, 0);
+        }
+      costs[block_cost.index] = block_cost.cost;
+    }
+
+  // Each step makes progress, but bound the number of steps anyway.
+  size_t num_groups(0);
+  for(auto &groups : mapping)
+    {
+      num_groups += groups.size();
+    }
+  for(size_t step = 0; step < 100 * (num_groups + block_costs.size());
+      ++step)
+    {
+      size_t node(mapping.size()), group(0);
+      for(size_t candidate_node = 0; candidate_node < mapping.size();
+          ++candidate_node)
+        for(size_t candidate = 0; candidate < mapping[candidate_node].size();
+            ++candidate)
+          {
+            if(node == mapping.size()
+               || mapping[node][group] < mapping[candidate_node][candidate])
+              {
+                node = candidate_node;
+                group = candidate;
+              }
+          }
+      if(node == mapping.size() || mapping[node][group].cost == 0
+         || !(move_blocks(costs, node, group, mapping)
+              || add_proc(costs, node, group, mapping)
+              || regroup(costs, node, group, mapping)))
+        {
+          break;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#include <El.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
+// Measure how long a single BigFloat multiply-add takes at the
+// current precision, in seconds, inside El::Gemm and inside
+// El::Cholesky.  Only rank 0 does the timing, which takes a fraction
+// of a second, and then broadcasts the results, so that every rank
+// computes exactly the same block costs.  The best of a few
+// repetitions is used, to reduce the noise from the other processes
+// that are starting up at the same time.
+
+void calibrate_cost_model(double &gemm_seconds, double &cholesky_seconds)
+{
+  std::array<double, 2> seconds;
+  if(El::mpi::Rank() == 0)
+    {
+      using Clock = std::chrono::high_resolution_clock;
+      const int64_t gemm_size(64), cholesky_size(96), repetitions(3);
+
+      El::Matrix<El::BigFloat> A(gemm_size, gemm_size),
+        B(gemm_size, gemm_size), C(gemm_size, gemm_size);
+      for(int64_t column = 0; column < gemm_size; ++column)
+        for(int64_t row = 0; row < gemm_size; ++row)
+          {
+            A(row, column) = El::BigFloat(1.0 / (row + column + 1));
+            B(row, column) = El::BigFloat(1.0 / (row + column + 2));
+          }
+
+      // Hilbert matrix plus a multiple of the identity, so that it is
+      // safely positive definite.
+      El::Matrix<El::BigFloat> S(cholesky_size, cholesky_size),
+        L(cholesky_size, cholesky_size);
+      for(int64_t column = 0; column < cholesky_size; ++column)
+        for(int64_t row = 0; row < cholesky_size; ++row)
+          {
+            S(row, column) = El::BigFloat(
+              1.0 / (row + column + 1) + (row == column ? cholesky_size : 0));
+          }
+
+      std::array<Clock::duration, 2> best{
+        {Clock::duration::max(), Clock::duration::max()}};
+      for(int64_t repetition = 0; repetition < repetitions; ++repetition)
+        {
+          auto start(Clock::now());
+          El::Gemm(El::Orientation::NORMAL, El::Orientation::NORMAL,
+                   El::BigFloat(1), A, B, El::BigFloat(0), C);
+          best[0] = std::min(best[0], Clock::now() - start);
+
+          L = S;
+          start = Clock::now();
+          El::Cholesky(El::UpperOrLowerNS::LOWER, L);
+          best[1] = std::min(best[1], Clock::now() - start);
+        }
+      const double gemm_count(double(gemm_size) * gemm_size * gemm_size),
+        cholesky_count(double(cholesky_size) * cholesky_size * cholesky_size
+                       / 6);
+      seconds[0]
+        = std::chrono::duration<double>(best[0]).count() / gemm_count;
+      seconds[1]
+        = std::chrono::duration<double>(best[1]).count() / cholesky_count;
+    }
+  El::mpi::Broadcast(seconds.data(), 2, 0, El::mpi::COMM_WORLD);
+  gemm_seconds = seconds[0];
+  cholesky_seconds = seconds[1];
+}
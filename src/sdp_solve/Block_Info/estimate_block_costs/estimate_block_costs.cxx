@@ -0,0 +1,65 @@
+#include "../../Block_Info.hxx"
+
+#include <cmath>
+
+// Estimate the cost of each block from the number of BigFloat
+// multiply-adds in one iteration, instead of measuring it with a
+// timing run.  For block j, with s = schur_block_sizes[j], N the
+// length of the dual objective b, and, for each of its two parity
+// blocks b, p_b = psd_matrix_block_sizes[b] and q_b =
+// bilinear_pairing_block_sizes[b], the work is
+//
+//   Cholesky decomposition of the Schur complement block:   s^3/6
+//   L^{-1} B, with the free variable matrix B:               s^2 N/2
+//   contribution to Q, (L^{-1} B)^T (L^{-1} B):              s N^2/2
+//   Schur complement from the bilinear pairings:             4 s^2
+//   bilinear pairings of X^{-1} and Y:              3/2 p_b^2 q_b + p_b q_b^2
+//   search direction and step length, from the products
+//   and solves with X, Y, dX and dY:                         4 p_b^3
+//   Cholesky decompositions of X and Y:                      p_b^3/3
+//
+// The first three are what the timing run measures.  The Cholesky
+// decompositions are weighted by the time per multiply-add in
+// El::Cholesky and everything else by the time in El::Gemm, both
+// measured by calibrate_cost_model.  The result is in microseconds.
+//
+// The costs only matter when there is more than one process, so the
+// calibration is skipped otherwise.
+
+void calibrate_cost_model(double &gemm_seconds, double &cholesky_seconds);
+
+size_t
+read_dual_objective_b_height(const boost::filesystem::path &sdp_directory);
+
+std::vector<Block_Cost>
+Block_Info::estimate_block_costs(const boost::filesystem::path &sdp_directory)
+{
+  const size_t N(read_dual_objective_b_height(sdp_directory));
+
+  double gemm_seconds(1e-6), cholesky_seconds(1e-6);
+  if(El::mpi::Size(El::mpi::COMM_WORLD) > 1)
+    {
+      calibrate_cost_model(gemm_seconds, cholesky_seconds);
+    }
+
+  std::vector<Block_Cost> result;
+  for(size_t block = 0; block < schur_block_sizes.size(); ++block)
+    {
+      const double s(schur_block_sizes[block]);
+      double gemm_count(s * s * N / 2 + s * N * N / 2 + 4 * s * s),
+        cholesky_count(s * s * s / 6);
+      for(size_t parity = 0; parity < 2; ++parity)
+        {
+          const double p(psd_matrix_block_sizes[2 * block + parity]),
+            q(bilinear_pairing_block_sizes[2 * block + parity]);
+          gemm_count += 1.5 * p * p * q + p * q * q + 4 * p * p * p;
+          cholesky_count += p * p * p / 3;
+        }
+      result.emplace_back(
+        static_cast<size_t>(std::round(
+          (gemm_seconds * gemm_count + cholesky_seconds * cholesky_count)
+          * 1e6)),
+        block);
+    }
+  return result;
+}
@@ -0,0 +1,60 @@
+#include "../Block_Info.hxx"
+
+// Estimate the memory for the matrices that the solver allocates, at
+// the current precision.  For block j, with s = schur_block_sizes[j],
+// m = dimensions[j], N the length of the dual objective b, and, for
+// each of its two parity blocks b, p_b = psd_matrix_block_sizes[b]
+// and q_b = bilinear_pairing_block_sizes[b], the number of elements is
+//
+//   Cholesky decomposition of the Schur complement:          s^2
+//   free variable matrix B and schur_off_diagonal:           2 s N
+//   c, x, dx and the dual residues:                          4 s
+//   y, dy and primal_residue_p, which are copied in every
+//   block:                                                   3 N
+//   X, Y, dX, dY, their Cholesky decompositions, the primal
+//   residues, and the workspaces R, Z and MInvDM:            10 p_b^2
+//   bilinear pairings of X^{-1} and Y:                       2 q_b^2
+//   bilinear pairing workspace:                              p_b q_b
+//   local and distributed copies of the bilinear bases:      2 p_b q_b/m^2
+//
+// Every group of processes also has the upper half of Q_group,
+// N^2/2, and a copy of b.  Q itself, N^2, is spread over all of the
+// processes.
+//
+// Optional matrices, for cacheCholeskyInverse, schurPrecision and
+// initialPrecision, are not counted.  Neither are MPI and Elemental
+// buffers or temporaries.
+
+size_t
+read_dual_objective_b_height(const boost::filesystem::path &sdp_directory);
+
+void Block_Info::estimate_block_memory(
+  const boost::filesystem::path &sdp_directory)
+{
+  const double N(read_dual_objective_b_height(sdp_directory));
+
+  // An El::BigFloat, and the limbs that GMP allocates for it (see
+  // mpf_init2).
+  const double element_bytes(
+    sizeof(El::BigFloat)
+    + sizeof(mp_limb_t)
+        * ((El::gmp::Precision() + 2 * GMP_NUMB_BITS - 1) / GMP_NUMB_BITS
+           + 1));
+
+  block_memory.clear();
+  for(size_t block = 0; block < schur_block_sizes.size(); ++block)
+    {
+      const double s(schur_block_sizes[block]), m(dimensions[block]);
+      double elements(s * s + 2 * s * N + 4 * s + 3 * N);
+      for(size_t parity = 0; parity < 2; ++parity)
+        {
+          const double p(psd_matrix_block_sizes[2 * block + parity]),
+            q(bilinear_pairing_block_sizes[2 * block + parity]);
+          elements += 10 * p * p + 2 * q * q + p * q + 2 * p * q / (m * m);
+        }
+      block_memory.push_back(elements * element_bytes);
+    }
+  group_memory = (N * N / 2 + N) * element_bytes;
+  proc_memory
+    = N * N * element_bytes / El::mpi::Size(El::mpi::COMM_WORLD);
+}
@@ -1,10 +1,23 @@
 #include "../Block_Info.hxx"
+#include "../Cost_Profile.hxx"
 
 #include <boost/filesystem/fstream.hpp>
 
-std::vector<Block_Cost>
-Block_Info::read_block_costs(const boost::filesystem::path &sdp_directory,
-                             const boost::filesystem::path &checkpoint_in)
+// Use the first of
+//
+// 1) block_timings in checkpoint_in, or in sdp_directory if not
+//    restarting from a checkpoint.
+// 2) The Cost_Profile in cost_profile_directory for an SDP with the
+//    same structure.
+// 3) estimate_block_costs.
+
+size_t
+read_dual_objective_b_height(const boost::filesystem::path &sdp_directory);
+
+std::vector<Block_Cost> Block_Info::read_block_costs(
+  const boost::filesystem::path &sdp_directory,
+  const boost::filesystem::path &checkpoint_in,
+  const boost::filesystem::path &cost_profile_directory)
 {
   const boost::filesystem::path sdp_block_timings_path(sdp_directory
                                                        / "block_timings"),
@@ -46,16 +59,50 @@ Block_Info::read_block_costs(const boost::filesystem::path &sdp_directory,
             + std::to_string(result.size()));
         }
     }
-  else
+  else if(!cost_profile_directory.empty())
     {
-      // If no information, assign a cost proportional to the matrix
-      // size.  This should balance out memory use when doing a timing
-      // run.
-      for(size_t block = 0; block < schur_block_sizes.size(); ++block)
+      const Cost_Profile structure(read_dual_objective_b_height(sdp_directory),
+                                   dimensions, degrees);
+      const boost::filesystem::path filename(
+        structure.filename(cost_profile_directory));
+      // Another run may replace the profile at any time, so only rank
+      // 0 reads it, and every rank gets the same costs.  A cost of -1
+      // means that there is no usable profile.
+      std::vector<double> costs(schur_block_sizes.size(), -1);
+      if(El::mpi::Rank() == 0 && exists(filename))
         {
-          result.emplace_back(
-            schur_block_sizes[block] * schur_block_sizes[block], block);
+          try
+            {
+              const Cost_Profile profile(filename);
+              if(profile.is_same_structure(structure))
+                {
+                  for(auto &block_cost : profile.block_costs())
+                    {
+                      costs[block_cost.index] = block_cost.cost;
+                    }
+                }
+            }
+          catch(std::exception &error)
+            {
+              std::cerr << "Ignoring cost profile: " << error.what() << "\n";
+            }
         }
+      El::mpi::Broadcast(costs.data(), costs.size(), 0, El::mpi::COMM_WORLD);
+      if(!costs.empty() && costs.front() >= 0)
+        {
+          cost_profile_filename = filename;
+          for(size_t block = 0; block < costs.size(); ++block)
+            {
+              result.emplace_back(costs[block], block);
+            }
+        }
+    }
+  // If no information, estimate the costs from the sizes of the
+  // blocks.
+  if(result.empty())
+    {
+      result = estimate_block_costs(sdp_directory);
+      estimated_costs = result;
     }
   return result;
 }
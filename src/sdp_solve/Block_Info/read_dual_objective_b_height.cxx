@@ -0,0 +1,20 @@
+#include <boost/filesystem/fstream.hpp>
+
+// The objectives file starts with the constant objective, followed
+// by the length of b, which is also the number of free variables.
+
+size_t
+read_dual_objective_b_height(const boost::filesystem::path &sdp_directory)
+{
+  const boost::filesystem::path objectives_path(sdp_directory / "objectives");
+  boost::filesystem::ifstream objectives_stream(objectives_path);
+  std::string objective_const;
+  size_t N;
+  objectives_stream >> objective_const >> N;
+  if(!objectives_stream.good())
+    {
+      throw std::runtime_error("Could not read the length of b from '"
+                               + objectives_path.string() + "'");
+    }
+  return N;
+}
@@ -9,7 +9,10 @@
 //    ( ... )
 //
 // The blocks are not, in general, square.  This allows us to compute
-// solutions for each block independently.
+// solutions for each block independently.  The limbs of each block
+// are stored contiguously (see BigFloat_Slab.hxx).
+
+#include "BigFloat_Slab.hxx"
 
 #include <El.hpp>
 
@@ -30,16 +33,35 @@ struct Block_Matrix
       {
         if(scale_index)
           {
-            blocks.emplace_back(block_heights.at(2 * block_index), width,
-                                grid);
-            blocks.emplace_back(block_heights.at(2 * block_index + 1), width,
-                                grid);
+            add_block(block_heights.at(2 * block_index), width, grid);
+            add_block(block_heights.at(2 * block_index + 1), width, grid);
           }
         else
           {
-            blocks.emplace_back(block_heights[block_index], width, grid);
+            add_block(block_heights[block_index], width, grid);
           }
       }
   }
   Block_Matrix() = default;
+  Block_Matrix(const Block_Matrix &A)
+  {
+    blocks.reserve(A.blocks.size());
+    for(auto &block : A.blocks)
+      {
+        BigFloat_Slab_Scope slab_scope(block.LocalHeight()
+                                       * block.LocalWidth());
+        blocks.emplace_back(block);
+      }
+  }
+  Block_Matrix(Block_Matrix &&) = default;
+  Block_Matrix &operator=(const Block_Matrix &) = default;
+  Block_Matrix &operator=(Block_Matrix &&) = default;
+
+  void add_block(const size_t &block_height, const size_t &width,
+                 const El::Grid &grid)
+  {
+    BigFloat_Slab_Scope slab_scope(
+      max_local_elements(block_height, width, grid));
+    blocks.emplace_back(block_height, width, grid);
+  }
 };
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Block_Info.hxx"
+#include "SDP.hxx"
+#include "SDP_Solver.hxx"
+
+#include <array>
+#include <map>
+#include <vector>
+
+// The iterates x, X, y and Y of an SDP_Solver, and the blocks of its
+// SDP, held in memory while the blocks move to a new Block_Info with
+// different groups of processes.  A binary checkpoint can only be
+// read back with the mapping that wrote it, and a text checkpoint
+// loses digits, so this replaces writing a checkpoint and restarting.
+// The SDP is not read from sdpDir again.
+//
+// save() gathers the matrices of each block onto the first process
+// of the group that owns it, and serializes them.  restore() sends
+// them to the first process of the new group of the block, which
+// scatters them over that group.  Both are collective over
+// COMM_WORLD, and must use the same precision.
+struct Block_Migration
+{
+  // The serialized matrices of each block, indexed by block index.
+  // Only the first process of the group that owned a block has it.
+  std::map<size_t, std::vector<uint8_t>> blocks;
+  // The heights and widths of the SDP matrices of each block in
+  // 'blocks': primal_objective_c, free_var_matrix, and the two
+  // bilinear bases.  They are serialized in that order, after the
+  // block_matrices.
+  std::map<size_t, std::array<El::Int, 8>> sdp_shapes;
+  bool is_pending = false;
+
+  // The parts of the SDP that every group has, on every process.
+  El::BigFloat objective_const;
+  std::vector<El::BigFloat> dual_objective_b;
+
+  // Copied from the old solver, so that the new one carries on with
+  // the same iteration count and checkpoint generations.
+  size_t num_iterations = 0;
+  El::Matrix<int32_t> block_timings;
+  int64_t current_generation = 0;
+  boost::optional<int64_t> backup_generation;
+
+  void save(const Block_Info &block_info, const SDP &sdp,
+            const SDP_Solver &solver);
+  // Replaces the blocks and bilinear bases of sdp, which only needs
+  // its objectives, e.g. from SDP(objective_const, dual_objective_b,
+  // grid).
+  void restore(const Block_Info &block_info, SDP &sdp, SDP_Solver &solver);
+
+  // The matrices for the block at position 'block' in
+  // Block_Info::block_indices, in the order that they are serialized.
+  template <typename Solver>
+  static auto block_matrices(Solver &solver, const size_t &block)
+  {
+    return std::array<decltype(&solver.x.blocks[block]), 6>{
+      &solver.x.blocks[block],         &solver.X.blocks[2 * block],
+      &solver.X.blocks[2 * block + 1], &solver.y.blocks[block],
+      &solver.Y.blocks[2 * block],     &solver.Y.blocks[2 * block + 1]};
+  }
+};
@@ -0,0 +1,180 @@
+#include "../Block_Migration.hxx"
+#include "../SDP/SDP/assign_bilinear_bases_dist.hxx"
+#include "../check_mpi_error.hxx"
+
+#include <algorithm>
+#include <limits>
+
+// Every process sends the blocks that it saved, and receives the
+// blocks that its new group gets if it is the first process in that
+// group.  The source and destination of each block are found with a
+// single reduction over COMM_WORLD, along with the shapes of the SDP
+// matrices, which the new group needs before it has them.  Each block
+// goes in one message, or several if it is larger than an int can
+// count.  They all use the same tag and are posted in order of block
+// index, which MPI preserves between any pair of processes.
+
+namespace
+{
+  template <typename Post>
+  void post_messages(std::vector<uint8_t> &buffer, const int &peer,
+                     Post post, std::vector<MPI_Request> &requests)
+  {
+    const size_t max_message(std::numeric_limits<int>::max());
+    for(size_t offset = 0; offset < buffer.size(); offset += max_message)
+      {
+        const int count(std::min(max_message, buffer.size() - offset));
+        requests.emplace_back();
+        check_mpi_error(post(buffer.data() + offset, count, MPI_BYTE, peer,
+                             0, El::mpi::COMM_WORLD.comm, &requests.back()));
+      }
+  }
+
+  // Deserialize a matrix on the first process of the group, and
+  // scatter it over the group.
+  void scatter(const uint8_t *&data, const bool &is_root,
+               El::DistMatrix<El::BigFloat, El::CIRC, El::CIRC> &scattered)
+  {
+    if(is_root)
+      {
+        const El::BigFloat zero(0);
+        const size_t serialized_size(zero.SerializedSize());
+        El::Matrix<El::BigFloat> &local(scattered.Matrix());
+        for(int64_t column = 0; column < local.Width(); ++column)
+          for(int64_t row = 0; row < local.Height(); ++row)
+            {
+              local(row, column).Deserialize(data);
+              data += serialized_size;
+            }
+      }
+  }
+}
+
+void Block_Migration::restore(const Block_Info &block_info, SDP &sdp,
+                              SDP_Solver &solver)
+{
+  const int rank(El::mpi::Rank(El::mpi::COMM_WORLD));
+  const size_t num_blocks(block_info.dimensions.size());
+  // ranks[index] is the process that saved the block with that
+  // index, and ranks[num_blocks + index] is the one that receives it.
+  // They start at -1, and are reduced with MAX.  The shapes of the
+  // SDP matrices of that block follow, at shapes_offset + 8 * index,
+  // and start at 0.
+  const size_t shapes_offset(2 * num_blocks);
+  std::vector<El::Int> ranks(shapes_offset + 8 * num_blocks, 0);
+  std::fill(ranks.begin(), ranks.begin() + shapes_offset, -1);
+  for(auto &block : blocks)
+    {
+      ranks[block.first] = rank;
+      auto &shapes(sdp_shapes.at(block.first));
+      std::copy(shapes.begin(), shapes.end(),
+                ranks.begin() + shapes_offset + 8 * block.first);
+    }
+
+  const El::BigFloat zero(0);
+  const size_t serialized_size(zero.SerializedSize());
+  std::vector<bool> is_root(block_info.block_indices.size());
+  std::map<size_t, std::vector<uint8_t>> received;
+  for(size_t block = 0; block < block_info.block_indices.size(); ++block)
+    {
+      El::DistMatrix<El::BigFloat, El::CIRC, El::CIRC> probe(
+        solver.x.blocks[block].Grid());
+      is_root[block] = (probe.CrossRank() == probe.Root());
+      if(is_root[block])
+        {
+          ranks[num_blocks + block_info.block_indices[block]] = rank;
+        }
+    }
+  El::mpi::AllReduce(ranks.data(), ranks.size(), El::mpi::MAX,
+                     El::mpi::COMM_WORLD);
+
+  for(size_t block = 0; block < block_info.block_indices.size(); ++block)
+    {
+      if(is_root[block])
+        {
+          const size_t index(block_info.block_indices[block]);
+          size_t size(0);
+          for(auto matrix : block_matrices(solver, block))
+            {
+              size += serialized_size * matrix->Height() * matrix->Width();
+            }
+          for(size_t shape = 0; shape < 8; shape += 2)
+            {
+              const size_t offset(shapes_offset + 8 * index + shape);
+              size += serialized_size * ranks[offset] * ranks[offset + 1];
+            }
+          received[index].resize(size);
+        }
+    }
+
+  std::vector<MPI_Request> requests;
+  for(auto &block : received)
+    {
+      const int source(ranks[block.first]);
+      if(source == rank)
+        {
+          std::swap(block.second, blocks.at(block.first));
+        }
+      else
+        {
+          post_messages(block.second, source, MPI_Irecv, requests);
+        }
+    }
+  for(auto &block : blocks)
+    {
+      const int destination(ranks[num_blocks + block.first]);
+      if(destination != rank)
+        {
+          post_messages(block.second, destination, MPI_Isend, requests);
+        }
+    }
+  check_mpi_error(
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE));
+  blocks.clear();
+  sdp_shapes.clear();
+
+  const El::Grid &grid(sdp.dual_objective_b.Grid());
+  sdp.primal_objective_c.blocks.clear();
+  sdp.free_var_matrix.blocks.clear();
+  sdp.bilinear_bases_local.clear();
+  for(size_t block = 0; block < block_info.block_indices.size(); ++block)
+    {
+      const size_t index(block_info.block_indices[block]);
+      const uint8_t *data(is_root[block] ? received[index].data() : nullptr);
+      for(auto matrix : block_matrices(solver, block))
+        {
+          El::DistMatrix<El::BigFloat, El::CIRC, El::CIRC> scattered(
+            matrix->Height(), matrix->Width(), grid);
+          scatter(data, is_root[block], scattered);
+          *matrix = scattered;
+        }
+
+      const El::Int *shapes(ranks.data() + shapes_offset + 8 * index);
+      for(auto sdp_blocks :
+          {&sdp.primal_objective_c.blocks, &sdp.free_var_matrix.blocks})
+        {
+          El::DistMatrix<El::BigFloat, El::CIRC, El::CIRC> scattered(
+            shapes[0], shapes[1], grid);
+          scatter(data, is_root[block], scattered);
+          sdp_blocks->emplace_back(grid);
+          sdp_blocks->back() = scattered;
+          shapes += 2;
+        }
+      for(size_t parity = 0; parity < 2; ++parity)
+        {
+          El::DistMatrix<El::BigFloat, El::CIRC, El::CIRC> scattered(
+            shapes[0], shapes[1], grid);
+          scatter(data, is_root[block], scattered);
+          El::DistMatrix<El::BigFloat, El::STAR, El::STAR> replicated(grid);
+          replicated = scattered;
+          sdp.bilinear_bases_local.push_back(replicated.LockedMatrix());
+          shapes += 2;
+        }
+    }
+  assign_bilinear_bases_dist(sdp.bilinear_bases_local, grid,
+                             sdp.bilinear_bases_dist);
+
+  solver.current_generation = current_generation;
+  solver.backup_generation = backup_generation;
+  is_pending = false;
+}
@@ -0,0 +1,89 @@
+#include "../Block_Migration.hxx"
+
+namespace
+{
+  void serialize(const El::Matrix<El::BigFloat> &local,
+                 std::vector<uint8_t> &buffer)
+  {
+    const El::BigFloat zero(0);
+    const size_t serialized_size(zero.SerializedSize());
+    size_t offset(buffer.size());
+    buffer.resize(offset + serialized_size * local.Height() * local.Width());
+    for(int64_t column = 0; column < local.Width(); ++column)
+      for(int64_t row = 0; row < local.Height(); ++row)
+        {
+          local(row, column).Serialize(buffer.data() + offset);
+          offset += serialized_size;
+        }
+  }
+
+  // Returns whether this is the first process of the group, which
+  // gets the whole matrix.
+  bool gather(const El::DistMatrix<El::BigFloat> &matrix,
+              std::vector<uint8_t> &buffer)
+  {
+    El::DistMatrix<El::BigFloat, El::CIRC, El::CIRC> gathered(
+      matrix.Grid());
+    gathered = matrix;
+    const bool is_root(gathered.CrossRank() == gathered.Root());
+    if(is_root)
+      {
+        serialize(gathered.LockedMatrix(), buffer);
+      }
+    return is_root;
+  }
+}
+
+void Block_Migration::save(const Block_Info &block_info, const SDP &sdp,
+                           const SDP_Solver &solver)
+{
+  blocks.clear();
+  sdp_shapes.clear();
+  is_pending = true;
+  num_iterations = solver.num_iterations;
+  block_timings = solver.block_timings;
+  current_generation = solver.current_generation;
+  backup_generation = solver.backup_generation;
+
+  // Every group has all of b, so every process keeps a copy.
+  objective_const = sdp.objective_const;
+  {
+    El::DistMatrix<El::BigFloat, El::STAR, El::STAR> replicated(
+      sdp.dual_objective_b);
+    dual_objective_b.clear();
+    for(int64_t row = 0; row < replicated.LocalHeight(); ++row)
+      {
+        dual_objective_b.push_back(replicated.GetLocal(row, 0));
+      }
+  }
+
+  for(size_t block = 0; block < block_info.block_indices.size(); ++block)
+    {
+      std::vector<uint8_t> buffer;
+      bool is_root(false);
+      for(auto matrix : block_matrices(solver, block))
+        {
+          is_root = gather(*matrix, buffer);
+        }
+      const El::DistMatrix<El::BigFloat> &c(
+        sdp.primal_objective_c.blocks[block]),
+        &B(sdp.free_var_matrix.blocks[block]);
+      gather(c, buffer);
+      gather(B, buffer);
+      if(is_root)
+        {
+          const El::Matrix<El::BigFloat> &bases_0(
+            sdp.bilinear_bases_local[2 * block]),
+            &bases_1(sdp.bilinear_bases_local[2 * block + 1]);
+          serialize(bases_0, buffer);
+          serialize(bases_1, buffer);
+
+          const size_t index(block_info.block_indices[block]);
+          sdp_shapes[index]
+            = {c.Height(),       c.Width(),       B.Height(),
+               B.Width(),        bases_0.Height(), bases_0.Width(),
+               bases_1.Height(), bases_1.Width()};
+          std::swap(blocks[index], buffer);
+        }
+    }
+}
@@ -9,7 +9,10 @@
 //    ( ... )
 //
 // This is equivalent to Block_Matrix with width=1.  We use a separate
-// type to enhance type safety.
+// type to enhance type safety.  The limbs of each block are stored
+// contiguously (see BigFloat_Slab.hxx).
+
+#include "BigFloat_Slab.hxx"
 
 #include <El.hpp>
 
@@ -30,15 +33,38 @@ struct Block_Vector
       {
         if(scale_index)
           {
-            blocks.emplace_back(block_heights.at(2 * block_index), 1, grid);
-            blocks.emplace_back(block_heights.at(2 * block_index + 1), 1,
-                                grid);
+            add_block(block_heights.at(2 * block_index), grid);
+            add_block(block_heights.at(2 * block_index + 1), grid);
           }
         else
           {
-            blocks.emplace_back(block_heights.at(block_index), 1, grid);
+            add_block(block_heights.at(block_index), grid);
           }
       }
   }
   Block_Vector() = default;
+  Block_Vector(const Block_Vector &v)
+  {
+    blocks.reserve(v.blocks.size());
+    for(auto &block : v.blocks)
+      {
+        BigFloat_Slab_Scope slab_scope(block.LocalHeight()
+                                       * block.LocalWidth());
+        blocks.emplace_back(block);
+      }
+  }
+  Block_Vector(Block_Vector &&) = default;
+  Block_Vector &operator=(const Block_Vector &) = default;
+  Block_Vector &operator=(Block_Vector &&) = default;
+
+  void add_block(const size_t &block_height, const El::Grid &grid)
+  {
+    BigFloat_Slab_Scope slab_scope(max_local_elements(block_height, 1, grid));
+    blocks.emplace_back(block_height, 1, grid);
+  }
+
+  // The maximal absolute value of the elements that live on this
+  // rank.  The maximum over all ranks is left to the caller (see
+  // Scalar_Reductions.hxx).
+  El::BigFloat local_max_abs() const;
 };
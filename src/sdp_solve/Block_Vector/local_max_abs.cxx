@@ -0,0 +1,21 @@
+#include "../Block_Vector.hxx"
+
+El::BigFloat Block_Vector::local_max_abs() const
+{
+  El::BigFloat max(0), element;
+  for(auto &block : blocks)
+    {
+      const El::Matrix<El::BigFloat> &local(block.LockedMatrix());
+      for(int64_t column = 0; column < local.Width(); ++column)
+        for(int64_t row = 0; row < local.Height(); ++row)
+          {
+            mpf_abs(element.gmp_float.get_mpf_t(),
+                    local(row, column).gmp_float.get_mpf_t());
+            if(element > max)
+              {
+                max = element;
+              }
+          }
+    }
+  return max;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Block_Diagonal_Matrix.hxx"
+#include "Multiply_Backend.hxx"
+#include "Thread_Pool.hxx"
+
+#include <vector>
+
+// L^{-1} for each block of a Cholesky factor L, computed once per
+// iteration so that the solves with L and L^T in the rest of the
+// iteration become multiplications.  At high precision a
+// multiplication is cheaper than a triangular solve, which has to
+// divide by the diagonal, and with the mpmat backend it becomes a
+// call to an optimized BLAS.
+//
+// An explicit inverse is less stable than a triangular solve, and
+// the error grows with the condition number of L.  So a block is only
+// used if max|L| max|L^{-1}|, which estimates the condition number
+// of L, is below 2^{precision/2}.  That keeps at least half of the
+// bits.  Other blocks fall back to triangular solves.  X becomes
+// more ill-conditioned as the solver converges, so late iterations
+// may use the fallback for many blocks.
+//
+// A default constructed Cholesky_Inverse caches nothing.
+struct Cholesky_Inverse
+{
+  // L^{-1}, with zeros above the diagonal.  Empty if caching is off.
+  std::vector<El::DistMatrix<El::BigFloat>> blocks;
+
+  // Whether blocks[b] holds a usable L^{-1}.  'char' rather than
+  // 'bool' so that the threads can write to different elements at the
+  // same time.
+  std::vector<char> is_cached;
+
+  Cholesky_Inverse() = default;
+  // Allocate space for the inverse of each block of L, if is_enabled.
+  Cholesky_Inverse(const Block_Diagonal_Matrix &L, const bool &is_enabled);
+
+  // Compute L^{-1} for each block of L.  Blocks that live on a single
+  // rank are spread over the threads in thread_pool.
+  void compute(const Block_Diagonal_Matrix &L, Thread_Pool &thread_pool);
+
+  // L^{-1} for a block, or null if the block has to use triangular
+  // solves instead.
+  const El::DistMatrix<El::BigFloat> *block(const size_t &b) const
+  {
+    return b < is_cached.size() && is_cached[b] ? &blocks[b] : nullptr;
+  }
+  const El::Matrix<El::BigFloat> *local_block(const size_t &b) const
+  {
+    return b < is_cached.size() && is_cached[b] ? &blocks[b].LockedMatrix()
+                                                : nullptr;
+  }
+};
+
+// These work the same way for El::Matrix, for blocks that live on a
+// single rank, and for El::DistMatrix.  L_inverse is either L^{-1}
+// from a Cholesky_Inverse, or null to use triangular solves with L.
+
+// L_inverse := L^{-1}.  Returns whether it is accurate enough to use,
+// i.e. whether max|L| max|L^{-1}| < max_condition.  L may hold
+// garbage above the diagonal.
+template <class Matrix>
+bool invert_lower_block(const Matrix &L, const El::BigFloat &max_condition,
+                        Matrix &L_inverse)
+{
+  El::Copy(L, L_inverse);
+  El::MakeTrapezoidal(El::UpperOrLowerNS::LOWER, L_inverse);
+  const El::BigFloat L_max(El::MaxAbs(L_inverse));
+  El::TriangularInverse(El::UpperOrLowerNS::LOWER,
+                        El::UnitOrNonUnit::NON_UNIT, L_inverse);
+  return L_max * El::MaxAbs(L_inverse) < max_condition;
+}
+
+// M := L^{-T} L^{-1} M = A^{-1} M, where A = L L^T.  work has the
+// same size as M, and is overwritten.
+template <class Matrix>
+void cholesky_solve_block(const Matrix &L, const Matrix *L_inverse,
+                          const Multiply_Backend &multiply_backend,
+                          Matrix &work, Matrix &M)
+{
+  if(L_inverse == nullptr)
+    {
+      El::cholesky::SolveAfter(El::UpperOrLowerNS::LOWER,
+                               El::OrientationNS::NORMAL, L, M);
+    }
+  else if(multiply_backend == Multiply_Backend::gmp)
+    {
+      El::Trmm(El::LeftOrRight::LEFT, El::UpperOrLowerNS::LOWER,
+               El::Orientation::NORMAL, El::UnitOrNonUnit::NON_UNIT,
+               El::BigFloat(1), *L_inverse, M);
+      El::Trmm(El::LeftOrRight::LEFT, El::UpperOrLowerNS::LOWER,
+               El::Orientation::TRANSPOSE, El::UnitOrNonUnit::NON_UNIT,
+               El::BigFloat(1), *L_inverse, M);
+    }
+  else
+    {
+      gemm(multiply_backend, El::Orientation::NORMAL, El::Orientation::NORMAL,
+           *L_inverse, M, El::BigFloat(0), work);
+      gemm(multiply_backend, El::Orientation::TRANSPOSE,
+           El::Orientation::NORMAL, *L_inverse, work, El::BigFloat(0), M);
+    }
+}
+
+// A := L^{-1} A L^{-T}
+template <class Matrix>
+void inverse_congruence_block(const Matrix &L, const Matrix *L_inverse,
+                              Matrix &A)
+{
+  if(L_inverse == nullptr)
+    {
+      El::Trsm(El::LeftOrRight::RIGHT, El::UpperOrLowerNS::LOWER,
+               El::Orientation::TRANSPOSE, El::UnitOrNonUnit::NON_UNIT,
+               El::BigFloat(1), L, A);
+      El::Trsm(El::LeftOrRight::LEFT, El::UpperOrLowerNS::LOWER,
+               El::Orientation::NORMAL, El::UnitOrNonUnit::NON_UNIT,
+               El::BigFloat(1), L, A);
+    }
+  else
+    {
+      El::Trmm(El::LeftOrRight::RIGHT, El::UpperOrLowerNS::LOWER,
+               El::Orientation::TRANSPOSE, El::UnitOrNonUnit::NON_UNIT,
+               El::BigFloat(1), *L_inverse, A);
+      El::Trmm(El::LeftOrRight::LEFT, El::UpperOrLowerNS::LOWER,
+               El::Orientation::NORMAL, El::UnitOrNonUnit::NON_UNIT,
+               El::BigFloat(1), *L_inverse, A);
+    }
+}
@@ -0,0 +1,18 @@
+#include "../Cholesky_Inverse.hxx"
+
+Cholesky_Inverse::Cholesky_Inverse(const Block_Diagonal_Matrix &L,
+                                   const bool &is_enabled)
+{
+  if(!is_enabled)
+    {
+      return;
+    }
+  blocks.reserve(L.blocks.size());
+  for(auto &block : L.blocks)
+    {
+      BigFloat_Slab_Scope slab_scope(block.LocalHeight()
+                                     * block.LocalWidth());
+      blocks.emplace_back(block.Height(), block.Width(), block.Grid());
+    }
+  is_cached.resize(L.blocks.size(), 0);
+}
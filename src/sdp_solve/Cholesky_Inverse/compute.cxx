@@ -0,0 +1,30 @@
+#include "../Cholesky_Inverse.hxx"
+
+void Cholesky_Inverse::compute(const Block_Diagonal_Matrix &L,
+                               Thread_Pool &thread_pool)
+{
+  El::BigFloat max_condition(1);
+  mpf_mul_2exp(max_condition.gmp_float.get_mpf_t(),
+               max_condition.gmp_float.get_mpf_t(),
+               mpf_get_default_prec() / 2);
+
+  std::vector<size_t> local_blocks, distributed_blocks;
+  for(size_t block = 0; block < blocks.size(); ++block)
+    {
+      (blocks[block].Grid().Size() == 1 ? local_blocks : distributed_blocks)
+        .push_back(block);
+    }
+
+  thread_pool.parallel_for(
+    local_blocks.size(), [&](const size_t &index, const size_t &) {
+      const size_t block(local_blocks[index]);
+      is_cached[block]
+        = invert_lower_block(L.blocks[block].LockedMatrix(),
+                             max_condition, blocks[block].Matrix());
+    });
+  for(auto &block : distributed_blocks)
+    {
+      is_cached[block]
+        = invert_lower_block(L.blocks[block], max_condition, blocks[block]);
+    }
+}
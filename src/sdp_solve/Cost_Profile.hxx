@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../Block_Cost.hxx"
+
+#include <boost/filesystem.hpp>
+
+#include <string>
+#include <vector>
+
+// The measured cost of each stage of an iteration for each block of
+// an SDP, kept between runs in a directory of profiles.  SDPs with
+// the same structure, N = dual_objective_b_height and the dimension
+// and degree of each block, have the same operation counts, so a
+// profile written by one run can allocate the blocks of another.
+//
+// costs[block][stage] is the time for one iteration, summed over the
+// processes of the group that owned the block, divided by the time
+// for one BigFloat multiply-add in El::Gemm at the working precision
+// (see calibrate_cost_model).  That makes profiles from runs at
+// different precisions, or on different machines, comparable.
+struct Cost_Profile
+{
+  size_t dual_objective_b_height = 0;
+  std::vector<size_t> dimensions, degrees;
+
+  std::vector<std::string> stages;
+  std::vector<std::vector<double>> costs;
+  // The number of runs that were averaged into costs
+  size_t num_samples = 0;
+
+  Cost_Profile(const size_t &Dual_objective_b_height,
+               const std::vector<size_t> &Dimensions,
+               const std::vector<size_t> &Degrees)
+      : dual_objective_b_height(Dual_objective_b_height),
+        dimensions(Dimensions), degrees(Degrees)
+  {}
+  explicit Cost_Profile(const boost::filesystem::path &filename);
+
+  bool is_same_structure(const Cost_Profile &profile) const
+  {
+    return dual_objective_b_height == profile.dual_objective_b_height
+           && dimensions == profile.dimensions && degrees == profile.degrees;
+  }
+  // The file for this structure in directory.  The name is a hash of
+  // the structure, so check is_same_structure() after reading it.
+  boost::filesystem::path
+  filename(const boost::filesystem::path &directory) const;
+  void add_sample(const Cost_Profile &sample);
+  std::vector<Block_Cost> block_costs() const;
+  void write(const boost::filesystem::path &filename) const;
+};
+
+// The stages of an iteration that go into a profile, by their names
+// in Timers::block_total.
+inline const std::vector<std::string> &cost_profile_stages()
+{
+  static const std::vector<std::string> result(
+    {"cholesky", "solve", "syrk", "schur_complement", "bilinear_pairings",
+     "step_length", "dual_residues"});
+  return result;
+}
@@ -0,0 +1,46 @@
+#include "../Cost_Profile.hxx"
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <sstream>
+
+// Read a profile written by Cost_Profile::write().
+
+Cost_Profile::Cost_Profile(const boost::filesystem::path &filename)
+{
+  boost::filesystem::ifstream input(filename);
+  std::string keyword, line;
+  size_t version(0), num_blocks(0);
+  input >> keyword >> version;
+  if(keyword != "cost_profile" || version != 1)
+    {
+      throw std::runtime_error("Unknown format in cost profile: "
+                               + filename.string());
+    }
+  input >> keyword >> dual_objective_b_height >> keyword >> num_blocks
+    >> keyword >> num_samples >> keyword;
+  std::getline(input, line);
+  std::stringstream stage_names(line);
+  std::string stage;
+  while(stage_names >> stage)
+    {
+      stages.push_back(stage);
+    }
+
+  dimensions.resize(num_blocks);
+  degrees.resize(num_blocks);
+  costs.resize(num_blocks, std::vector<double>(stages.size()));
+  for(size_t block = 0; block < num_blocks; ++block)
+    {
+      input >> dimensions[block] >> degrees[block];
+      for(auto &cost : costs[block])
+        {
+          input >> cost;
+        }
+    }
+  if(!input.good())
+    {
+      throw std::runtime_error("Error when reading cost profile: "
+                               + filename.string());
+    }
+}
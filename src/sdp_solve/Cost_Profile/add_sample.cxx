@@ -0,0 +1,45 @@
+#include "../Cost_Profile.hxx"
+
+#include <algorithm>
+
+// Average the costs in sample, from a single run, into this profile.
+// The weight of the new run is 1/(num_samples + 1), but at least 1/10,
+// so that the profile follows slow changes, such as a new machine,
+// instead of freezing after many runs.  Stages that only one of them
+// has are added with the cost from the one that has it.
+
+void Cost_Profile::add_sample(const Cost_Profile &sample)
+{
+  if(num_samples == 0 || !is_same_structure(sample))
+    {
+      *this = sample;
+      num_samples = 1;
+      return;
+    }
+  const double weight(1.0 / (std::min(num_samples, size_t(9)) + 1));
+  for(size_t sample_stage = 0; sample_stage < sample.stages.size();
+      ++sample_stage)
+    {
+      const size_t stage(std::distance(
+        stages.begin(), std::find(stages.begin(), stages.end(),
+                                  sample.stages[sample_stage])));
+      if(stage == stages.size())
+        {
+          stages.push_back(sample.stages[sample_stage]);
+          for(size_t block = 0; block < costs.size(); ++block)
+            {
+              costs[block].push_back(sample.costs[block][sample_stage]);
+            }
+        }
+      else
+        {
+          for(size_t block = 0; block < costs.size(); ++block)
+            {
+              costs[block][stage]
+                += weight
+                   * (sample.costs[block][sample_stage] - costs[block][stage]);
+            }
+        }
+    }
+  ++num_samples;
+}
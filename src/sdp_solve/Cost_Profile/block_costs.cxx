@@ -0,0 +1,20 @@
+#include "../Cost_Profile.hxx"
+
+#include <cmath>
+
+// The cost of each block is the sum over all of the stages.
+
+std::vector<Block_Cost> Cost_Profile::block_costs() const
+{
+  std::vector<Block_Cost> result;
+  for(size_t block = 0; block < costs.size(); ++block)
+    {
+      double cost(0);
+      for(auto &stage_cost : costs[block])
+        {
+          cost += stage_cost;
+        }
+      result.emplace_back(static_cast<size_t>(std::round(cost)), block);
+    }
+  return result;
+}
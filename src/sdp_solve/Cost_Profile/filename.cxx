@@ -0,0 +1,37 @@
+#include "../Cost_Profile.hxx"
+
+#include <iomanip>
+#include <sstream>
+
+// A 64 bit FNV-1a hash of the structure.  std::hash is not used
+// because it can change between compilers, and the profiles are
+// shared between builds.
+
+namespace
+{
+  void hash_value(const size_t &value, uint64_t &hash)
+  {
+    for(size_t byte = 0; byte < 8; ++byte)
+      {
+        hash ^= (static_cast<uint64_t>(value) >> (8 * byte)) & 0xff;
+        hash *= 1099511628211ull;
+      }
+  }
+}
+
+boost::filesystem::path
+Cost_Profile::filename(const boost::filesystem::path &directory) const
+{
+  uint64_t hash(14695981039346656037ull);
+  hash_value(dual_objective_b_height, hash);
+  hash_value(dimensions.size(), hash);
+  for(size_t block = 0; block < dimensions.size(); ++block)
+    {
+      hash_value(dimensions[block], hash);
+      hash_value(degrees[block], hash);
+    }
+  std::stringstream name;
+  name << "cost_profile." << std::hex << std::setw(16) << std::setfill('0')
+       << hash;
+  return directory / name.str();
+}
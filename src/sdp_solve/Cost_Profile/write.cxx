@@ -0,0 +1,44 @@
+#include "../Cost_Profile.hxx"
+
+#include <boost/filesystem/fstream.hpp>
+
+// The header gives the structure and the stage names, followed by a
+// line for each block with its dimension, degree, and the cost of each
+// stage.  The file is written under a temporary name and then renamed,
+// so that runs that read it at the same time never see it half
+// written.
+
+void Cost_Profile::write(const boost::filesystem::path &filename) const
+{
+  const boost::filesystem::path temporary(boost::filesystem::unique_path(
+    filename.string() + ".%%%%-%%%%-%%%%"));
+  {
+    boost::filesystem::ofstream output(temporary);
+    output.precision(10);
+    output << "cost_profile 1\n"
+           << "N " << dual_objective_b_height << "\n"
+           << "blocks " << dimensions.size() << "\n"
+           << "samples " << num_samples << "\n"
+           << "stages";
+    for(auto &stage : stages)
+      {
+        output << " " << stage;
+      }
+    output << "\n";
+    for(size_t block = 0; block < dimensions.size(); ++block)
+      {
+        output << dimensions[block] << " " << degrees[block];
+        for(auto &cost : costs[block])
+          {
+            output << " " << cost;
+          }
+        output << "\n";
+      }
+    if(!output.good())
+      {
+        throw std::runtime_error("Error when writing to: "
+                                 + temporary.string());
+      }
+  }
+  boost::filesystem::rename(temporary, filename);
+}
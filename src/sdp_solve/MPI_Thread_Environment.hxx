@@ -0,0 +1,44 @@
+#pragma once
+
+// Initialize MPI before El::Environment, so that it can request a
+// thread level.  Elemental only finalizes MPI if it initialized it,
+// so this finalizes it after El::Environment is gone.  Construct it
+// first in main(), before El::Environment.
+//
+// The worker threads of the Thread_Pool never call MPI, but MPI must
+// still know that the process has threads.
+
+#include <mpi.h>
+
+#include <stdexcept>
+
+struct MPI_Thread_Environment
+{
+  int provided = MPI_THREAD_SINGLE;
+  MPI_Thread_Environment(int &argc, char **&argv)
+  {
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+  }
+  ~MPI_Thread_Environment()
+  {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if(!finalized)
+      {
+        MPI_Finalize();
+      }
+  }
+  MPI_Thread_Environment(const MPI_Thread_Environment &) = delete;
+  MPI_Thread_Environment &operator=(const MPI_Thread_Environment &) = delete;
+
+  // Call once the options are parsed.
+  void check_num_threads(const size_t &num_threads) const
+  {
+    if(num_threads > 1 && provided < MPI_THREAD_FUNNELED)
+      {
+        throw std::runtime_error(
+          "numThreads > 1 needs an MPI library that provides at least "
+          "MPI_THREAD_FUNNELED");
+      }
+  }
+};
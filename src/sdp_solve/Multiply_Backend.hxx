@@ -0,0 +1,59 @@
+#pragma once
+
+#include <El.hpp>
+
+#include <ostream>
+#include <string>
+
+// Which implementation to use for the large BigFloat matrix
+// multiplications (the Syrk's and Gemm's in the Schur complement and
+// bilinear pairings).
+//
+// - gmp: Use Elemental's BigFloat routines.
+//
+// - mpmat: Split each element into double precision limbs and
+//   multiply with an optimized BLAS.  This is only used for matrices
+//   that live entirely on a single rank.  Everything else falls back
+//   to gmp.
+//
+// - mpmat_check: Use mpmat, but also compute the gmp result and throw
+//   an exception if they differ by more than the working precision.
+
+enum class Multiply_Backend
+{
+  gmp,
+  mpmat,
+  mpmat_check
+};
+
+Multiply_Backend to_multiply_backend(const std::string &name);
+
+std::ostream &operator<<(std::ostream &os, const Multiply_Backend &backend);
+
+// C := A^T A + beta C   (orientation == TRANSPOSE)
+// C := A A^T + beta C   (orientation == NORMAL)
+//
+// Only the 'uplo' triangle of C is referenced.
+void syrk(const Multiply_Backend &backend, const El::UpperOrLower &uplo,
+          const El::Orientation &orientation,
+          const El::DistMatrix<El::BigFloat> &A, const El::BigFloat &beta,
+          El::DistMatrix<El::BigFloat> &C);
+
+void syrk(const Multiply_Backend &backend, const El::UpperOrLower &uplo,
+          const El::Orientation &orientation,
+          const El::Matrix<El::BigFloat> &A, const El::BigFloat &beta,
+          El::Matrix<El::BigFloat> &C);
+
+// C := op(A) op(B) + beta C
+void gemm(const Multiply_Backend &backend,
+          const El::Orientation &orientation_A,
+          const El::Orientation &orientation_B,
+          const El::DistMatrix<El::BigFloat> &A,
+          const El::DistMatrix<El::BigFloat> &B, const El::BigFloat &beta,
+          El::DistMatrix<El::BigFloat> &C);
+
+void gemm(const Multiply_Backend &backend,
+          const El::Orientation &orientation_A,
+          const El::Orientation &orientation_B,
+          const El::Matrix<El::BigFloat> &A, const El::Matrix<El::BigFloat> &B,
+          const El::BigFloat &beta, El::Matrix<El::BigFloat> &C);
@@ -0,0 +1,43 @@
+#include <El.hpp>
+
+#include <sstream>
+#include <stdexcept>
+
+// Compare the mpmat result with the gmp result.  The error of mpmat
+// is relative to the largest elements, so compare the largest
+// difference with the largest element.
+void check_mpmat(const El::Matrix<El::BigFloat> &gmp_result,
+                 const El::Matrix<El::BigFloat> &mpmat_result,
+                 const bool &is_triangular, const El::UpperOrLower &uplo,
+                 const std::string &name)
+{
+  El::BigFloat max_difference(0), max_element(0);
+  for(int64_t column = 0; column < gmp_result.Width(); ++column)
+    for(int64_t row = 0; row < gmp_result.Height(); ++row)
+      {
+        if(is_triangular
+           && (uplo == El::UpperOrLowerNS::UPPER ? row > column
+                                                 : row < column))
+          {
+            continue;
+          }
+        max_difference
+          = std::max(max_difference, El::Abs(gmp_result(row, column)
+                                             - mpmat_result(row, column)));
+        max_element = std::max(max_element, El::Abs(gmp_result(row, column)));
+      }
+
+  // Allow for some loss of precision in the gmp result itself.
+  El::BigFloat tolerance(1);
+  mpf_div_2exp(tolerance.gmp_float.get_mpf_t(),
+               tolerance.gmp_float.get_mpf_t(),
+               mpf_get_default_prec() - 64);
+  if(max_difference > tolerance * max_element)
+    {
+      std::stringstream ss;
+      ss << "mpmat " << name
+         << " does not agree with gmp.\n\tmax difference: " << max_difference
+         << "\n\tmax element: " << max_element;
+      throw std::runtime_error(ss.str());
+    }
+}
@@ -0,0 +1,54 @@
+#include "../Multiply_Backend.hxx"
+#include "../mpmat.hxx"
+
+void check_mpmat(const El::Matrix<El::BigFloat> &gmp_result,
+                 const El::Matrix<El::BigFloat> &mpmat_result,
+                 const bool &is_triangular, const El::UpperOrLower &uplo,
+                 const std::string &name);
+
+void gemm(const Multiply_Backend &backend,
+          const El::Orientation &orientation_A,
+          const El::Orientation &orientation_B,
+          const El::Matrix<El::BigFloat> &A, const El::Matrix<El::BigFloat> &B,
+          const El::BigFloat &beta, El::Matrix<El::BigFloat> &C)
+{
+  if(backend == Multiply_Backend::gmp)
+    {
+      El::Gemm(orientation_A, orientation_B, El::BigFloat(1), A, B, beta, C);
+      return;
+    }
+
+  El::Matrix<El::BigFloat> gmp_result;
+  if(backend == Multiply_Backend::mpmat_check)
+    {
+      gmp_result = C;
+      El::Gemm(orientation_A, orientation_B, El::BigFloat(1), A, B, beta,
+               gmp_result);
+    }
+
+  mpmat_gemm(orientation_A, orientation_B, A, B, beta, C);
+
+  if(backend == Multiply_Backend::mpmat_check)
+    {
+      check_mpmat(gmp_result, C, false, El::UpperOrLowerNS::LOWER, "gemm");
+    }
+}
+
+void gemm(const Multiply_Backend &backend,
+          const El::Orientation &orientation_A,
+          const El::Orientation &orientation_B,
+          const El::DistMatrix<El::BigFloat> &A,
+          const El::DistMatrix<El::BigFloat> &B, const El::BigFloat &beta,
+          El::DistMatrix<El::BigFloat> &C)
+{
+  // mpmat only works on local matrices.
+  if(backend == Multiply_Backend::gmp || C.Grid().Size() != 1)
+    {
+      El::Gemm(orientation_A, orientation_B, El::BigFloat(1), A, B, beta, C);
+    }
+  else
+    {
+      gemm(backend, orientation_A, orientation_B, A.LockedMatrix(),
+           B.LockedMatrix(), beta, C.Matrix());
+    }
+}
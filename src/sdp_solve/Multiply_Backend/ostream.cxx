@@ -0,0 +1,12 @@
+#include "../Multiply_Backend.hxx"
+
+std::ostream &operator<<(std::ostream &os, const Multiply_Backend &backend)
+{
+  switch(backend)
+    {
+    case Multiply_Backend::gmp: os << "gmp"; break;
+    case Multiply_Backend::mpmat: os << "mpmat"; break;
+    case Multiply_Backend::mpmat_check: os << "mpmat_check"; break;
+    }
+  return os;
+}
@@ -0,0 +1,58 @@
+#include "../Multiply_Backend.hxx"
+#include "../mpmat.hxx"
+
+void check_mpmat(const El::Matrix<El::BigFloat> &gmp_result,
+                 const El::Matrix<El::BigFloat> &mpmat_result,
+                 const bool &is_triangular, const El::UpperOrLower &uplo,
+                 const std::string &name);
+
+void syrk(const Multiply_Backend &backend, const El::UpperOrLower &uplo,
+          const El::Orientation &orientation,
+          const El::Matrix<El::BigFloat> &A, const El::BigFloat &beta,
+          El::Matrix<El::BigFloat> &C)
+{
+  if(backend == Multiply_Backend::gmp)
+    {
+      El::Syrk(uplo, orientation, El::BigFloat(1), A, beta, C);
+      return;
+    }
+
+  // Only copy the relevant triangle, because the other half of C
+  // may have been deallocated (see initialize_Q_group).
+  const bool is_upper(uplo == El::UpperOrLowerNS::UPPER);
+  El::Matrix<El::BigFloat> gmp_result;
+  if(backend == Multiply_Backend::mpmat_check)
+    {
+      El::Zeros(gmp_result, C.Height(), C.Width());
+      for(int64_t column = 0; column < C.Width(); ++column)
+        for(int64_t row = (is_upper ? 0 : column);
+            row < (is_upper ? column + 1 : C.Height()); ++row)
+          {
+            gmp_result(row, column) = C(row, column);
+          }
+      El::Syrk(uplo, orientation, El::BigFloat(1), A, beta, gmp_result);
+    }
+
+  mpmat_syrk(uplo, orientation, A, beta, C);
+
+  if(backend == Multiply_Backend::mpmat_check)
+    {
+      check_mpmat(gmp_result, C, true, uplo, "syrk");
+    }
+}
+
+void syrk(const Multiply_Backend &backend, const El::UpperOrLower &uplo,
+          const El::Orientation &orientation,
+          const El::DistMatrix<El::BigFloat> &A, const El::BigFloat &beta,
+          El::DistMatrix<El::BigFloat> &C)
+{
+  // mpmat only works on local matrices.
+  if(backend == Multiply_Backend::gmp || C.Grid().Size() != 1)
+    {
+      El::Syrk(uplo, orientation, El::BigFloat(1), A, beta, C);
+    }
+  else
+    {
+      syrk(backend, uplo, orientation, A.LockedMatrix(), beta, C.Matrix());
+    }
+}
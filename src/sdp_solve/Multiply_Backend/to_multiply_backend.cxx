@@ -0,0 +1,22 @@
+#include "../Multiply_Backend.hxx"
+
+#include <stdexcept>
+
+Multiply_Backend to_multiply_backend(const std::string &name)
+{
+  if(name == "gmp")
+    {
+      return Multiply_Backend::gmp;
+    }
+  else if(name == "mpmat")
+    {
+      return Multiply_Backend::mpmat;
+    }
+  else if(name == "mpmat_check")
+    {
+      return Multiply_Backend::mpmat_check;
+    }
+  throw std::runtime_error("Invalid argument for multiplyBackend.  Expected "
+                           "one of gmp, mpmat, or mpmat_check, but found: "
+                           + name);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <El.hpp>
+
+// Temporarily change the working precision.  Numbers created inside
+// the scope, including all of Elemental's temporaries, get the new
+// precision, and so do the El::BigFloat's in MPI messages.  Numbers
+// that already exist keep their own precision.  Every rank must
+// enter and leave the scope together.
+//
+// A precision of 0 leaves the working precision unchanged.
+class Precision_Scope
+{
+public:
+  explicit Precision_Scope(const size_t &precision)
+      : previous(El::gmp::Precision()), changed(precision != 0)
+  {
+    if(changed)
+      {
+        El::gmp::SetPrecision(precision);
+      }
+  }
+  ~Precision_Scope()
+  {
+    if(changed)
+      {
+        El::gmp::SetPrecision(previous);
+      }
+  }
+  Precision_Scope(const Precision_Scope &) = delete;
+  Precision_Scope &operator=(const Precision_Scope &) = delete;
+
+private:
+  mp_bitcnt_t previous;
+  bool changed;
+};
+
+// Construct an object with f() while the working precision is
+// precision.  This is for members that have to be allocated at a
+// lower precision in a constructor's initializer list.
+template <class F> auto at_precision(const size_t &precision, const F &f)
+{
+  Precision_Scope scope(precision);
+  return f();
+}
+
+// destination = source, rounded to the precision of the elements of
+// destination.  They must have the same size and distribution.
+// Plain assignment may give destination the precision of source.
+inline void copy_rounded(const El::DistMatrix<El::BigFloat> &source,
+                         El::DistMatrix<El::BigFloat> &destination)
+{
+  const El::Matrix<El::BigFloat> &source_local(source.LockedMatrix());
+  El::Matrix<El::BigFloat> &destination_local(destination.Matrix());
+  for(int64_t column = 0; column < source_local.Width(); ++column)
+    for(int64_t row = 0; row < source_local.Height(); ++row)
+      {
+        mpf_set(destination_local(row, column).gmp_float.get_mpf_t(),
+                source_local(row, column).gmp_float.get_mpf_t());
+      }
+}
@@ -105,4 +105,15 @@ struct SDP
       const std::vector<std::vector<El::BigFloat>> &primal_objective_c_input,
       const std::vector<El::Matrix<El::BigFloat>> &free_var_input,
       const Block_Info &block_info, const El::Grid &grid);
+  // Only the objectives, for Block_Migration::restore() to add the
+  // blocks to.
+  SDP(const El::BigFloat &objective_const,
+      const std::vector<El::BigFloat> &dual_objective_b_input,
+      const El::Grid &grid);
 };
+
+// destination = source, where the elements of destination are first
+// rounded to the working precision (see round_to_precision.hxx).
+// destination must have the same structure as source, e.g. from
+// copying source.
+void copy_rounded(const SDP &source, SDP &destination);
@@ -34,6 +34,14 @@ SDP::SDP(const boost::filesystem::path &sdp_directory,
                        free_var_matrix);
 }
 
+SDP::SDP(const El::BigFloat &objective_const_input,
+         const std::vector<El::BigFloat> &dual_objective_b_input,
+         const El::Grid &grid)
+    : objective_const(objective_const_input)
+{
+  set_dual_objective_b(dual_objective_b_input, grid, dual_objective_b);
+}
+
 SDP::SDP(const El::BigFloat &objective_const_input,
          const std::vector<El::BigFloat> &dual_objective_b_input,
          const std::vector<std::vector<El::BigFloat>> &primal_objective_c_input,
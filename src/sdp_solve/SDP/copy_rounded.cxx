@@ -0,0 +1,48 @@
+#include "../SDP.hxx"
+#include "../round_to_precision.hxx"
+
+namespace
+{
+  void copy_rounded(const El::Matrix<El::BigFloat> &source,
+                    El::Matrix<El::BigFloat> &destination)
+  {
+    round_to_precision(destination);
+    for(int64_t column = 0; column < source.Width(); ++column)
+      for(int64_t row = 0; row < source.Height(); ++row)
+        {
+          mpf_set(destination(row, column).gmp_float.get_mpf_t(),
+                  source(row, column).gmp_float.get_mpf_t());
+        }
+  }
+
+  void copy_rounded(const std::vector<El::DistMatrix<El::BigFloat>> &source,
+                    std::vector<El::DistMatrix<El::BigFloat>> &destination)
+  {
+    for(size_t block = 0; block < source.size(); ++block)
+      {
+        copy_rounded(source[block].LockedMatrix(),
+                     destination[block].Matrix());
+      }
+  }
+}
+
+void copy_rounded(const SDP &source, SDP &destination)
+{
+  for(size_t block = 0; block < source.bilinear_bases_local.size(); ++block)
+    {
+      copy_rounded(source.bilinear_bases_local[block],
+                   destination.bilinear_bases_local[block]);
+    }
+  copy_rounded(source.bilinear_bases_dist, destination.bilinear_bases_dist);
+  copy_rounded(source.free_var_matrix.blocks,
+               destination.free_var_matrix.blocks);
+  copy_rounded(source.primal_objective_c.blocks,
+               destination.primal_objective_c.blocks);
+  copy_rounded(source.dual_objective_b.LockedMatrix(),
+               destination.dual_objective_b.Matrix());
+  copy_rounded(source.yp_to_y.LockedMatrix(), destination.yp_to_y.Matrix());
+
+  round_to_precision(destination.objective_const);
+  mpf_set(destination.objective_const.gmp_float.get_mpf_t(),
+          source.objective_const.gmp_float.get_mpf_t());
+}
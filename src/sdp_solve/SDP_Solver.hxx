@@ -10,10 +10,13 @@
 #include "Block_Diagonal_Matrix.hxx"
 #include "Block_Matrix.hxx"
 #include "Block_Vector.hxx"
+#include "Cholesky_Inverse.hxx"
 #include "SDP.hxx"
 #include "SDP_Solver_Terminate_Reason.hxx"
+#include "SDP_Solver_Workspace.hxx"
 
 #include "SDP_Solver_Parameters.hxx"
+#include "Thread_Pool.hxx"
 #include "../Timers.hxx"
 
 #include <boost/filesystem.hpp>
@@ -72,8 +75,29 @@ public:
   Block_Vector dual_residues;
   El::BigFloat dual_error; // maxAbs(dualResidues)
 
+  // If the residues are updated incrementally, the largest difference
+  // between the updated and the recomputed primal_residues and
+  // dual_residues, the last time they were recomputed.
+  El::BigFloat primal_residue_drift = 0, dual_residue_drift = 0;
+
+  // If the Schur complement solver is factored at a lower precision,
+  // the number of iterative refinement steps in the last step, summed
+  // over the predictor and corrector, and the larger of their final
+  // relative residues.
+  size_t num_schur_refinements = 0;
+  El::BigFloat schur_residue;
+
+  // Temporaries reused in every iteration
+  SDP_Solver_Workspace workspace;
+
   int64_t current_generation;
   boost::optional<int64_t> backup_generation;
+
+  // When run() stops with SDP_Solver_Terminate_Reason::RebalanceBlocks,
+  // the number of iterations that it completed, and the measured cost
+  // of each block, as in a block_timings file (see is_imbalanced).
+  size_t num_iterations = 0;
+  El::Matrix<int32_t> block_timings;
   
   SDP_Solver(const SDP_Solver_Parameters &parameters,
              const Block_Info &block_info, const El::Grid &grid,
@@ -87,12 +111,13 @@ public:
   step(const SDP_Solver_Parameters &parameters,
        const std::size_t &total_psd_rows,
        const bool &is_primal_and_dual_feasible, const Block_Info &block_info,
-       const SDP &sdp, const El::Grid &grid,
+       const SDP &sdp, Thread_Pool &thread_pool,
        const Block_Diagonal_Matrix &X_cholesky,
+       const Cholesky_Inverse &X_cholesky_inverse,
        const Block_Diagonal_Matrix &Y_cholesky,
        const Block_Diagonal_Matrix &bilinear_pairings_X_inv,
        const Block_Diagonal_Matrix &bilinear_pairings_Y,
-       const Block_Vector &primal_residue_p, El::BigFloat &mu,
+       const Block_Vector &primal_residue_p, const El::BigFloat &mu,
        El::BigFloat &beta_corrector, El::BigFloat &primal_step_length,
        El::BigFloat &dual_step_length, bool &terminate_now, Timers &timers);
 
@@ -13,11 +13,17 @@ SDP_Solver::SDP_Solver(const SDP_Solver_Parameters &parameters,
       Y(X), primal_residues(X),
       dual_residues(block_info.schur_block_sizes, block_info.block_indices,
                     block_info.schur_block_sizes.size(), grid),
+      workspace(block_info, grid, dual_objective_b_height,
+                parameters.is_mixed_precision() ? parameters.schur_precision
+                                                : 0),
       current_generation(0)
 {
-  if(!load_checkpoint(parameters.checkpoint_in, block_info,
-                      parameters.verbosity,
-                      parameters.require_initial_checkpoint))
+  // An empty checkpoint_in means starting from scratch, for example
+  // when the caller fills in x, X, y and Y itself.
+  if(parameters.checkpoint_in.empty()
+     || !load_checkpoint(parameters.checkpoint_in, block_info,
+                         parameters.verbosity,
+                         parameters.require_initial_checkpoint))
     {
       X.set_zero();
       Y.set_zero();
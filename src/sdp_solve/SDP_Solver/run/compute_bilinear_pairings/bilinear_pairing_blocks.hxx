@@ -0,0 +1,180 @@
+#pragma once
+
+#include "../../../Multiply_Backend.hxx"
+
+// The bilinear pairings of a block only involve the Kronecker product
+// 1 \otimes bilinear_base, which is block diagonal with m copies of
+// the (d+1) x k matrix bilinear_base.  Instead of multiplying by the
+// dense (m(d+1)) x (mk) matrix, these work with one (r,s) sub-block
+// at a time, which saves a factor of about m in the flops.  Only the
+// lower block triangle of the result is computed.
+//
+// These work the same way for El::Matrix, for blocks that live on a
+// single rank, and for El::DistMatrix.
+
+// result = W^T W, where W = L^{-1} (1 \otimes base) is in work, and
+// X = L L^T.  Column block s of W is zero above row block s.
+template <class Matrix>
+void bilinear_pairings_X_inv_result(const size_t &base_height,
+                                    const size_t &base_width,
+                                    const Multiply_Backend &multiply_backend,
+                                    const Matrix &work, Matrix &result)
+{
+  const size_t height(work.Height()), m(result.Height() / base_width);
+
+  // The (r,s) block of the result, with s <= r, is the product of
+  // block columns r and s of W, which are both zero above row block
+  // r.
+  for(size_t r = 0; r < m; ++r)
+    {
+      const size_t offset(r * base_height);
+      Matrix result_row(
+        El::View(result, r * base_width, 0, base_width, (r + 1) * base_width));
+      gemm(multiply_backend, El::Orientation::TRANSPOSE,
+           El::Orientation::NORMAL,
+           El::LockedView(work, offset, r * base_width, height - offset,
+                          base_width),
+           El::LockedView(work, offset, 0, height - offset,
+                          (r + 1) * base_width),
+           El::BigFloat(0), result_row);
+    }
+  El::MakeSymmetric(El::UpperOrLower::LOWER, result);
+}
+
+// result = (1 \otimes base)^T X^{-1} (1 \otimes base)
+//
+// On input, work must hold 1 \otimes base on and below the block
+// diagonal (see fill_bilinear_workspace).  On output, it holds
+// L^{-1} (1 \otimes base), where X = L L^T.
+template <class Matrix>
+void bilinear_pairings_X_inv_block(const Matrix &X_cholesky,
+                                   const size_t &base_height,
+                                   const size_t &base_width,
+                                   const Multiply_Backend &multiply_backend,
+                                   Matrix &work, Matrix &result)
+{
+  // base_height may be zero, so get m from the result.
+  const size_t height(X_cholesky.Height()), m(result.Height() / base_width);
+
+  // Column block s of 1 \otimes base is zero above row block s, and L
+  // is lower triangular, so only rows from block s on are needed.
+  for(size_t s = 0; s < m; ++s)
+    {
+      const size_t offset(s * base_height);
+      Matrix work_block(El::View(work, offset, s * base_width,
+                                 height - offset, base_width));
+      El::Trsm(El::LeftOrRight::LEFT, El::UpperOrLowerNS::LOWER,
+               El::Orientation::NORMAL, El::UnitOrNonUnit::NON_UNIT,
+               El::BigFloat(1),
+               El::LockedView(X_cholesky, offset, offset, height - offset,
+                              height - offset),
+               work_block);
+    }
+  bilinear_pairings_X_inv_result(base_height, base_width, multiply_backend,
+                                 work, result);
+}
+
+// The same as bilinear_pairings_X_inv_block, but with L^{-1} from a
+// Cholesky_Inverse.  Then column block s of L^{-1} (1 \otimes base) is
+// (column block s of L^{-1}) base, which is a Gemm instead of a
+// triangular solve, and work does not have to be filled first.  The
+// parts of work above the block diagonal are not written.
+template <class Matrix>
+void bilinear_pairings_X_inv_cached_block(
+  const Matrix &X_cholesky_inverse, const Matrix &base,
+  const Multiply_Backend &multiply_backend, Matrix &work, Matrix &result)
+{
+  const size_t base_height(base.Height()), base_width(base.Width()),
+    height(X_cholesky_inverse.Height()), m(result.Height() / base_width);
+
+  for(size_t s = 0; s < m; ++s)
+    {
+      const size_t offset(s * base_height);
+      Matrix work_block(El::View(work, offset, s * base_width,
+                                 height - offset, base_width));
+      gemm(multiply_backend, El::Orientation::NORMAL, El::Orientation::NORMAL,
+           El::LockedView(X_cholesky_inverse, offset, offset,
+                          height - offset, base_height),
+           base, El::BigFloat(0), work_block);
+    }
+  bilinear_pairings_X_inv_result(base_height, base_width, multiply_backend,
+                                 work, result);
+}
+
+// result = (1 \otimes base)^T Y (1 \otimes base)
+//
+// work is only used as scratch space for Y (1 \otimes base).
+template <class Matrix>
+void bilinear_pairings_Y_block(const Matrix &Y, const Matrix &base,
+                               const Multiply_Backend &multiply_backend,
+                               Matrix &work, Matrix &result)
+{
+  const size_t base_height(base.Height()), base_width(base.Width()),
+    height(Y.Height()), m(result.Height() / base_width);
+
+  // Column block s of Y (1 \otimes base) = (column block s of Y) base
+  for(size_t s = 0; s < m; ++s)
+    {
+      Matrix work_block(
+        El::View(work, 0, s * base_width, height, base_width));
+      gemm(multiply_backend, El::Orientation::NORMAL, El::Orientation::NORMAL,
+           El::LockedView(Y, 0, s * base_height, height, base_height), base,
+           El::BigFloat(0), work_block);
+    }
+
+  // Row block r of the result = base^T (row block r of the above)
+  for(size_t r = 0; r < m; ++r)
+    {
+      Matrix result_row(
+        El::View(result, r * base_width, 0, base_width, (r + 1) * base_width));
+      gemm(multiply_backend, El::Orientation::TRANSPOSE,
+           El::Orientation::NORMAL, base,
+           El::LockedView(work, r * base_height, 0, base_height,
+                          (r + 1) * base_width),
+           El::BigFloat(0), result_row);
+    }
+  El::MakeSymmetric(El::UpperOrLower::LOWER, result);
+}
+
+// result = (1 \otimes base)^T Y (1 \otimes base)
+//        = (L^T (1 \otimes base))^T (L^T (1 \otimes base)),
+//
+// where Y = L L^T.  On input, work must hold 1 \otimes base on and
+// below the block diagonal (see fill_bilinear_workspace).  Column
+// block s of L^T (1 \otimes base) is zero below row block s.  The
+// diagonal block is a triangular multiply, and the blocks above it
+// are a Gemm against base.  Then a single Syrk fills the lower
+// triangle of the result.
+template <class Matrix>
+void bilinear_pairings_Y_cholesky_block(
+  const Matrix &Y_cholesky, const Matrix &base,
+  const Multiply_Backend &multiply_backend, Matrix &work, Matrix &result)
+{
+  const size_t base_height(base.Height()), base_width(base.Width()),
+    m(result.Height() / base_width);
+
+  for(size_t s = 0; s < m; ++s)
+    {
+      const size_t offset(s * base_height);
+      if(s != 0)
+        {
+          Matrix work_above(
+            El::View(work, 0, s * base_width, offset, base_width));
+          gemm(multiply_backend, El::Orientation::TRANSPOSE,
+               El::Orientation::NORMAL,
+               El::LockedView(Y_cholesky, offset, 0, base_height, offset),
+               base, El::BigFloat(0), work_above);
+        }
+      Matrix work_diagonal(
+        El::View(work, offset, s * base_width, base_height, base_width));
+      El::Trmm(El::LeftOrRight::LEFT, El::UpperOrLowerNS::LOWER,
+               El::Orientation::TRANSPOSE, El::UnitOrNonUnit::NON_UNIT,
+               El::BigFloat(1),
+               El::LockedView(Y_cholesky, offset, offset, base_height,
+                              base_height),
+               work_diagonal);
+    }
+  syrk(multiply_backend, El::UpperOrLowerNS::LOWER,
+       El::Orientation::TRANSPOSE, work, El::BigFloat(0), result);
+  El::MakeSymmetric(El::UpperOrLower::LOWER, result);
+}
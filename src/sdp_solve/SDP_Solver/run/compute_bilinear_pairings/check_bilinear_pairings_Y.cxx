@@ -0,0 +1,42 @@
+#include <El.hpp>
+
+#include <sstream>
+#include <stdexcept>
+
+// Compare the bilinear pairings of Y computed from the Cholesky
+// decomposition with the ones computed with Gemm's.  As in
+// check_mpmat, compare the largest difference with the largest
+// element, allowing for some loss of precision in both results.
+void check_bilinear_pairings_Y(const El::DistMatrix<El::BigFloat> &gemm_result,
+                               const El::DistMatrix<El::BigFloat> &result,
+                               const size_t &block_index)
+{
+  El::BigFloat max_difference(0), max_element(0);
+  for(int64_t column = 0; column < result.LocalWidth(); ++column)
+    for(int64_t row = 0; row < result.LocalHeight(); ++row)
+      {
+        max_difference = std::max(
+          max_difference, El::Abs(gemm_result.GetLocal(row, column)
+                                  - result.GetLocal(row, column)));
+        max_element = std::max(max_element,
+                               El::Abs(gemm_result.GetLocal(row, column)));
+      }
+  max_difference
+    = El::mpi::AllReduce(max_difference, El::mpi::MAX, result.DistComm());
+  max_element
+    = El::mpi::AllReduce(max_element, El::mpi::MAX, result.DistComm());
+
+  El::BigFloat tolerance(1);
+  mpf_div_2exp(tolerance.gmp_float.get_mpf_t(),
+               tolerance.gmp_float.get_mpf_t(),
+               mpf_get_default_prec() - 64);
+  if(max_difference > tolerance * max_element)
+    {
+      std::stringstream ss;
+      ss << "Bilinear pairings of Y from the Cholesky decomposition do not "
+            "agree with gemm for block "
+         << block_index << ".\n\tmax difference: " << max_difference
+         << "\n\tmax element: " << max_element;
+      throw std::runtime_error(ss.str());
+    }
+}
@@ -1,30 +1,56 @@
-#include "../../../Block_Diagonal_Matrix.hxx"
+#include "../../../Cholesky_Inverse.hxx"
+#include "../../../Bilinear_Pairings_Y_Method.hxx"
 #include "../../../../Timers.hxx"
 
 void compute_bilinear_pairings_X_inv(
   const Block_Diagonal_Matrix &X_cholesky,
+  const Cholesky_Inverse &X_cholesky_inverse,
   const std::vector<El::Matrix<El::BigFloat>> &bilinear_bases,
+  const std::vector<El::DistMatrix<El::BigFloat>> &bilinear_bases_dist,
+  const Multiply_Backend &multiply_backend, Thread_Pool &thread_pool,
   std::vector<El::DistMatrix<El::BigFloat>> &workspace,
-  Block_Diagonal_Matrix &bilinear_pairings_X_inv);
+  Block_Diagonal_Matrix &bilinear_pairings_X_inv,
+  std::vector<std::chrono::high_resolution_clock::duration> &block_elapsed);
 
 void compute_bilinear_pairings_Y(
-  const Block_Diagonal_Matrix &Y,
-  const std::vector<El::Matrix<El::BigFloat>> &bilinear_bases,
+  const Block_Diagonal_Matrix &Y, const Block_Diagonal_Matrix &Y_cholesky,
+  const std::vector<El::Matrix<El::BigFloat>> &bilinear_bases_local,
+  const std::vector<El::DistMatrix<El::BigFloat>> &bilinear_bases,
+  const Bilinear_Pairings_Y_Method &method,
+  const Multiply_Backend &multiply_backend, Thread_Pool &thread_pool,
   std::vector<El::DistMatrix<El::BigFloat>> &workspace,
-  Block_Diagonal_Matrix &bilinear_pairings_Y);
+  Block_Diagonal_Matrix &bilinear_pairings_Y,
+  std::vector<std::chrono::high_resolution_clock::duration> &block_elapsed);
 
 void compute_bilinear_pairings(
-  const Block_Diagonal_Matrix &X_cholesky, const Block_Diagonal_Matrix &Y,
-  const std::vector<El::Matrix<El::BigFloat>> &bilinear_bases,
+  const Block_Diagonal_Matrix &X_cholesky,
+  const Cholesky_Inverse &X_cholesky_inverse, const Block_Diagonal_Matrix &Y,
+  const Block_Diagonal_Matrix &Y_cholesky,
+  const std::vector<El::Matrix<El::BigFloat>> &bilinear_bases_local,
+  const std::vector<El::DistMatrix<El::BigFloat>> &bilinear_bases_dist,
+  const Bilinear_Pairings_Y_Method &bilinear_pairings_Y_method,
+  const Multiply_Backend &multiply_backend, Thread_Pool &thread_pool,
   std::vector<El::DistMatrix<El::BigFloat>> &workspace,
   Block_Diagonal_Matrix &bilinear_pairings_X_inv,
   Block_Diagonal_Matrix &bilinear_pairings_Y, Timers &timers)
 {
   auto &congruence_timer(timers.add_and_start("run.bilinear_pairings"));
-  compute_bilinear_pairings_X_inv(X_cholesky, bilinear_bases, workspace,
-                                  bilinear_pairings_X_inv);
+  std::vector<Timers::Clock::duration> block_elapsed(
+    workspace.size(), Timers::Clock::duration(0));
+  compute_bilinear_pairings_X_inv(
+    X_cholesky, X_cholesky_inverse, bilinear_bases_local, bilinear_bases_dist,
+    multiply_backend, thread_pool, workspace, bilinear_pairings_X_inv,
+    block_elapsed);
 
-  compute_bilinear_pairings_Y(Y, bilinear_bases, workspace,
-                              bilinear_pairings_Y);
+  compute_bilinear_pairings_Y(Y, Y_cholesky, bilinear_bases_local,
+                              bilinear_bases_dist, bilinear_pairings_Y_method,
+                              multiply_backend, thread_pool, workspace,
+                              bilinear_pairings_Y, block_elapsed);
+  // Both parities of a block are at 2*block and 2*block + 1.
+  for(size_t block = 0; block < block_elapsed.size(); ++block)
+    {
+      timers.add_block_elapsed("bilinear_pairings", block / 2,
+                               block_elapsed[block]);
+    }
   congruence_timer.stop();
 }
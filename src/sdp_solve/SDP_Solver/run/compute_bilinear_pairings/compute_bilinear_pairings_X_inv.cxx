@@ -1,56 +1,79 @@
-#include "../../../Block_Diagonal_Matrix.hxx"
+#include "bilinear_pairing_blocks.hxx"
+#include "../../../Cholesky_Inverse.hxx"
 
 // bilinear_pairings_X_inv = bilinear_base^T X^{-1} bilinear_base for each block
+//
+// Blocks where X_cholesky_inverse holds L^{-1} multiply by it instead
+// of solving with X_cholesky.  The time for each block is added to
+// block_elapsed.
+
+void fill_bilinear_workspace(const El::Matrix<El::BigFloat> &bilinear_base,
+                             El::DistMatrix<El::BigFloat> &work);
 
 void compute_bilinear_pairings_X_inv(
   const Block_Diagonal_Matrix &X_cholesky,
+  const Cholesky_Inverse &X_cholesky_inverse,
   const std::vector<El::Matrix<El::BigFloat>> &bilinear_bases,
+  const std::vector<El::DistMatrix<El::BigFloat>> &bilinear_bases_dist,
+  const Multiply_Backend &multiply_backend, Thread_Pool &thread_pool,
   std::vector<El::DistMatrix<El::BigFloat>> &workspace,
-  Block_Diagonal_Matrix &bilinear_pairings_X_inv)
+  Block_Diagonal_Matrix &bilinear_pairings_X_inv,
+  std::vector<std::chrono::high_resolution_clock::duration> &block_elapsed)
 {
-  auto X_cholesky_block(X_cholesky.blocks.begin());
-  auto bilinear_pairings_X_inv_block(bilinear_pairings_X_inv.blocks.begin());
-  auto bilinear_bases_block(bilinear_bases.begin());
+  using Clock = std::chrono::high_resolution_clock;
 
-  for(auto &work : workspace)
+  // Blocks that live on a single rank are computed with local
+  // matrices by the thread pool.  The rest need MPI, so they are
+  // done by the main thread.
+  std::vector<size_t> local_blocks, distributed_blocks;
+  for(size_t block = 0; block < workspace.size(); ++block)
     {
-      // FIXME: This should be a constant, not computed over and over.
-      // Set up the workspace to have copies of bilinear_bases[b]
-      // along the diagonal
-      for(int64_t row = 0; row < work.LocalHeight(); ++row)
-        {
-          size_t global_row(work.GlobalRow(row));
-          size_t row_block(global_row / bilinear_bases_block->Height());
+      (workspace[block].Grid().Size() == 1 ? local_blocks : distributed_blocks)
+        .push_back(block);
+    }
 
-          for(int64_t column = 0; column < work.LocalWidth(); ++column)
-            {
-              size_t global_column(work.GlobalCol(column));
-              size_t column_block(global_column
-                                  / bilinear_bases_block->Width());
-              work.SetLocal(
-                row, column,
-                row_block != column_block
-                  ? El::BigFloat(0)
-                  : (*bilinear_bases_block)(
-                      global_row % bilinear_bases_block->Height(),
-                      global_column % bilinear_bases_block->Width()));
-            }
+  thread_pool.parallel_for(
+    local_blocks.size(), [&](const size_t &index, const size_t &) {
+      const size_t block(local_blocks[index]);
+      const auto start(Clock::now());
+      auto &work(workspace[block]);
+      if(X_cholesky_inverse.block(block) != nullptr)
+        {
+          bilinear_pairings_X_inv_cached_block(
+            X_cholesky_inverse.blocks[block].LockedMatrix(),
+            bilinear_bases_dist[block].LockedMatrix(), multiply_backend,
+            work.Matrix(), bilinear_pairings_X_inv.blocks[block].Matrix());
         }
+      else
+        {
+          fill_bilinear_workspace(bilinear_bases[block], work);
+          bilinear_pairings_X_inv_block(
+            X_cholesky.blocks[block].LockedMatrix(),
+            bilinear_bases[block].Height(), bilinear_bases[block].Width(),
+            multiply_backend, work.Matrix(),
+            bilinear_pairings_X_inv.blocks[block].Matrix());
+        }
+      block_elapsed[block] += Clock::now() - start;
+    });
 
-      El::Trsm(El::LeftOrRight::LEFT, El::UpperOrLowerNS::LOWER,
-               El::Orientation::NORMAL, El::UnitOrNonUnit::NON_UNIT,
-               El::BigFloat(1), *X_cholesky_block, work);
-
-      // We have to set this to zero because the values can be NaN.
-      // Multiplying 0*NaN = NaN.
-      Zero(*bilinear_pairings_X_inv_block);
-      Syrk(El::UpperOrLowerNS::LOWER, El::Orientation::TRANSPOSE,
-           El::BigFloat(1), work, El::BigFloat(0),
-           *bilinear_pairings_X_inv_block);
-      El::MakeSymmetric(El::UpperOrLower::LOWER,
-                        *bilinear_pairings_X_inv_block);
-      ++X_cholesky_block;
-      ++bilinear_pairings_X_inv_block;
-      ++bilinear_bases_block;
+  for(auto &block : distributed_blocks)
+    {
+      const auto start(Clock::now());
+      auto &work(workspace[block]);
+      if(X_cholesky_inverse.block(block) != nullptr)
+        {
+          bilinear_pairings_X_inv_cached_block(
+            X_cholesky_inverse.blocks[block], bilinear_bases_dist[block],
+            multiply_backend, work, bilinear_pairings_X_inv.blocks[block]);
+        }
+      else
+        {
+          fill_bilinear_workspace(bilinear_bases[block], work);
+          bilinear_pairings_X_inv_block(
+            X_cholesky.blocks[block], bilinear_bases[block].Height(),
+            bilinear_bases[block].Width(), multiply_backend, work,
+            bilinear_pairings_X_inv.blocks[block]);
+        }
+      block_elapsed[block] += Clock::now() - start;
     }
 }
@@ -1,4 +1,7 @@
+#include "bilinear_pairing_blocks.hxx"
 #include "../../../Block_Diagonal_Matrix.hxx"
+#include "../../../Bilinear_Pairings_Y_Method.hxx"
+#include "../../../Thread_Pool.hxx"
 
 // bilinear_pairings_Y[b] = Q[b]'^T A[b] Q[b]' for each block 0 <= b < Q.size()
 // bilinear_pairings_Y[b], A[b] denote the b-th blocks of bilinear_pairings_Y,
@@ -9,48 +12,99 @@
 // for each b, L.blocks[b], Q[b], Work[b], and bilinear_pairings_Y.blocks[b]
 // must have the structure described above for `tensorTransposeCongruence'
 
+// The time for each block, not counting cholesky_check, is added to
+// block_elapsed.
+
+void fill_bilinear_workspace(const El::Matrix<El::BigFloat> &bilinear_base,
+                             El::DistMatrix<El::BigFloat> &work);
+
+void check_bilinear_pairings_Y(const El::DistMatrix<El::BigFloat> &gemm_result,
+                               const El::DistMatrix<El::BigFloat> &result,
+                               const size_t &block_index);
+
 void compute_bilinear_pairings_Y(
-  const Block_Diagonal_Matrix &Y,
-  const std::vector<El::Matrix<El::BigFloat>> &bilinear_bases,
+  const Block_Diagonal_Matrix &Y, const Block_Diagonal_Matrix &Y_cholesky,
+  const std::vector<El::Matrix<El::BigFloat>> &bilinear_bases_local,
+  const std::vector<El::DistMatrix<El::BigFloat>> &bilinear_bases,
+  const Bilinear_Pairings_Y_Method &method,
+  const Multiply_Backend &multiply_backend, Thread_Pool &thread_pool,
   std::vector<El::DistMatrix<El::BigFloat>> &workspace,
-  Block_Diagonal_Matrix &bilinear_pairings_Y)
+  Block_Diagonal_Matrix &bilinear_pairings_Y,
+  std::vector<std::chrono::high_resolution_clock::duration> &block_elapsed)
 {
-  auto Y_block(Y.blocks.begin());
-  auto bilinear_pairings_Y_block(bilinear_pairings_Y.blocks.begin());
-  auto bilinear_bases_block(bilinear_bases.begin());
+  using Clock = std::chrono::high_resolution_clock;
+
+  const bool use_cholesky(method != Bilinear_Pairings_Y_Method::gemm);
+
+  // Blocks that live on a single rank are computed with local
+  // matrices by the thread pool.  The rest need MPI, so they are
+  // done by the main thread.
+  std::vector<size_t> local_blocks, distributed_blocks;
+  for(size_t block = 0; block < workspace.size(); ++block)
+    {
+      (workspace[block].Grid().Size() == 1 ? local_blocks : distributed_blocks)
+        .push_back(block);
+    }
+
+  thread_pool.parallel_for(
+    local_blocks.size(), [&](const size_t &index, const size_t &) {
+      const size_t block(local_blocks[index]);
+      const auto start(Clock::now());
+      if(use_cholesky)
+        {
+          fill_bilinear_workspace(bilinear_bases_local[block],
+                                  workspace[block]);
+          bilinear_pairings_Y_cholesky_block(
+            Y_cholesky.blocks[block].LockedMatrix(),
+            bilinear_bases[block].LockedMatrix(), multiply_backend,
+            workspace[block].Matrix(),
+            bilinear_pairings_Y.blocks[block].Matrix());
+        }
+      else
+        {
+          bilinear_pairings_Y_block(
+            Y.blocks[block].LockedMatrix(),
+            bilinear_bases[block].LockedMatrix(), multiply_backend,
+            workspace[block].Matrix(),
+            bilinear_pairings_Y.blocks[block].Matrix());
+        }
+      block_elapsed[block] += Clock::now() - start;
+    });
+
+  for(auto &block : distributed_blocks)
+    {
+      const auto start(Clock::now());
+      if(use_cholesky)
+        {
+          fill_bilinear_workspace(bilinear_bases_local[block],
+                                  workspace[block]);
+          bilinear_pairings_Y_cholesky_block(
+            Y_cholesky.blocks[block], bilinear_bases[block],
+            multiply_backend, workspace[block],
+            bilinear_pairings_Y.blocks[block]);
+        }
+      else
+        {
+          bilinear_pairings_Y_block(Y.blocks[block], bilinear_bases[block],
+                                    multiply_backend, workspace[block],
+                                    bilinear_pairings_Y.blocks[block]);
+        }
+      block_elapsed[block] += Clock::now() - start;
+    }
 
-  for(auto &work : workspace)
+  if(method == Bilinear_Pairings_Y_Method::cholesky_check)
     {
-      // FIXME: This should be a constant, not computed over and over.
-      // Set up the workspace to have copies of bilinear_bases
-      // along the diagonal
-      for(int64_t row = 0; row < work.LocalHeight(); ++row)
+      for(size_t block = 0; block < workspace.size(); ++block)
         {
-          size_t global_row(work.GlobalRow(row)),
-            row_block(global_row / bilinear_bases_block->Height());
-
-          for(int64_t column = 0; column < work.LocalWidth(); ++column)
-            {
-              size_t global_column(work.GlobalCol(column)),
-                column_block(global_column / bilinear_bases_block->Width());
-              work.SetLocal(
-                row, column,
-                row_block != column_block
-                  ? El::BigFloat(0)
-                  : (*bilinear_bases_block)(
-                      global_row % bilinear_bases_block->Height(),
-                      global_column % bilinear_bases_block->Width()));
-            }
+          El::DistMatrix<El::BigFloat> gemm_result(
+            bilinear_pairings_Y.blocks[block].Height(),
+            bilinear_pairings_Y.blocks[block].Width(),
+            bilinear_pairings_Y.blocks[block].Grid());
+          bilinear_pairings_Y_block(Y.blocks[block], bilinear_bases[block],
+                                    Multiply_Backend::gmp, workspace[block],
+                                    gemm_result);
+          check_bilinear_pairings_Y(gemm_result,
+                                    bilinear_pairings_Y.blocks[block], block);
         }
-      auto temp_space(work);
-      Gemm(El::Orientation::NORMAL, El::Orientation::NORMAL, El::BigFloat(1),
-           *Y_block, work, El::BigFloat(0), temp_space);
-      Gemm(El::Orientation::TRANSPOSE, El::Orientation::NORMAL,
-           El::BigFloat(1), work, temp_space, El::BigFloat(0),
-           *bilinear_pairings_Y_block);
-      El::MakeSymmetric(El::UpperOrLower::LOWER, *bilinear_pairings_Y_block);
-      ++Y_block;
-      ++bilinear_pairings_Y_block;
-      ++bilinear_bases_block;
     }
 }
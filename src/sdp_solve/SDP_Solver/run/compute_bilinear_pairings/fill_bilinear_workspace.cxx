@@ -0,0 +1,34 @@
+#include <El.hpp>
+
+// Set up the workspace as the right hand side of the solve in
+// bilinear_pairings_X_inv_block: 1 \otimes bilinear_base, with copies
+// of bilinear_base along the diagonal and zeros below.  The blocks
+// above the diagonal are never read, so they are left alone.  This
+// only touches local elements, so it is safe to call from a worker
+// thread.
+
+void fill_bilinear_workspace(const El::Matrix<El::BigFloat> &bilinear_base,
+                             El::DistMatrix<El::BigFloat> &work)
+{
+  El::Matrix<El::BigFloat> &local(work.Matrix());
+  for(int64_t column = 0; column < work.LocalWidth(); ++column)
+    {
+      const size_t global_column(work.GlobalCol(column)),
+        column_block(global_column / bilinear_base.Width());
+      for(int64_t row = 0; row < work.LocalHeight(); ++row)
+        {
+          const size_t global_row(work.GlobalRow(row)),
+            row_block(global_row / bilinear_base.Height());
+          if(row_block == column_block)
+            {
+              local(row, column) = bilinear_base(
+                global_row % bilinear_base.Height(),
+                global_column % bilinear_base.Width());
+            }
+          else if(row_block > column_block)
+            {
+              mpf_set_ui(local(row, column).gmp_float.get_mpf_t(), 0);
+            }
+        }
+    }
+}
@@ -1,4 +1,5 @@
 #include "../../SDP_Solver.hxx"
+#include "../../Scalar_Reductions.hxx"
 
 // dualResidues[p] = primalObjective[p] - Tr(A_p Y) - (FreeVarMatrix y)_p,
 // for 0 <= p < primalObjective.size()
@@ -8,12 +9,23 @@
 //   Tr(A_(j,r,s,k) Y) = \sum_{b \in blocks[j]}
 //                       (1/2) (BilinearPairingsY_{ej r + k, ej s + k} +
 //                              swap (r <-> s))
-// where ej = d_j + 1.
+// where ej = d_j + 1.  These are read directly from the local
+// elements of BilinearPairingsY by subtract_constraint_traces.
+//
+// dual_error = max|dualResidues| is only this rank's contribution
+// until reductions.reduce().
+
+void subtract_constraint_traces(const El::DistMatrix<El::BigFloat> *M,
+                                const El::Matrix<El::BigFloat> *bases,
+                                const size_t &dimension,
+                                El::Matrix<El::BigFloat> &traces,
+                                El::DistMatrix<El::BigFloat> &result);
 
 void compute_dual_residues_and_error(
   const Block_Info &block_info, const SDP &sdp, const Block_Vector &y,
   const Block_Diagonal_Matrix &bilinear_pairings_Y,
-  Block_Vector &dual_residues, El::BigFloat &dual_error, Timers &timers)
+  Block_Vector &dual_residues, El::BigFloat &dual_error,
+  Scalar_Reductions &reductions, Timers &timers)
 {
   auto &dual_residues_timer(timers.add_and_start("run.computeDualResidues"));
 
@@ -23,57 +35,17 @@ void compute_dual_residues_and_error(
   auto free_var_matrix_block(sdp.free_var_matrix.blocks.begin());
   auto bilinear_pairings_Y_block(bilinear_pairings_Y.blocks.begin());
 
-  El::BigFloat local_max(0);
-  for(auto &block_index : block_info.block_indices)
+  El::Matrix<El::BigFloat> traces;
+  for(size_t block = 0; block < block_info.block_indices.size(); ++block)
     {
+      const auto start(Timers::Clock::now());
+      const size_t block_index(block_info.block_indices[block]);
       Zero(*dual_residues_block);
-      const size_t block_size(block_info.degrees[block_index] + 1);
-
-      // Not sure whether it is better to first loop over blocks in
-      // the result or over sub-blocks in bilinear_pairings_Y
-      for(size_t bb = 2 * block_index; bb < 2 * block_index + 2; ++bb)
-        {
-          for(size_t column_block = 0;
-              column_block < block_info.dimensions[block_index];
-              ++column_block)
-            for(size_t row_block = 0; row_block <= column_block; ++row_block)
-              {
-                size_t column_offset(column_block * block_size),
-                  row_offset(row_block * block_size);
-
-                El::DistMatrix<El::BigFloat> lower_diagonal(El::GetDiagonal(
-                  El::LockedView(*bilinear_pairings_Y_block, row_offset,
-                                 column_offset, block_size, block_size)));
-
-                size_t residue_row_offset(
-                  ((column_block * (column_block + 1)) / 2 + row_block)
-                  * block_size);
+      subtract_constraint_traces(&*bilinear_pairings_Y_block, nullptr,
+                                 block_info.dimensions[block_index], traces,
+                                 *dual_residues_block);
+      bilinear_pairings_Y_block += 2;
 
-                El::DistMatrix<El::BigFloat> residue_sub_block(El::View(
-                  *dual_residues_block, residue_row_offset, 0, block_size, 1));
-
-                // Do a little less work when on a diagonal block.
-                if(column_offset == row_offset)
-                  {
-                    El::Axpy(El::BigFloat(-1.0), lower_diagonal,
-                             residue_sub_block);
-                  }
-                else
-                  {
-                    El::Axpy(El::BigFloat(-0.5), lower_diagonal,
-                             residue_sub_block);
-
-                    El::DistMatrix<El::BigFloat> upper_diagonal(
-                      El::GetDiagonal(El::LockedView(
-                        *bilinear_pairings_Y_block, column_offset, row_offset,
-                        block_size, block_size)));
-
-                    El::Axpy(El::BigFloat(-0.5), upper_diagonal,
-                             residue_sub_block);
-                  }
-              }
-          ++bilinear_pairings_Y_block;
-        }
       // dualResidues -= FreeVarMatrix * y
       Gemm(El::Orientation::NORMAL, El::Orientation::NORMAL, El::BigFloat(-1),
            *free_var_matrix_block, *y_block, El::BigFloat(1),
@@ -81,14 +53,14 @@ void compute_dual_residues_and_error(
       // dualResidues += primalObjective
       Axpy(El::BigFloat(1), *primal_objective_c_block, *dual_residues_block);
 
-      local_max = Max(local_max, El::MaxAbs(*dual_residues_block));
-
       ++primal_objective_c_block;
       ++y_block;
       ++free_var_matrix_block;
       ++dual_residues_block;
+      timers.add_block_elapsed("dual_residues", block,
+                               Timers::Clock::now() - start);
     }
-  dual_error
-    = El::mpi::AllReduce(local_max, El::mpi::MAX, El::mpi::COMM_WORLD);
+  dual_error = dual_residues.local_max_abs();
+  reductions.add_max(dual_error);
   dual_residues_timer.stop();
 }
@@ -1,31 +1,39 @@
 #include "../../../SDP.hxx"
+#include "../../../Scalar_Reductions.hxx"
 #include "../../../../Timers.hxx"
 
-El::BigFloat dot(const Block_Vector &a, const Block_Vector &b);
+// primal_objective = c . x and dual_objective = b . y, without
+// objective_const.  These are only this rank's contributions until
+// reductions.reduce(), after which finish_objectives() adds
+// objective_const and computes the duality gap.
+
+El::BigFloat local_dot(const Block_Vector &a, const Block_Vector &b);
 
 void compute_objectives(const SDP &sdp, const Block_Vector &x,
                         const Block_Vector &y, El::BigFloat &primal_objective,
                         El::BigFloat &dual_objective,
-                        El::BigFloat &duality_gap, Timers &timers)
+                        Scalar_Reductions &reductions, Timers &timers)
 {
   auto &objectives_timer(timers.add_and_start("run.objectives"));
-  primal_objective = sdp.objective_const + dot(sdp.primal_objective_c, x);
+  primal_objective = local_dot(sdp.primal_objective_c, x);
   // dual_objective_b is duplicated amongst the processors.  y is
   // duplicated amongst the blocks, but it is possible for some
   // processors to have no blocks.  In principle, we only need to
   // compute the dot product on the first block, but then we would
   // have to make sure that we compute that product over all
-  // processors that own that block.
+  // processors that own that block.  So every processor with blocks
+  // computes it, and only the root contributes it to the sum.
+  dual_objective = 0;
   if(!y.blocks.empty())
     {
-      dual_objective = sdp.objective_const
-                       + El::Dotu(sdp.dual_objective_b, y.blocks.front());
+      const El::BigFloat product(
+        El::Dotu(sdp.dual_objective_b, y.blocks.front()));
+      if(El::mpi::Rank() == 0)
+        {
+          dual_objective = product;
+        }
     }
-  El::mpi::Broadcast(dual_objective, 0, El::mpi::COMM_WORLD);
-
-  duality_gap
-    = Abs(primal_objective - dual_objective)
-      / Max(Abs(primal_objective) + Abs(dual_objective), El::BigFloat(1));
-
+  reductions.add_sum(primal_objective);
+  reductions.add_sum(dual_objective);
   objectives_timer.stop();
 }
@@ -0,0 +1,15 @@
+#include "../../../SDP.hxx"
+
+// Add objective_const to the sums from compute_objectives(), once
+// they have been reduced over all ranks, and compute the duality gap.
+
+void finish_objectives(const SDP &sdp, El::BigFloat &primal_objective,
+                       El::BigFloat &dual_objective,
+                       El::BigFloat &duality_gap)
+{
+  primal_objective += sdp.objective_const;
+  dual_objective += sdp.objective_const;
+  duality_gap
+    = Abs(primal_objective - dual_objective)
+      / Max(Abs(primal_objective) + Abs(dual_objective), El::BigFloat(1));
+}
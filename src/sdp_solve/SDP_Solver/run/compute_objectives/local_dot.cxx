@@ -0,0 +1,27 @@
+#include "../../../Block_Vector.hxx"
+#include <cassert>
+
+// This rank's contribution to the dot product of A and B, which must
+// have the same structure.  Every element lives on exactly one rank,
+// so summing over all ranks gives the dot product without double
+// counting blocks that are distributed over more than one rank.
+// There is no communication.
+El::BigFloat local_dot(const Block_Vector &A, const Block_Vector &B)
+{
+  assert(A.blocks.size() == B.blocks.size());
+  El::BigFloat local_sum(0), product;
+  for(size_t ii = 0; ii != A.blocks.size(); ++ii)
+    {
+      const El::Matrix<El::BigFloat> &A_local(A.blocks[ii].LockedMatrix()),
+        &B_local(B.blocks[ii].LockedMatrix());
+      for(int64_t column = 0; column < A_local.Width(); ++column)
+        for(int64_t row = 0; row < A_local.Height(); ++row)
+          {
+            mpf_mul(product.gmp_float.get_mpf_t(),
+                    A_local(row, column).gmp_float.get_mpf_t(),
+                    B_local(row, column).gmp_float.get_mpf_t());
+            local_sum += product;
+          }
+    }
+  return local_sum;
+}
@@ -1,16 +1,24 @@
 #include "constraint_matrix_weighted_sum.hxx"
+#include "../../Scalar_Reductions.hxx"
 
 // PrimalResidues = \sum_p A_p x[p] - X
+//
+// primal_error = max|PrimalResidues| is only this rank's contribution
+// until reductions.reduce().
 
 void compute_primal_residues_and_error_P_Ax_X(
   const Block_Info &block_info, const SDP &sdp, const Block_Vector &x,
-  const Block_Diagonal_Matrix &X, Block_Diagonal_Matrix &primal_residues,
-  El::BigFloat &primal_error, Timers &timers)
+  const Block_Diagonal_Matrix &X,
+  std::vector<El::DistMatrix<El::BigFloat>> &scaled_bases,
+  Block_Diagonal_Matrix &primal_residues, El::BigFloat &primal_error,
+  Scalar_Reductions &reductions, Timers &timers)
 {
   auto &primal_residues_timer(
     timers.add_and_start("run.computePrimalResidues"));
-  constraint_matrix_weighted_sum(block_info, sdp, x, primal_residues);
+  constraint_matrix_weighted_sum(block_info, sdp, x, scaled_bases,
+                                 primal_residues);
   primal_residues -= X;
-  primal_error = primal_residues.max_abs();
+  primal_error = primal_residues.local_symmetric_max_abs();
+  reductions.add_max(primal_error);
   primal_residues_timer.stop();
 }
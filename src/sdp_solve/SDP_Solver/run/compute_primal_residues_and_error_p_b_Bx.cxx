@@ -1,16 +1,19 @@
 #include "../../SDP_Solver.hxx"
+#include "../../Scalar_Reductions.hxx"
 
 // Compute the residue
 //
 // p[n] = dualObjective[n] - (FreeVarMatrix^T x)_n  for 0 <= n < N
 //
-// and the corresponding primal error max(|p_i|)
+// and the corresponding primal error max(|p_i|).  primal_error is
+// only this rank's contribution until reductions.reduce().
 
 void compute_primal_residues_and_error_p_b_Bx(const Block_Info &block_info,
                                               const SDP &sdp,
                                               const Block_Vector &x,
                                               Block_Vector &primal_residue_p,
-                                              El::BigFloat &primal_error)
+                                              El::BigFloat &primal_error,
+                                              Scalar_Reductions &reductions)
 {
   auto free_var_matrix_block(sdp.free_var_matrix.blocks.begin());
   auto x_block(x.blocks.begin());
@@ -71,16 +74,13 @@ void compute_primal_residues_and_error_p_b_Bx(const Block_Info &block_info,
   primal_residue_dist.ProcessQueues();
 
   // Get the max error.
-  El::BigFloat local_primal_error(0);
+  primal_error = 0;
   for(int64_t row = 0; row < primal_residue_dist.LocalHeight(); ++row)
     for(int64_t column = 0; column < primal_residue_dist.LocalWidth();
         ++column)
       {
-        local_primal_error
-          = std::max(local_primal_error,
-                     El::Abs(primal_residue_dist.GetLocal(row, column)));
+        primal_error = std::max(
+          primal_error, El::Abs(primal_residue_dist.GetLocal(row, column)));
       }
-
-  primal_error = El::mpi::AllReduce(local_primal_error, El::mpi::MAX,
-                                    El::mpi::COMM_WORLD);
+  reductions.add_max(primal_error);
 }
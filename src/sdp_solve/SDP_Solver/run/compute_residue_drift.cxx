@@ -0,0 +1,30 @@
+#include "../../Block_Diagonal_Matrix.hxx"
+#include "../../Block_Vector.hxx"
+#include "../../Scalar_Reductions.hxx"
+
+// The drift of the incrementally updated residues (see
+// update_residues), given the updated residues in primal_updated and
+// dual_updated, and the recomputed ones in primal_residues and
+// dual_residues.  primal_updated and dual_updated are overwritten
+// with the differences.  The drifts are only this rank's
+// contributions until reductions.reduce().
+
+void compute_residue_drift(const Block_Diagonal_Matrix &primal_residues,
+                           const Block_Vector &dual_residues,
+                           Block_Diagonal_Matrix &primal_updated,
+                           Block_Vector &dual_updated,
+                           El::BigFloat &primal_drift,
+                           El::BigFloat &dual_drift,
+                           Scalar_Reductions &reductions)
+{
+  primal_updated -= primal_residues;
+  primal_drift = primal_updated.local_symmetric_max_abs();
+  reductions.add_max(primal_drift);
+
+  for(size_t block = 0; block < dual_updated.blocks.size(); ++block)
+    {
+      dual_updated.blocks[block] -= dual_residues.blocks[block];
+    }
+  dual_drift = dual_updated.local_max_abs();
+  reductions.add_max(dual_drift);
+}
@@ -10,56 +10,158 @@
 //
 // where v_{b,k} is the k-th column of bilinear_bases[b], as described
 // in SDP.h.
+//
+// So the (r,s) sub-block of each block of the result, with r <= s, is
+//
+//   c_rs bilinear_base diag(a_(j,r,s,*)) bilinear_base^T,
+//
+// where c_rs is 1 for r == s and 1/2 otherwise.  For each block,
+// bilinear_base diag(a_(j,r,s,*)) goes into a single buffer that is
+// reused for every (r,s).  The buffers are kept in scaled_bases, one
+// for each element of sdp.bilinear_bases_dist, which are allocated on
+// the first call.  Only the sub-blocks on and above the block
+// diagonal are computed, and only the upper triangle of the diagonal
+// sub-blocks.  Every element of the upper triangle is written, so the
+// result does not have to be zeroed first.
+//
+// Blocks that live on a single rank work directly on the local
+// matrices, without distributed views.
+
+namespace
+{
+  // scaled := base diag(a[offset], ..., a[offset + base.Width() - 1])
+  void scale_columns(const El::Matrix<El::BigFloat> &base,
+                     const El::Matrix<El::BigFloat> &a, const size_t &offset,
+                     El::Matrix<El::BigFloat> &scaled)
+  {
+    for(int64_t column = 0; column < base.Width(); ++column)
+      {
+        const El::BigFloat &weight(a(offset + column, 0));
+        for(int64_t row = 0; row < base.Height(); ++row)
+          {
+            mpf_mul(scaled(row, column).gmp_float.get_mpf_t(),
+                    base(row, column).gmp_float.get_mpf_t(),
+                    weight.gmp_float.get_mpf_t());
+          }
+      }
+  }
+
+  void scale_columns(const El::DistMatrix<El::BigFloat> &base,
+                     const El::DistMatrix<El::BigFloat> &a,
+                     const size_t &offset,
+                     El::DistMatrix<El::BigFloat> &scaled)
+  {
+    if(base.Grid().Size() == 1)
+      {
+        scale_columns(base.LockedMatrix(), a.LockedMatrix(), offset,
+                      scaled.Matrix());
+      }
+    else
+      {
+        El::Copy(base, scaled);
+        El::DiagonalScale(
+          El::LeftOrRight::RIGHT, El::Orientation::NORMAL,
+          El::LockedView(a, offset, 0, base.Width(), 1), scaled);
+      }
+  }
+
+  // The (r,s) sub-block c_rs base scaled^T.  Only the upper triangle
+  // of the diagonal sub-blocks is computed.
+  template <typename Matrix>
+  void sub_block_product(const bool &is_diagonal, const Matrix &base,
+                         const Matrix &scaled, Matrix &result)
+  {
+    if(is_diagonal)
+      {
+        El::Trrk(El::UpperOrLowerNS::UPPER, El::Orientation::NORMAL,
+                 El::Orientation::TRANSPOSE, El::BigFloat(1), base, scaled,
+                 El::BigFloat(0), result);
+      }
+    else
+      {
+        El::Gemm(El::Orientation::NORMAL, El::Orientation::TRANSPOSE,
+                 El::BigFloat(0.5), base, scaled, El::BigFloat(0), result);
+      }
+  }
+}
 
-void constraint_matrix_weighted_sum(const Block_Info &block_info,
-                                    const SDP &sdp, const Block_Vector &a,
-                                    Block_Diagonal_Matrix &result)
+void constraint_matrix_weighted_sum(
+  const Block_Info &block_info, const SDP &sdp, const Block_Vector &a,
+  std::vector<El::DistMatrix<El::BigFloat>> &scaled_bases,
+  Block_Diagonal_Matrix &result)
 {
+  if(scaled_bases.size() != sdp.bilinear_bases_dist.size())
+    {
+      Solver_Allocation_Scope allocation_scope;
+      scaled_bases.clear();
+      scaled_bases.reserve(sdp.bilinear_bases_dist.size());
+      for(auto &base : sdp.bilinear_bases_dist)
+        {
+          scaled_bases.emplace_back(base.Grid());
+          BigFloat_Slab_Scope slab_scope(max_local_elements(
+            base.Height(), base.Width(), base.Grid()));
+          scaled_bases.back().Resize(base.Height(), base.Width());
+        }
+    }
+
   auto a_block(a.blocks.begin());
   auto result_block(result.blocks.begin());
   auto bilinear_bases_block(sdp.bilinear_bases_dist.begin());
+  auto scaled_bases_block(scaled_bases.begin());
 
   for(auto &block_index : block_info.block_indices)
     {
       const size_t block_size(block_info.degrees[block_index] + 1);
       for(size_t parity = 0; parity < 2; ++parity)
         {
-          // TODO: Remove this because it gets zero'd out in Gemm?
-          El::Zero(*result_block);
+          const El::DistMatrix<El::BigFloat> &base(*bilinear_bases_block);
+          const size_t result_block_size(base.Height());
+          const bool is_local(base.Grid().Size() == 1);
+          El::DistMatrix<El::BigFloat> &scaled_base(*scaled_bases_block);
           for(size_t column_block = 0;
               column_block < block_info.dimensions[block_index];
               ++column_block)
             for(size_t row_block = 0; row_block <= column_block; ++row_block)
               {
-                const size_t result_block_size(bilinear_bases_block->Height());
                 const size_t column_offset(column_block * result_block_size),
                   row_offset(row_block * result_block_size);
-                size_t vector_offset(
+                const size_t vector_offset(
                   ((column_block * (column_block + 1)) / 2 + row_block)
                   * block_size);
-                El::DistMatrix<El::BigFloat> sub_vector(
-                  El::LockedView(*a_block, vector_offset, 0, block_size, 1));
-                El::DistMatrix<El::BigFloat> scaled_bases(
-                  *bilinear_bases_block);
-
-                El::DiagonalScale(El::LeftOrRight::RIGHT,
-                                  El::Orientation::NORMAL, sub_vector,
-                                  scaled_bases);
+                scale_columns(base, *a_block, vector_offset, scaled_base);
 
-                El::DistMatrix<El::BigFloat> result_sub_block(
-                  El::View(*result_block, row_offset, column_offset,
-                           result_block_size, result_block_size));
-                El::Gemm(El::Orientation::NORMAL, El::Orientation::TRANSPOSE,
-                         El::BigFloat(column_block == row_block ? 1 : 0.5),
-                         *bilinear_bases_block, scaled_bases, El::BigFloat(0),
-                         result_sub_block);
+                if(is_local)
+                  {
+                    El::Matrix<El::BigFloat> result_sub_block(
+                      El::View(result_block->Matrix(), row_offset,
+                               column_offset, result_block_size,
+                               result_block_size));
+                    sub_block_product(row_block == column_block,
+                                      base.LockedMatrix(),
+                                      scaled_base.LockedMatrix(),
+                                      result_sub_block);
+                  }
+                else
+                  {
+                    El::DistMatrix<El::BigFloat> result_sub_block(
+                      El::View(*result_block, row_offset, column_offset,
+                               result_block_size, result_block_size));
+                    sub_block_product(row_block == column_block, base,
+                                      scaled_base, result_sub_block);
+                  }
               }
-          if(block_info.dimensions[block_index] > 1)
+          if(is_local)
+            {
+              El::MakeSymmetric(El::UpperOrLowerNS::UPPER,
+                                result_block->Matrix());
+            }
+          else
             {
               El::MakeSymmetric(El::UpperOrLowerNS::UPPER, *result_block);
             }
           ++result_block;
           ++bilinear_bases_block;
+          ++scaled_bases_block;
         }
       ++a_block;
     }
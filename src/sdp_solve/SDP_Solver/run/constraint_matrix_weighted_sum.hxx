@@ -2,6 +2,7 @@
 
 #include "../../SDP_Solver.hxx"
 
-void constraint_matrix_weighted_sum(const Block_Info &block_info,
-                                    const SDP &sdp, const Block_Vector &a,
-                                    Block_Diagonal_Matrix &Result);
+void constraint_matrix_weighted_sum(
+  const Block_Info &block_info, const SDP &sdp, const Block_Vector &a,
+  std::vector<El::DistMatrix<El::BigFloat>> &scaled_bases,
+  Block_Diagonal_Matrix &Result);
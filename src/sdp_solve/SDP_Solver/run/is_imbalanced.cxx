@@ -0,0 +1,111 @@
+#include "../../SDP_Solver.hxx"
+#include "../../../compute_block_grid_mapping.hxx"
+
+// Whether the blocks should be moved to new groups of processes.
+//
+// Called after every iteration.  The time for each block is measured
+// with the same timers as in write_timing, and added to
+// block_timings.  The first iteration is skipped, since many
+// quantities are still zero.  Every rebalance_interval iterations
+// after that, block_timings is summed over all processes, which gives
+// the cost of each block as in a block_timings file, and a new
+// mapping is computed from it as in Block_Info::allocate_blocks.
+// The current time of the slowest group is the time of the slowest
+// process.  If that is more than rebalance_threshold times the
+// predicted time of the slowest group in the new mapping, or if
+// rebalance_threshold is at most 1, the result is true, and
+// block_timings holds the average cost per iteration.
+// Otherwise block_timings is reset for the next interval.  With
+// maxMemoryPerNode, the new mapping must also fit in memory, or there
+// is no rebalancing.
+//
+// Every process sees the same sums, so they all agree on the result.
+
+bool is_imbalanced(const SDP_Solver_Parameters &parameters,
+                   const Block_Info &block_info, const size_t &iteration,
+                   const Timers &timers, El::Matrix<int32_t> &block_timings)
+{
+  const size_t num_procs(El::mpi::Size(El::mpi::COMM_WORLD));
+  if(num_procs == 1 || iteration == 1)
+    {
+      return false;
+    }
+  if(block_timings.Height() == 0)
+    {
+      El::Zeros(block_timings, block_info.dimensions.size(), 1);
+    }
+  for(auto &index : block_info.block_indices)
+    {
+      block_timings(index, 0)
+        += timers.elapsed_milliseconds(
+             "run.step.initializeSchurComplementSolver.Q.syrk_"
+             + std::to_string(index))
+           + timers.elapsed_milliseconds(
+             "run.step.initializeSchurComplementSolver.Q.solve_"
+             + std::to_string(index))
+           + timers.elapsed_milliseconds(
+             "run.step.initializeSchurComplementSolver.Q.cholesky_"
+             + std::to_string(index));
+    }
+  if((iteration - 1) % parameters.rebalance_interval != 0)
+    {
+      return false;
+    }
+
+  int32_t local_time(0);
+  for(auto &index : block_info.block_indices)
+    {
+      local_time += block_timings(index, 0);
+    }
+  const int32_t slowest_time(
+    El::mpi::AllReduce(local_time, El::mpi::MAX, El::mpi::COMM_WORLD));
+  El::AllReduce(block_timings, El::mpi::COMM_WORLD);
+
+  std::vector<Block_Cost> block_costs;
+  for(int64_t block = 0; block < block_timings.Height(); ++block)
+    {
+      block_costs.emplace_back(block_timings(block, 0), block);
+    }
+  std::sort(block_costs.rbegin(), block_costs.rend());
+  std::vector<std::vector<Block_Map>> mapping(compute_block_grid_mapping(
+    parameters.procs_per_node / parameters.proc_granularity,
+    num_procs / parameters.procs_per_node, block_costs));
+  const bool is_fit(
+    parameters.max_memory_per_node == 0
+    || fit_block_grid_mapping_memory(
+      block_costs, block_info.block_memory, block_info.group_memory,
+      block_info.proc_memory * parameters.proc_granularity,
+      parameters.max_memory_per_node, mapping));
+  for(auto &block_vector : mapping)
+    for(auto &block_map : block_vector)
+      {
+        block_map.num_procs *= parameters.proc_granularity;
+      }
+  double makespan, ideal;
+  block_grid_mapping_makespan(mapping, makespan, ideal);
+
+  const bool result(is_fit
+                    && (parameters.rebalance_threshold <= 1
+                        || slowest_time
+                             > parameters.rebalance_threshold * makespan));
+  if(result)
+    {
+      for(int64_t block = 0; block < block_timings.Height(); ++block)
+        {
+          block_timings(block, 0) /= parameters.rebalance_interval;
+        }
+      if(parameters.verbosity >= Verbosity::regular && El::mpi::Rank() == 0)
+        {
+          std::cout << "Rebalancing blocks: over the last "
+                    << parameters.rebalance_interval
+                    << " iterations, the slowest group took " << slowest_time
+                    << " ms, but would take " << makespan
+                    << " ms with a new mapping.\n";
+        }
+    }
+  else
+    {
+      El::Zero(block_timings);
+    }
+  return result;
+}
@@ -0,0 +1,43 @@
+#include "../../Block_Diagonal_Matrix.hxx"
+
+// This rank's contribution to Tr(A B), where A and B are symmetric.
+// Only the lower triangles are read: the off-diagonal products are
+// counted twice.  Every element lives on exactly one rank, so summing
+// the local contributions over all ranks does not double count
+// blocks that are distributed over more than one rank.  There is no
+// communication.
+El::BigFloat
+local_frobenius_product_symmetric(const Block_Diagonal_Matrix &A,
+                                  const Block_Diagonal_Matrix &B)
+{
+  El::BigFloat local_sum(0), product;
+  for(size_t b = 0; b < A.blocks.size(); b++)
+    {
+      const El::Matrix<El::BigFloat> &A_local(A.blocks[b].LockedMatrix()),
+        &B_local(B.blocks[b].LockedMatrix());
+      for(int64_t local_column = 0; local_column < A_local.Width();
+          ++local_column)
+        {
+          const int64_t column(A.blocks[b].GlobalCol(local_column));
+          for(int64_t local_row = 0; local_row < A_local.Height();
+              ++local_row)
+            {
+              const int64_t row(A.blocks[b].GlobalRow(local_row));
+              if(row < column)
+                {
+                  continue;
+                }
+              mpf_mul(product.gmp_float.get_mpf_t(),
+                      A_local(local_row, local_column).gmp_float.get_mpf_t(),
+                      B_local(local_row, local_column).gmp_float.get_mpf_t());
+              if(row != column)
+                {
+                  mpf_mul_2exp(product.gmp_float.get_mpf_t(),
+                               product.gmp_float.get_mpf_t(), 1);
+                }
+              local_sum += product;
+            }
+        }
+    }
+  return local_sum;
+}
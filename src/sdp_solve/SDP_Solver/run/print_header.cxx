@@ -2,14 +2,30 @@
 
 #include <iostream>
 
-void print_header(const Verbosity &verbosity)
+// If the Schur complement solver is factored at a lower precision,
+// there are also columns for the number of refinement steps and the
+// final relative residue.  If the precision is adaptive, there is a
+// column for the working precision.  If the residues are updated
+// incrementally, there are columns for the drift of the primal and
+// dual residues, as of the last time they were recomputed.
+void print_header(const Verbosity &verbosity, const bool &is_mixed_precision,
+                  const bool &is_adaptive_precision,
+                  const bool &is_incremental_residues)
 {
   if(verbosity >= Verbosity::regular && El::mpi::Rank() == 0)
     {
       std::cout << "\n"
                 << "          time    mu     P-obj       D-obj      gap     "
-                   "    P-err       p-err       D-err      P-step   D-step   beta\n"
+                   "    P-err       p-err       D-err      P-step   D-step   beta"
+                << (is_mixed_precision ? "  refine  S-res" : "")
+                << (is_adaptive_precision ? "     prec" : "")
+                << (is_incremental_residues ? "  P-drift  D-drift" : "")
+                << "\n"
                 << "--------------------------------------------------------"
-                   "-------------------------------------------------------------\n";
+                   "-------------------------------------------------------------"
+                << (is_mixed_precision ? "---------------" : "")
+                << (is_adaptive_precision ? "---------" : "")
+                << (is_incremental_residues ? "-------------------" : "")
+                << "\n";
     }
 }
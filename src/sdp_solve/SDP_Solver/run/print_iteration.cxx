@@ -10,7 +10,8 @@ void print_iteration(
   const El::BigFloat &beta_corrector, const SDP_Solver &sdp_solver,
   const std::chrono::time_point<std::chrono::high_resolution_clock>
   &solver_start_time,
-                     const Verbosity &verbosity)
+  const bool &is_mixed_precision, const bool &is_adaptive_precision,
+  const bool &is_incremental_residues, const Verbosity &verbosity)
 {
   if(verbosity >= Verbosity::regular && El::mpi::Rank() == 0)
     {
@@ -50,8 +51,27 @@ void print_iteration(
                 << static_cast<double>(dual_step_length) << " "
 
                 << std::setw(4) << std::setprecision(3)
-                << static_cast<double>(beta_corrector) << "\n"
-
-                << std::flush;
+                << static_cast<double>(beta_corrector);
+      if(is_mixed_precision)
+        {
+          std::cout << "  " << std::right << std::setw(6)
+                    << sdp_solver.num_schur_refinements << "  " << std::left
+                    << std::setw(8) << std::setprecision(2)
+                    << static_cast<double>(sdp_solver.schur_residue);
+        }
+      if(is_adaptive_precision)
+        {
+          std::cout << "  " << std::right << std::setw(7)
+                    << mpf_get_default_prec();
+        }
+      if(is_incremental_residues)
+        {
+          std::cout << "  " << std::left << std::setw(8)
+                    << std::setprecision(2)
+                    << static_cast<double>(sdp_solver.primal_residue_drift)
+                    << " " << std::setw(8) << std::setprecision(2)
+                    << static_cast<double>(sdp_solver.dual_residue_drift);
+        }
+      std::cout << "\n" << std::flush;
     }
 }
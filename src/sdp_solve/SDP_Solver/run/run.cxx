@@ -1,27 +1,60 @@
 #include "../../SDP_Solver.hxx"
+#include "../../Cholesky_Inverse.hxx"
+#include "../../Scalar_Reductions.hxx"
+#include "../../round_to_precision.hxx"
 
 // The main solver loop
 
 void cholesky_decomposition(const Block_Diagonal_Matrix &A,
                             Block_Diagonal_Matrix &L);
 
-void print_header(const Verbosity &verbosity);
+void print_header(const Verbosity &verbosity, const bool &is_mixed_precision,
+                  const bool &is_adaptive_precision,
+                  const bool &is_incremental_residues);
 void print_iteration(
   const int &iteration, const El::BigFloat &mu,
   const El::BigFloat &primal_step_length, const El::BigFloat &dual_step_length,
   const El::BigFloat &beta_corrector, const SDP_Solver &sdp_solver,
   const std::chrono::time_point<std::chrono::high_resolution_clock>
     &solver_start_time,
-  const Verbosity &verbosity);
+  const bool &is_mixed_precision, const bool &is_adaptive_precision,
+  const bool &is_incremental_residues, const Verbosity &verbosity);
+
+size_t scheduled_precision(const SDP_Solver_Parameters &parameters,
+                           const El::BigFloat &duality_gap,
+                           const El::BigFloat &primal_error,
+                           const El::BigFloat &dual_error);
+
+void set_working_precision(
+  const size_t &precision, const size_t &schur_precision,
+  SDP_Solver &solver, Block_Diagonal_Matrix &X_cholesky,
+  Cholesky_Inverse &X_cholesky_inverse, Block_Diagonal_Matrix &Y_cholesky,
+  Block_Diagonal_Matrix &bilinear_pairings_X_inv,
+  Block_Diagonal_Matrix &bilinear_pairings_Y,
+  std::vector<El::DistMatrix<El::BigFloat>> &bilinear_pairings_workspace);
 
 void compute_objectives(const SDP &sdp, const Block_Vector &x,
                         const Block_Vector &y, El::BigFloat &primal_objective,
                         El::BigFloat &dual_objective,
-                        El::BigFloat &duality_gap, Timers &timers);
+                        Scalar_Reductions &reductions, Timers &timers);
+
+void finish_objectives(const SDP &sdp, El::BigFloat &primal_objective,
+                       El::BigFloat &dual_objective,
+                       El::BigFloat &duality_gap);
+
+// This rank's contribution to Tr(A B), where A and B are symmetric
+El::BigFloat
+local_frobenius_product_symmetric(const Block_Diagonal_Matrix &A,
+                                  const Block_Diagonal_Matrix &B);
 
 void compute_bilinear_pairings(
-  const Block_Diagonal_Matrix &X_cholesky, const Block_Diagonal_Matrix &Y,
-  const std::vector<El::Matrix<El::BigFloat>> &bilinear_bases,
+  const Block_Diagonal_Matrix &X_cholesky,
+  const Cholesky_Inverse &X_cholesky_inverse, const Block_Diagonal_Matrix &Y,
+  const Block_Diagonal_Matrix &Y_cholesky,
+  const std::vector<El::Matrix<El::BigFloat>> &bilinear_bases_local,
+  const std::vector<El::DistMatrix<El::BigFloat>> &bilinear_bases_dist,
+  const Bilinear_Pairings_Y_Method &bilinear_pairings_Y_method,
+  const Multiply_Backend &multiply_backend, Thread_Pool &thread_pool,
   std::vector<El::DistMatrix<El::BigFloat>> &workspace,
   Block_Diagonal_Matrix &bilinear_pairings_X_inv,
   Block_Diagonal_Matrix &bilinear_pairings_Y, Timers &timers);
@@ -39,18 +72,39 @@ void compute_feasible_and_termination(
 void compute_dual_residues_and_error(
   const Block_Info &block_info, const SDP &sdp, const Block_Vector &y,
   const Block_Diagonal_Matrix &bilinear_pairings_Y,
-  Block_Vector &dual_residues, El::BigFloat &dual_error, Timers &timers);
+  Block_Vector &dual_residues, El::BigFloat &dual_error,
+  Scalar_Reductions &reductions, Timers &timers);
 
 void compute_primal_residues_and_error_P_Ax_X(
   const Block_Info &block_info, const SDP &sdp, const Block_Vector &x,
-  const Block_Diagonal_Matrix &X, Block_Diagonal_Matrix &primal_residues,
-  El::BigFloat &primal_error_P, Timers &timers);
+  const Block_Diagonal_Matrix &X,
+  std::vector<El::DistMatrix<El::BigFloat>> &scaled_bases,
+  Block_Diagonal_Matrix &primal_residues, El::BigFloat &primal_error_P,
+  Scalar_Reductions &reductions, Timers &timers);
+
+void update_residues(const El::BigFloat &primal_step_length,
+                     const El::BigFloat &dual_step_length,
+                     Block_Diagonal_Matrix &primal_residues,
+                     Block_Vector &dual_residues);
+
+void compute_residue_drift(const Block_Diagonal_Matrix &primal_residues,
+                           const Block_Vector &dual_residues,
+                           Block_Diagonal_Matrix &primal_updated,
+                           Block_Vector &dual_updated,
+                           El::BigFloat &primal_drift,
+                           El::BigFloat &dual_drift,
+                           Scalar_Reductions &reductions);
+
+bool is_imbalanced(const SDP_Solver_Parameters &parameters,
+                   const Block_Info &block_info, const size_t &iteration,
+                   const Timers &timers, El::Matrix<int32_t> &block_timings);
 
 void compute_primal_residues_and_error_p_b_Bx(const Block_Info &block_info,
                                               const SDP &sdp,
                                               const Block_Vector &x,
                                               Block_Vector &primal_residue_p,
-                                              El::BigFloat &primal_error_p);
+                                              El::BigFloat &primal_error_p,
+                                              Scalar_Reductions &reductions);
 
 SDP_Solver_Terminate_Reason
 SDP_Solver::run(const SDP_Solver_Parameters &parameters,
@@ -64,8 +118,21 @@ SDP_Solver::run(const SDP_Solver_Parameters &parameters,
 
   El::BigFloat primal_step_length(0), dual_step_length(0);
 
+  // Worker threads for the local BigFloat loops
+  Thread_Pool thread_pool(parameters.num_threads);
+
+  // The objectives, errors and mu each need a sum or maximum over all
+  // ranks.  They are collected here and reduced together, once per
+  // iteration.
+  Scalar_Reductions reductions;
+
   Block_Diagonal_Matrix X_cholesky(X), Y_cholesky(X);
 
+  // L^{-1} for the blocks of X_cholesky, if
+  // parameters.cache_cholesky_inverse is set.  See Cholesky_Inverse.hxx.
+  Cholesky_Inverse X_cholesky_inverse(X_cholesky,
+                                      parameters.cache_cholesky_inverse);
+
   // Bilinear pairings needed for computing the Schur complement
   // matrix.  For example,
   //
@@ -93,7 +160,8 @@ SDP_Solver::run(const SDP_Solver_Parameters &parameters,
 
   Block_Diagonal_Matrix bilinear_pairings_Y(bilinear_pairings_X_inv);
 
-  // Additional workspace variables used in step_length()
+  // Scratch space for compute_bilinear_pairings, the same shape as
+  // 1 \otimes bilinear_bases
   std::vector<El::DistMatrix<El::BigFloat>> bilinear_pairings_workspace;
   bilinear_pairings_workspace.reserve(X.blocks.size());
   {
@@ -105,16 +173,42 @@ SDP_Solver::run(const SDP_Solver_Parameters &parameters,
         ++bilinear_pairings_X_inv_block;
       }
   }
-  print_header(parameters.verbosity);
+  print_header(parameters.verbosity, parameters.is_mixed_precision(),
+               parameters.is_adaptive_precision(),
+               parameters.is_incremental_residues());
+
+  // With an adaptive precision, sdp stays at parameters.precision,
+  // and the iterations use working_sdp, which points either to sdp or
+  // to rounded_sdp, a copy rounded to the working precision.
+  // Everything starts out at parameters.precision.  The first
+  // iteration may lower the precision, for example when starting from
+  // scratch, and later iterations only raise it.
+  const size_t schur_precision(
+    parameters.is_mixed_precision() ? parameters.schur_precision : 0);
+  size_t working_precision(parameters.precision);
+  boost::optional<SDP> rounded_sdp;
+  const SDP *working_sdp(&sdp);
 
   std::size_t total_psd_rows(
     std::accumulate(block_info.psd_matrix_block_sizes.begin(),
                     block_info.psd_matrix_block_sizes.end(), size_t(0)));
 
+  // Count GMP allocations so that we can check that the workspace
+  // is being reused.  Elemental allocates temporaries inside most
+  // routines, so the total is never zero.  The allocations made where
+  // the solver sets up its own matrices (see Solver_Allocation_Scope)
+  // should all happen in the first iteration.
+  if(parameters.verbosity >= Verbosity::debug)
+    {
+      install_gmp_memory_functions();
+    }
+
   initialize_timer.stop();
   auto last_checkpoint_time(std::chrono::high_resolution_clock::now());
   for(size_t iteration = 1;; ++iteration)
     {
+      const size_t allocations_start(gmp_allocation_count()),
+        solver_allocations_start(solver_allocation_count());
       El::byte checkpoint_now(
         std::chrono::duration_cast<std::chrono::seconds>(
           std::chrono::high_resolution_clock::now() - last_checkpoint_time)
@@ -128,29 +222,89 @@ SDP_Solver::run(const SDP_Solver_Parameters &parameters,
           last_checkpoint_time = std::chrono::high_resolution_clock::now();
         }
 
-      compute_objectives(sdp, x, y, primal_objective, dual_objective,
-                         duality_gap, timers);
+      compute_objectives(*working_sdp, x, y, primal_objective, dual_objective,
+                         reductions, timers);
 
       auto &cholesky_decomposition_timer(
         timers.add_and_start("run.choleskyDecomposition"));
       cholesky_decomposition(X, X_cholesky);
       cholesky_decomposition(Y, Y_cholesky);
       cholesky_decomposition_timer.stop();
+      if(parameters.cache_cholesky_inverse)
+        {
+          auto &cholesky_inverse_timer(
+            timers.add_and_start("run.choleskyInverse"));
+          X_cholesky_inverse.compute(X_cholesky, thread_pool);
+          cholesky_inverse_timer.stop();
+        }
 
       compute_bilinear_pairings(
-        X_cholesky, Y, sdp.bilinear_bases_local, bilinear_pairings_workspace,
-        bilinear_pairings_X_inv, bilinear_pairings_Y, timers);
+        X_cholesky, X_cholesky_inverse, Y, Y_cholesky,
+        working_sdp->bilinear_bases_local, working_sdp->bilinear_bases_dist,
+        parameters.bilinear_pairings_Y_method, parameters.multiply_backend,
+        thread_pool, bilinear_pairings_workspace, bilinear_pairings_X_inv,
+        bilinear_pairings_Y, timers);
 
-      compute_dual_residues_and_error(block_info, sdp, y, bilinear_pairings_Y,
-                                      dual_residues, dual_error, timers);
-      compute_primal_residues_and_error_P_Ax_X(
-        block_info, sdp, x, X, primal_residues, primal_error_P, timers);
+      // With incremental residues, primal_residues and dual_residues
+      // were updated after the last step, and are only recomputed
+      // every residue_recompute_interval iterations.  When they are,
+      // the updated ones are kept in workspace.Z and workspace.dx,
+      // which are not needed until the search direction, to measure
+      // the drift.
+      const bool recompute_residues(
+        !parameters.is_incremental_residues()
+        || (iteration - 1) % parameters.residue_recompute_interval == 0),
+        check_drift(parameters.is_incremental_residues()
+                    && recompute_residues && iteration > 1);
+      if(check_drift)
+        {
+          Solver_Allocation_Scope allocation_scope;
+          workspace.Z = primal_residues;
+          workspace.dx = dual_residues;
+        }
+      if(recompute_residues)
+        {
+          compute_dual_residues_and_error(block_info, *working_sdp, y,
+                                          bilinear_pairings_Y, dual_residues,
+                                          dual_error, reductions, timers);
+          compute_primal_residues_and_error_P_Ax_X(
+            block_info, *working_sdp, x, X, workspace.scaled_bases,
+            primal_residues, primal_error_P, reductions, timers);
+        }
+      else
+        {
+          dual_error = dual_residues.local_max_abs();
+          reductions.add_max(dual_error);
+          primal_error_P = primal_residues.local_symmetric_max_abs();
+          reductions.add_max(primal_error_P);
+        }
+      if(check_drift)
+        {
+          compute_residue_drift(primal_residues, dual_residues, workspace.Z,
+                                workspace.dx, primal_residue_drift,
+                                dual_residue_drift, reductions);
+        }
 
-      // use y to set the sizes of primal_residue_p.  The data is
-      // overwritten in compute_primal_residues_and_error_p.
-      Block_Vector primal_residue_p(y);
-      compute_primal_residues_and_error_p_b_Bx(
-        block_info, sdp, x, primal_residue_p, primal_error_p);
+      // The data in primal_residue_p is overwritten in
+      // compute_primal_residues_and_error_p.
+      Block_Vector &primal_residue_p(workspace.primal_residue_p);
+      compute_primal_residues_and_error_p_b_Bx(block_info, *working_sdp, x,
+                                               primal_residue_p,
+                                               primal_error_p, reductions);
+
+      // Compute the complementarity mu = Tr(X Y)/X.dim
+      auto &frobenius_timer(
+        timers.add_and_start("run.frobenius_product_symmetric"));
+      El::BigFloat mu(local_frobenius_product_symmetric(X, Y));
+      reductions.add_sum(mu);
+      frobenius_timer.stop();
+
+      auto &reduce_timer(timers.add_and_start("run.reduceScalars"));
+      reductions.reduce();
+      reduce_timer.stop();
+      mu /= total_psd_rows;
+      finish_objectives(*working_sdp, primal_objective, dual_objective,
+                        duality_gap);
 
       bool terminate_now, is_primal_and_dual_feasible;
       compute_feasible_and_termination(
@@ -163,20 +317,93 @@ SDP_Solver::run(const SDP_Solver_Parameters &parameters,
           break;
         }
 
-      El::BigFloat mu, beta_corrector;
+      if(parameters.is_adaptive_precision())
+        {
+          const size_t precision(
+            iteration == 1
+              ? scheduled_precision(parameters, duality_gap, primal_error(),
+                                    dual_error)
+              : std::max(working_precision,
+                         scheduled_precision(parameters, duality_gap,
+                                             primal_error(), dual_error)));
+          if(precision != working_precision)
+            {
+              auto &precision_timer(
+                timers.add_and_start("run.setWorkingPrecision"));
+              working_precision = precision;
+              set_working_precision(working_precision, schur_precision,
+                                    *this, X_cholesky, X_cholesky_inverse,
+                                    Y_cholesky,
+                                    bilinear_pairings_X_inv,
+                                    bilinear_pairings_Y,
+                                    bilinear_pairings_workspace);
+              round_to_precision(mu);
+              if(working_precision == parameters.precision)
+                {
+                  working_sdp = &sdp;
+                  rounded_sdp = boost::none;
+                }
+              else
+                {
+                  if(!rounded_sdp)
+                    {
+                      rounded_sdp.emplace(sdp);
+                    }
+                  copy_rounded(sdp, *rounded_sdp);
+                  working_sdp = &(*rounded_sdp);
+                }
+              precision_timer.stop();
+            }
+        }
+
+      El::BigFloat beta_corrector;
       step(parameters, total_psd_rows, is_primal_and_dual_feasible, block_info,
-           sdp, grid, X_cholesky, Y_cholesky, bilinear_pairings_X_inv,
-           bilinear_pairings_Y, primal_residue_p, mu, beta_corrector,
-           primal_step_length, dual_step_length, terminate_now, timers);
+           *working_sdp, thread_pool, X_cholesky, X_cholesky_inverse,
+           Y_cholesky, bilinear_pairings_X_inv, bilinear_pairings_Y,
+           primal_residue_p, mu, beta_corrector, primal_step_length,
+           dual_step_length, terminate_now, timers);
       if(terminate_now)
         {
           terminate_reason
             = SDP_Solver_Terminate_Reason::MaxComplementarityExceeded;
           break;
         }
+      if(parameters.is_incremental_residues())
+        {
+          update_residues(primal_step_length, dual_step_length,
+                          primal_residues, dual_residues);
+        }
       print_iteration(iteration, mu, primal_step_length, dual_step_length,
                       beta_corrector, *this, solver_timer.start_time,
+                      parameters.is_mixed_precision(),
+                      parameters.is_adaptive_precision(),
+                      parameters.is_incremental_residues(),
                       parameters.verbosity);
+      if(parameters.verbosity >= Verbosity::debug)
+        {
+          El::Output(El::mpi::Rank(), " iteration ", iteration,
+                     " GMP allocations: ",
+                     gmp_allocation_count() - allocations_start,
+                     " solver-owned: ",
+                     solver_allocation_count() - solver_allocations_start);
+        }
+      timers.finish_block_iteration(iteration > 1);
+      if(parameters.is_rebalancing()
+         && is_imbalanced(parameters, block_info, iteration, timers,
+                          block_timings))
+        {
+          num_iterations = iteration;
+          terminate_reason = SDP_Solver_Terminate_Reason::RebalanceBlocks;
+          break;
+        }
+    }
+  // Leave the solution at the full precision.
+  if(working_precision != parameters.precision)
+    {
+      set_working_precision(parameters.precision, schur_precision, *this,
+                            X_cholesky, X_cholesky_inverse, Y_cholesky,
+                            bilinear_pairings_X_inv, bilinear_pairings_Y,
+                            bilinear_pairings_workspace);
     }
   solver_timer.stop();
   return terminate_reason;
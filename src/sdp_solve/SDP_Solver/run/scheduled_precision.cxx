@@ -0,0 +1,39 @@
+#include "../../SDP_Solver_Parameters.hxx"
+
+// The working precision for the next step when the precision is
+// adaptive.
+//
+// Let e = max(duality gap, primal error, dual error).  Far from
+// convergence, e is O(1) and parameters.initial_precision is enough.
+// As the solver converges, X and Y become more and more ill
+// conditioned, and the Schur complement picks up about two bits of
+// condition number for every bit that e decreases.  So the working
+// precision is
+//
+//   initial_precision + 2 log2(1/e),
+//
+// rounded up to a whole number of 64 bit limbs, since GMP does not
+// store anything in between, and capped at parameters.precision.
+
+size_t scheduled_precision(const SDP_Solver_Parameters &parameters,
+                           const El::BigFloat &duality_gap,
+                           const El::BigFloat &primal_error,
+                           const El::BigFloat &dual_error)
+{
+  const El::BigFloat error(
+    El::Max(El::Abs(duality_gap), El::Max(primal_error, dual_error)));
+  if(error == 0)
+    {
+      return parameters.precision;
+    }
+
+  // error = mantissa * 2^exponent, with 0.5 <= mantissa < 1
+  long exponent;
+  mpf_get_d_2exp(&exponent, error.gmp_float.get_mpf_t());
+  const size_t lost_bits(exponent < 0 ? 2 * size_t(-exponent) : 0),
+    limb_bits(64);
+  const size_t result(
+    ((parameters.initial_precision + lost_bits + limb_bits - 1) / limb_bits)
+    * limb_bits);
+  return std::min(result, parameters.precision);
+}
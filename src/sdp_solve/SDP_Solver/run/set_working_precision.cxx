@@ -0,0 +1,46 @@
+#include "../../SDP_Solver.hxx"
+#include "../../Cholesky_Inverse.hxx"
+#include "../../round_to_precision.hxx"
+
+// Change the working precision to precision, and round everything in
+// the solver that lives from one iteration to the next to it: the
+// iterates x, X, y, Y, the residues, objectives and errors, the
+// workspace, and the temporaries that SDP_Solver::run() keeps
+// outside of the solver.  The members of the workspace at
+// schur_precision are left alone if that is nonzero.  The SDP is
+// handled separately by SDP_Solver::run().
+
+void set_working_precision(
+  const size_t &precision, const size_t &schur_precision,
+  SDP_Solver &solver, Block_Diagonal_Matrix &X_cholesky,
+  Cholesky_Inverse &X_cholesky_inverse, Block_Diagonal_Matrix &Y_cholesky,
+  Block_Diagonal_Matrix &bilinear_pairings_X_inv,
+  Block_Diagonal_Matrix &bilinear_pairings_Y,
+  std::vector<El::DistMatrix<El::BigFloat>> &bilinear_pairings_workspace)
+{
+  El::gmp::SetPrecision(precision);
+
+  for(auto *v : {&solver.x, &solver.y, &solver.dual_residues})
+    {
+      round_to_precision(*v);
+    }
+  for(auto *A :
+      {&solver.X, &solver.Y, &solver.primal_residues, &X_cholesky,
+       &Y_cholesky, &bilinear_pairings_X_inv, &bilinear_pairings_Y})
+    {
+      round_to_precision(*A);
+    }
+  round_to_precision(X_cholesky_inverse.blocks);
+  round_to_precision(bilinear_pairings_workspace);
+
+  for(auto *number :
+      {&solver.primal_objective, &solver.dual_objective,
+       &solver.duality_gap, &solver.primal_error_P, &solver.primal_error_p,
+       &solver.dual_error, &solver.schur_residue,
+       &solver.primal_residue_drift, &solver.dual_residue_drift})
+    {
+      round_to_precision(*number);
+    }
+
+  solver.workspace.round_to_working_precision(schur_precision);
+}
@@ -1,4 +1,6 @@
+#include "search_direction_blocks.hxx"
 #include "../../constraint_matrix_weighted_sum.hxx"
+#include "../../../../Thread_Pool.hxx"
 #include "../../../../../Timers.hxx"
 
 // Compute the search direction (dx, dX, dy, dY) for the predictor and
@@ -9,29 +11,28 @@
 // - mu = Tr(X Y) / X.cols
 // - correctorPhase: boolean indicating whether we're in the corrector
 //   phase or predictor phase.
-// Workspace (members of SDPSolver which are modified in-place but not
-// used elsewhere):
-// - Z, R
+// - schur_precision: if nonzero, the precision of the factors of the
+//   Schur complement solver, which means the solution is refined
+//   with schur_complement (see solve_schur_complement_refined)
+// - X_cholesky_inverse: L^{-1} for the blocks of X_cholesky where it
+//   is cached, used instead of triangular solves with X_cholesky
+// Workspace (members of SDP_Solver_Workspace which are modified
+// in-place but not used elsewhere):
+// - Z
+// - scaled_bases (see constraint_matrix_weighted_sum)
+// - work, with the same structure as X
+// - R, which holds -X Y from the predictor phase to the corrector
+//   phase, so that X Y is only computed once per iteration
+// - schur_rhs_*, schur_residue_*, schur_correction_*
 // Outputs (members of SDPSolver which are modified in-place):
 // - dx, dX, dy, dY
+// - num_schur_refinements, schur_residue: the number of refinement
+//   steps and the final relative residue, if schur_precision is
+//   nonzero
 //
-
-// C := alpha*A*B + beta*C
-void scale_multiply_add(const El::BigFloat &alpha,
-                        const Block_Diagonal_Matrix &A,
-                        const Block_Diagonal_Matrix &B,
-                        const El::BigFloat &beta, Block_Diagonal_Matrix &C);
-
-// C := A B
-inline void multiply(const Block_Diagonal_Matrix &A,
-                     const Block_Diagonal_Matrix &B, Block_Diagonal_Matrix &C)
-{
-  scale_multiply_add(El::BigFloat(1), A, B, El::BigFloat(0), C);
-}
-
-// X := ACholesky^{-T} ACholesky^{-1} X = A^{-1} X
-void cholesky_solve(const Block_Diagonal_Matrix &ACholesky,
-                    Block_Diagonal_Matrix &X);
+// The dense work on X, Y, dX and dY is done a block at a time (see
+// search_direction_blocks.hxx).  Blocks that live on a single rank
+// are spread over the threads in thread_pool.
 
 void compute_schur_RHS(const Block_Info &block_info, const SDP &sdp,
                        const Block_Vector &dual_residues,
@@ -43,51 +44,115 @@ void solve_schur_complement_equation(
   const Block_Matrix &schur_off_diagonal,
   const El::DistMatrix<El::BigFloat> &Q, Block_Vector &dx, Block_Vector &dy);
 
+void solve_schur_complement_refined(
+  const SDP &sdp, const Block_Diagonal_Matrix &schur_complement,
+  const Block_Diagonal_Matrix &schur_complement_cholesky,
+  const Block_Matrix &schur_off_diagonal,
+  const El::DistMatrix<El::BigFloat> &Q, const size_t &schur_precision,
+  const size_t &max_refinements, Block_Vector &rhs_dx, Block_Vector &rhs_dy,
+  Block_Vector &residue_dx, Block_Vector &residue_dy,
+  Block_Vector &correction_dx, Block_Vector &correction_dy, Block_Vector &dx,
+  Block_Vector &dy, size_t &num_refinements, El::BigFloat &relative_residue);
+
 void compute_search_direction(
   const Block_Info &block_info, const SDP &sdp, const SDP_Solver &solver,
   const Block_Diagonal_Matrix &schur_complement_cholesky,
   const Block_Matrix &schur_off_diagonal,
-  const Block_Diagonal_Matrix &X_cholesky, const El::BigFloat beta,
+  const Block_Diagonal_Matrix &X_cholesky,
+  const Cholesky_Inverse &X_cholesky_inverse, const El::BigFloat beta,
   const El::BigFloat &mu, const Block_Vector &primal_residue_p,
-  const bool &is_corrector_phase,
-  const El::DistMatrix<El::BigFloat> &Q, Block_Vector &dx,
-  Block_Diagonal_Matrix &dX, Block_Vector &dy, Block_Diagonal_Matrix &dY)
+  const bool &is_corrector_phase, const Multiply_Backend &multiply_backend,
+  Thread_Pool &thread_pool, const El::DistMatrix<El::BigFloat> &Q,
+  const Block_Diagonal_Matrix &schur_complement,
+  const size_t &schur_precision, const size_t &max_schur_refinements,
+  Block_Diagonal_Matrix &work, Block_Diagonal_Matrix &R,
+  Block_Diagonal_Matrix &Z,
+  std::vector<El::DistMatrix<El::BigFloat>> &scaled_bases,
+  Block_Vector &schur_rhs_dx, Block_Vector &schur_rhs_dy,
+  Block_Vector &schur_residue_dx, Block_Vector &schur_residue_dy,
+  Block_Vector &schur_correction_dx, Block_Vector &schur_correction_dy,
+  Block_Vector &dx, Block_Diagonal_Matrix &dX, Block_Vector &dy,
+  Block_Diagonal_Matrix &dY, size_t &num_schur_refinements,
+  El::BigFloat &schur_residue)
 {
-  // R = beta mu I - X Y (predictor phase)
-  // R = beta mu I - X Y - dX dY (corrector phase)
-  Block_Diagonal_Matrix R(solver.X);
-
-  scale_multiply_add(El::BigFloat(-1), solver.X, solver.Y, El::BigFloat(0), R);
-  if(is_corrector_phase)
+  const El::BigFloat beta_mu(beta * mu);
+  std::vector<size_t> local_blocks, distributed_blocks;
+  for(size_t block = 0; block < dX.blocks.size(); ++block)
     {
-      scale_multiply_add(El::BigFloat(-1), dX, dY, El::BigFloat(1), R);
+      (dX.blocks[block].Grid().Size() == 1 ? local_blocks : distributed_blocks)
+        .push_back(block);
     }
-  R.add_diagonal(beta * mu);
 
+  // R = beta mu I - X Y (predictor phase)
+  // R = beta mu I - X Y - dX dY (corrector phase)
   // Z = Symmetrize(X^{-1} (PrimalResidues Y - R))
-  Block_Diagonal_Matrix Z(solver.X);
-  multiply(solver.primal_residues, solver.Y, Z);
-  Z -= R;
-  cholesky_solve(X_cholesky, Z);
-  Z.symmetrize();
+  thread_pool.parallel_for(
+    local_blocks.size(), [&](const size_t &index, const size_t &) {
+      const size_t block(local_blocks[index]);
+      R_and_Z_block(is_corrector_phase,
+                    solver.X.blocks[block].LockedMatrix(),
+                    solver.Y.blocks[block].LockedMatrix(),
+                    X_cholesky.blocks[block].LockedMatrix(),
+                    X_cholesky_inverse.local_block(block),
+                    solver.primal_residues.blocks[block].LockedMatrix(),
+                    dX.blocks[block].LockedMatrix(),
+                    dY.blocks[block].LockedMatrix(), beta_mu,
+                    multiply_backend, work.blocks[block].Matrix(),
+                    R.blocks[block].Matrix(), Z.blocks[block].Matrix());
+    });
+  for(auto &block : distributed_blocks)
+    {
+      R_and_Z_block(is_corrector_phase, solver.X.blocks[block],
+                    solver.Y.blocks[block], X_cholesky.blocks[block],
+                    X_cholesky_inverse.block(block),
+                    solver.primal_residues.blocks[block], dX.blocks[block],
+                    dY.blocks[block], beta_mu, multiply_backend,
+                    work.blocks[block], R.blocks[block], Z.blocks[block]);
+    }
 
   // dx[p] = -dual_residues[p] - Tr(A_p Z)
   // dy[n] = dualObjective[n] - (FreeVarMatrix^T x)_n
   compute_schur_RHS(block_info, sdp, solver.dual_residues, Z, dx);
-  dy=primal_residue_p;
+  {
+    Solver_Allocation_Scope allocation_scope;
+    dy = primal_residue_p;
+  }
 
   // Solve for dx, dy in-place
-  solve_schur_complement_equation(schur_complement_cholesky,
-                                  schur_off_diagonal, Q, dx, dy);
+  if(schur_precision == 0)
+    {
+      solve_schur_complement_equation(schur_complement_cholesky,
+                                      schur_off_diagonal, Q, dx, dy);
+    }
+  else
+    {
+      solve_schur_complement_refined(
+        sdp, schur_complement, schur_complement_cholesky, schur_off_diagonal,
+        Q, schur_precision, max_schur_refinements, schur_rhs_dx, schur_rhs_dy,
+        schur_residue_dx, schur_residue_dy, schur_correction_dx,
+        schur_correction_dy, dx, dy, num_schur_refinements, schur_residue);
+    }
 
   // dX = PrimalResidues + \sum_p A_p dx[p]
-  constraint_matrix_weighted_sum(block_info, sdp, dx, dX);
+  constraint_matrix_weighted_sum(block_info, sdp, dx, scaled_bases, dX);
   dX += solver.primal_residues;
 
   // dY = Symmetrize(X^{-1} (R - dX Y))
-  multiply(dX, solver.Y, dY);
-  dY -= R;
-  cholesky_solve(X_cholesky, dY);
-  dY.symmetrize();
-  dY *= El::BigFloat(-1);
+  thread_pool.parallel_for(
+    local_blocks.size(), [&](const size_t &index, const size_t &) {
+      const size_t block(local_blocks[index]);
+      dY_block(solver.Y.blocks[block].LockedMatrix(),
+               X_cholesky.blocks[block].LockedMatrix(),
+               X_cholesky_inverse.local_block(block),
+               R.blocks[block].LockedMatrix(),
+               dX.blocks[block].LockedMatrix(), beta_mu, multiply_backend,
+               work.blocks[block].Matrix(), dY.blocks[block].Matrix());
+    });
+  for(auto &block : distributed_blocks)
+    {
+      dY_block(solver.Y.blocks[block], X_cholesky.blocks[block],
+               X_cholesky_inverse.block(block), R.blocks[block],
+               dX.blocks[block], beta_mu, multiply_backend,
+               work.blocks[block], dY.blocks[block]);
+    }
 }
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "../../../../Block_Diagonal_Matrix.hxx"
+#include "../../../../Cholesky_Inverse.hxx"
+
+// The pieces of compute_search_direction() that work on one block.
+// Each one does a whole multiply/solve/symmetrize sequence on its
+// block, so that every block only has to be brought into cache once.
+// These work the same way for El::Matrix, for blocks that live on a
+// single rank, and for El::DistMatrix.
+//
+// R here does not include the beta mu I term, which is added to the
+// diagonal of the result instead.  The solves with X use
+// X_cholesky_inverse if it is not null (see cholesky_solve_block),
+// and overwrite work.
+
+// R := -X Y (predictor phase) or R := R - dX dY (corrector phase),
+// where R still holds -X Y from the predictor phase.  Then
+//
+//   Z := Symmetrize(X^{-1} (PrimalResidues Y - R - beta mu I))
+template <class Matrix>
+void R_and_Z_block(const bool &is_corrector_phase, const Matrix &X,
+                   const Matrix &Y, const Matrix &X_cholesky,
+                   const Matrix *X_cholesky_inverse,
+                   const Matrix &primal_residues, const Matrix &dX,
+                   const Matrix &dY, const El::BigFloat &beta_mu,
+                   const Multiply_Backend &multiply_backend, Matrix &work,
+                   Matrix &R, Matrix &Z)
+{
+  if(is_corrector_phase)
+    {
+      El::Gemm(El::OrientationNS::NORMAL, El::OrientationNS::NORMAL,
+               El::BigFloat(-1), dX, dY, El::BigFloat(1), R);
+    }
+  else
+    {
+      El::Gemm(El::OrientationNS::NORMAL, El::OrientationNS::NORMAL,
+               El::BigFloat(-1), X, Y, El::BigFloat(0), R);
+    }
+
+  El::Copy(R, Z);
+  El::Gemm(El::OrientationNS::NORMAL, El::OrientationNS::NORMAL,
+           El::BigFloat(1), primal_residues, Y, El::BigFloat(-1), Z);
+  El::ShiftDiagonal(Z, -beta_mu);
+  cholesky_solve_block(X_cholesky, X_cholesky_inverse, multiply_backend, work,
+                       Z);
+  symmetrize_block(Z);
+}
+
+// dY := Symmetrize(X^{-1} (R + beta mu I - dX Y))
+template <class Matrix>
+void dY_block(const Matrix &Y, const Matrix &X_cholesky,
+              const Matrix *X_cholesky_inverse, const Matrix &R,
+              const Matrix &dX, const El::BigFloat &beta_mu,
+              const Multiply_Backend &multiply_backend, Matrix &work,
+              Matrix &dY)
+{
+  El::Copy(R, dY);
+  El::Gemm(El::OrientationNS::NORMAL, El::OrientationNS::NORMAL,
+           El::BigFloat(-1), dX, Y, El::BigFloat(1), dY);
+  El::ShiftDiagonal(dY, beta_mu);
+  cholesky_solve_block(X_cholesky, X_cholesky_inverse, multiply_backend, work,
+                       dY);
+  symmetrize_block(dY);
+}
@@ -0,0 +1,157 @@
+#include "../../../../SDP.hxx"
+#include "../../../../Block_Diagonal_Matrix.hxx"
+#include "../../../../Precision_Scope.hxx"
+
+// Solve the Schur complement equation
+//
+//   {{S, -B}, {B^T, 0}} . {dx, dy} = {r, s}
+//
+// when schur_complement_cholesky, schur_off_diagonal and Q were
+// computed at the lower precision schur_precision.  Each solve with
+// those factors is only accurate to about schur_precision bits, so
+// we use iterative refinement:
+//
+//   1. Solve for a correction using the residue as the right-hand
+//      side, at schur_precision.
+//   2. Add the correction to {dx, dy}.
+//   3. Compute the residue {r, s} - {{S, -B}, {B^T, 0}} . {dx, dy} at
+//      the working precision, with S in schur_complement and B in
+//      sdp.free_var_matrix.
+//
+// starting from {dx, dy} = 0, until the residue, relative to {r, s},
+// is within a few bits of the working precision.  We also stop if a
+// step does not at least halve the residue, or after
+// max_refinements steps.
+//
+// As in solve_schur_complement_equation, the inputs dx and dy are r
+// and s, where s is the sum of the blocks of dy.  On output, dx and
+// dy are the solution, with a complete copy of dy in every block.
+// num_refinements is the number of solves after the first, and
+// relative_residue is the size of the final residue relative to
+// {r, s}.
+//
+// Workspace: rhs_dx, rhs_dy, residue_dx and residue_dy, with the same
+// structure as dx and dy, and correction_dx and correction_dy at
+// schur_precision.
+
+void solve_schur_complement_equation(
+  const Block_Diagonal_Matrix &schur_complement_cholesky,
+  const Block_Matrix &schur_off_diagonal,
+  const El::DistMatrix<El::BigFloat> &Q, Block_Vector &dx, Block_Vector &dy);
+
+namespace
+{
+  // max(|residue_dx|, |\sum_b residue_dy_b|) over all ranks, where
+  // the blocks of residue_dy have the given height.
+  El::BigFloat
+  residue_size(const Block_Vector &residue_dx, const Block_Vector &residue_dy,
+               const int64_t &height)
+  {
+    El::BigFloat local_max(0);
+    for(auto &block : residue_dx.blocks)
+      for(int64_t row = 0; row < block.LocalHeight(); ++row)
+        for(int64_t column = 0; column < block.LocalWidth(); ++column)
+          {
+            local_max
+              = std::max(local_max, El::Abs(block.GetLocal(row, column)));
+          }
+
+    // Each element of the blocks of residue_dy lives on exactly one
+    // rank, so summing everything gives the total over blocks.
+    El::Matrix<El::BigFloat> sum;
+    Zeros(sum, height, 1);
+    for(auto &block : residue_dy.blocks)
+      for(int64_t row = 0; row < block.LocalHeight(); ++row)
+        for(int64_t column = 0; column < block.LocalWidth(); ++column)
+          {
+            sum(block.GlobalRow(row), block.GlobalCol(column))
+              += block.GetLocal(row, column);
+          }
+    El::mpi::AllReduce(sum.Buffer(), height, El::mpi::SUM,
+                       El::mpi::COMM_WORLD);
+    for(int64_t row = 0; row < height; ++row)
+      {
+        local_max = std::max(local_max, El::Abs(sum(row, 0)));
+      }
+    return El::mpi::AllReduce(local_max, El::mpi::MAX, El::mpi::COMM_WORLD);
+  }
+}
+
+void solve_schur_complement_refined(
+  const SDP &sdp, const Block_Diagonal_Matrix &schur_complement,
+  const Block_Diagonal_Matrix &schur_complement_cholesky,
+  const Block_Matrix &schur_off_diagonal,
+  const El::DistMatrix<El::BigFloat> &Q, const size_t &schur_precision,
+  const size_t &max_refinements, Block_Vector &rhs_dx, Block_Vector &rhs_dy,
+  Block_Vector &residue_dx, Block_Vector &residue_dy,
+  Block_Vector &correction_dx, Block_Vector &correction_dy, Block_Vector &dx,
+  Block_Vector &dy, size_t &num_refinements, El::BigFloat &relative_residue)
+{
+  const size_t num_blocks(dx.blocks.size());
+  for(size_t block = 0; block < num_blocks; ++block)
+    {
+      rhs_dx.blocks[block] = dx.blocks[block];
+      rhs_dy.blocks[block] = dy.blocks[block];
+      residue_dx.blocks[block] = dx.blocks[block];
+      residue_dy.blocks[block] = dy.blocks[block];
+      Zero(dx.blocks[block]);
+      Zero(dy.blocks[block]);
+    }
+
+  const El::BigFloat rhs_size(residue_size(rhs_dx, rhs_dy, Q.Height()));
+  El::BigFloat tolerance(rhs_size);
+  mpf_div_2exp(tolerance.gmp_float.get_mpf_t(),
+               tolerance.gmp_float.get_mpf_t(), mpf_get_default_prec() - 8);
+
+  El::BigFloat size(rhs_size);
+  for(num_refinements = 0;; ++num_refinements)
+    {
+      for(size_t block = 0; block < num_blocks; ++block)
+        {
+          copy_rounded(residue_dx.blocks[block],
+                       correction_dx.blocks[block]);
+          copy_rounded(residue_dy.blocks[block],
+                       correction_dy.blocks[block]);
+        }
+      {
+        Precision_Scope scope(schur_precision);
+        solve_schur_complement_equation(schur_complement_cholesky,
+                                        schur_off_diagonal, Q,
+                                        correction_dx, correction_dy);
+      }
+      for(size_t block = 0; block < num_blocks; ++block)
+        {
+          El::Axpy(El::BigFloat(1), correction_dx.blocks[block],
+                   dx.blocks[block]);
+          El::Axpy(El::BigFloat(1), correction_dy.blocks[block],
+                   dy.blocks[block]);
+        }
+
+      // residue_dx = r - S dx + B dy
+      // residue_dy = s - B^T dx
+      for(size_t block = 0; block < num_blocks; ++block)
+        {
+          residue_dx.blocks[block] = rhs_dx.blocks[block];
+          El::Gemv(El::OrientationNS::NORMAL, El::BigFloat(-1),
+                   schur_complement.blocks[block], dx.blocks[block],
+                   El::BigFloat(1), residue_dx.blocks[block]);
+          El::Gemv(El::OrientationNS::NORMAL, El::BigFloat(1),
+                   sdp.free_var_matrix.blocks[block], dy.blocks[block],
+                   El::BigFloat(1), residue_dx.blocks[block]);
+
+          residue_dy.blocks[block] = rhs_dy.blocks[block];
+          El::Gemv(El::OrientationNS::TRANSPOSE, El::BigFloat(-1),
+                   sdp.free_var_matrix.blocks[block], dx.blocks[block],
+                   El::BigFloat(1), residue_dy.blocks[block]);
+        }
+      const El::BigFloat new_size(
+        residue_size(residue_dx, residue_dy, Q.Height()));
+      const bool is_stalled(new_size * 2 > size);
+      size = new_size;
+      if(size <= tolerance || is_stalled || num_refinements == max_refinements)
+        {
+          break;
+        }
+    }
+  relative_residue = (rhs_size == 0 ? El::BigFloat(0) : size / rhs_size);
+}
@@ -3,29 +3,49 @@
 // (X + dX) . (Y + dY), where X, dX, Y, dY are symmetric
 // BlockDiagonalMatrices and '.' is the Frobenius product.
 //
+// As in local_frobenius_product_symmetric, only the lower triangles are
+// read, and the sums are formed one element at a time, so there are
+// no intermediate matrices.
 El::BigFloat frobenius_product_of_sums(const Block_Diagonal_Matrix &X,
                                        const Block_Diagonal_Matrix &dX,
                                        const Block_Diagonal_Matrix &Y,
                                        const Block_Diagonal_Matrix &dY)
 {
-  El::BigFloat local_sum(0);
+  El::BigFloat local_sum(0), X_dX, Y_dY;
   for(size_t b = 0; b < X.blocks.size(); b++)
     {
-      // FIXME: This can be sped up by not have intermediate results.
-      // It may require looking into the implementation of Dotu.
-      El::DistMatrix<El::BigFloat> X_dX(X.blocks[b]);
-      X_dX += dX.blocks[b];
-      El::DistMatrix<El::BigFloat> Y_dY(Y.blocks[b]);
-      Y_dY += dY.blocks[b];
-      local_sum += Dotu(X_dX, Y_dY);
-    }
-
-  // Make sure not to double count if blocks are distributed over more
-  // than one processor.  We could also divide the sum by
-  // X.blocks.front().Size().
-  if(!X.blocks.empty() && X.blocks.front().Grid().Rank() != 0)
-    {
-      local_sum = 0;
+      const El::Matrix<El::BigFloat> &X_local(X.blocks[b].LockedMatrix()),
+        &dX_local(dX.blocks[b].LockedMatrix()),
+        &Y_local(Y.blocks[b].LockedMatrix()),
+        &dY_local(dY.blocks[b].LockedMatrix());
+      for(int64_t local_column = 0; local_column < X_local.Width();
+          ++local_column)
+        {
+          const int64_t column(X.blocks[b].GlobalCol(local_column));
+          for(int64_t local_row = 0; local_row < X_local.Height();
+              ++local_row)
+            {
+              const int64_t row(X.blocks[b].GlobalRow(local_row));
+              if(row < column)
+                {
+                  continue;
+                }
+              mpf_add(X_dX.gmp_float.get_mpf_t(),
+                      X_local(local_row, local_column).gmp_float.get_mpf_t(),
+                      dX_local(local_row, local_column).gmp_float.get_mpf_t());
+              mpf_add(Y_dY.gmp_float.get_mpf_t(),
+                      Y_local(local_row, local_column).gmp_float.get_mpf_t(),
+                      dY_local(local_row, local_column).gmp_float.get_mpf_t());
+              mpf_mul(X_dX.gmp_float.get_mpf_t(), X_dX.gmp_float.get_mpf_t(),
+                      Y_dY.gmp_float.get_mpf_t());
+              if(row != column)
+                {
+                  mpf_mul_2exp(X_dX.gmp_float.get_mpf_t(),
+                               X_dX.gmp_float.get_mpf_t(), 1);
+                }
+              local_sum += X_dX;
+            }
+        }
     }
   return El::mpi::AllReduce(local_sum, El::mpi::COMM_WORLD);
 }
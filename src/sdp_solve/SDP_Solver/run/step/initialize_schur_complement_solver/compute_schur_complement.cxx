@@ -1,7 +1,10 @@
 #include "../../../../Block_Diagonal_Matrix.hxx"
 #include "../../../../Block_Info.hxx"
+#include "../../../../Thread_Pool.hxx"
 #include "../../../../../Timers.hxx"
 
+#include <array>
+
 // Compute the SchurComplement matrix using BilinearPairingsXInv and
 // BilinearPairingsY and the formula
 //
@@ -11,139 +14,161 @@
 //                 swaps (r1 <-> s1) and (r2 <-> s2))
 //
 // where ej = d_j + 1.
+//
+// The bilinear pairings are small compared to S, so we replicate them
+// on every rank in the block's grid.  Each rank then fills in its own
+// local elements of the lower triangle of S in a single pass, summing
+// all four terms and both parities directly into the result.  This
+// avoids constructing views, transposes, and temporaries for every
+// (r1,s1,r2,s2) quadruple.  The local columns are independent, so
+// they are split among the threads in thread_pool.  Blocks on a
+// single rank skip the copies and the distributed MakeSymmetric.
 
 namespace
 {
-  // Elementwise multiplication of two submatrices.
-  //
-  // result(i,j)=(bilinear_X_inv(column_offset_X+i,row_offset_X+j)
-  //              * bilinear_Y_inv(column_offset_Y+i,row_offset_Y+j))/4
-
-  void
-  multiply_submatrices(const El::DistMatrix<El::BigFloat> &bilinear_X_inv,
-                       const El::DistMatrix<El::BigFloat> &bilinear_Y,
-                       const size_t &block_size, const size_t &column_offset_X,
-                       const size_t &row_offset_X,
-                       const size_t &column_offset_Y,
-                       const size_t &row_offset_Y,
-                       El::DistMatrix<El::BigFloat> &temp,
-                       El::DistMatrix<El::BigFloat> &result_submatrix)
+  // The (r,s,k) labels of a row or column of a Schur complement
+  // block, where 0 <= r <= s < m_j and 0 <= k <= d_j.
+  struct Schur_Index
   {
-    El::DistMatrix<El::BigFloat> X_submatrix(El::LockedView(
-      bilinear_X_inv, column_offset_X, row_offset_X, block_size, block_size)),
-      Y_submatrix(El::LockedView(bilinear_Y, column_offset_Y, row_offset_Y,
-                                 block_size, block_size)),
-      Y_transpose(block_size, block_size, bilinear_Y.Grid());
+    size_t r, s, k;
+  };
 
-    // The overall result is symmetric, but this particular block may
-    // not be because it is offset from the diagonal.
+  std::vector<Schur_Index>
+  schur_indices(const size_t &dimension, const size_t &block_size)
+  {
+    std::vector<Schur_Index> result;
+    result.reserve(block_size * dimension * (dimension + 1) / 2);
+    for(size_t s = 0; s < dimension; ++s)
+      for(size_t r = 0; r <= s; ++r)
+        for(size_t k = 0; k < block_size; ++k)
+          {
+            result.push_back({r, s, k});
+          }
+    return result;
+  }
 
-    // It does not help to use TransposeAxpy().  Hadamard() sets the
-    // result, it does not add it in.
-    El::Transpose(Y_submatrix, Y_transpose);
-    if(X_submatrix.ColAlign() == Y_transpose.ColAlign()
-       && X_submatrix.RowAlign() == Y_transpose.RowAlign())
-      {
-        El::Hadamard(X_submatrix, Y_transpose, temp);
-      }
-    else
-      {
-        El::DistMatrix<El::BigFloat> Y_transpose_aligned(
-          block_size, block_size, Y_transpose.Grid());
-        Y_transpose_aligned.AlignWith(X_submatrix);
-        El::Copy(Y_transpose, Y_transpose_aligned);
-        El::Hadamard(X_submatrix, Y_transpose_aligned, temp);
-      }
-    Axpy(El::BigFloat(0.25), temp, result_submatrix);
+  // element += x*y, using product as scratch space
+  inline void add_product(const El::BigFloat &x, const El::BigFloat &y,
+                          El::BigFloat &product, El::BigFloat &element)
+  {
+    mpf_mul(product.gmp_float.get_mpf_t(), x.gmp_float.get_mpf_t(),
+            y.gmp_float.get_mpf_t());
+    mpf_add(element.gmp_float.get_mpf_t(), element.gmp_float.get_mpf_t(),
+            product.gmp_float.get_mpf_t());
   }
 }
 
 void compute_schur_complement(
   const Block_Info &block_info,
   const Block_Diagonal_Matrix &bilinear_pairings_X_inv,
-  const Block_Diagonal_Matrix &bilinear_pairings_Y,
+  const Block_Diagonal_Matrix &bilinear_pairings_Y, Thread_Pool &thread_pool,
   Block_Diagonal_Matrix &schur_complement, Timers &timers)
 {
   auto &schur_complement_timer(timers.add_and_start(
     "run.step.initializeSchurComplementSolver.schur_complement"));
 
+  // Scratch space for each thread
+  std::vector<El::BigFloat> products(thread_pool.size());
   auto schur_complement_block(schur_complement.blocks.begin());
   auto bilinear_pairings_X_inv_block(bilinear_pairings_X_inv.blocks.begin());
   auto bilinear_pairings_Y_block(bilinear_pairings_Y.blocks.begin());
-  for(auto &block_index : block_info.block_indices)
+  for(size_t block = 0; block < block_info.block_indices.size(); ++block)
     {
+      const auto start(Timers::Clock::now());
+      const size_t block_index(block_info.block_indices[block]);
       const size_t block_size(block_info.degrees[block_index] + 1);
+      const std::vector<Schur_Index> indices(
+        schur_indices(block_info.dimensions[block_index], block_size));
 
-      for(size_t column_block_0 = 0;
-          column_block_0 < block_info.dimensions[block_index];
-          ++column_block_0)
+      // A block on a single rank already has the whole of the
+      // pairings locally, so they are used in place.
+      const bool is_local(schur_complement_block->Grid().Size() == 1);
+      std::vector<El::DistMatrix<El::BigFloat, El::STAR, El::STAR>>
+        X_inv_star, Y_star;
+      std::array<const El::Matrix<El::BigFloat> *, 2> X_inv_local, Y_local;
+      X_inv_star.reserve(2);
+      Y_star.reserve(2);
+      for(size_t parity = 0; parity < 2; ++parity)
         {
-          const size_t column_offset_0(column_block_0 * block_size);
-          for(size_t row_block_0 = 0; row_block_0 <= column_block_0;
-              ++row_block_0)
+          if(is_local)
             {
-              const size_t row_offset_0(row_block_0 * block_size);
-              size_t result_row_offset(
-                ((column_block_0 * (column_block_0 + 1)) / 2 + row_block_0)
-                * block_size);
-
-              for(size_t column_block_1 = 0;
-                  column_block_1 < block_info.dimensions[block_index];
-                  ++column_block_1)
-                {
-                  const size_t column_offset_1(column_block_1 * block_size);
-                  for(size_t row_block_1 = 0; row_block_1 <= column_block_1;
-                      ++row_block_1)
-                    {
-                      const size_t row_offset_1(row_block_1 * block_size);
-                      size_t result_column_offset(
-                        ((column_block_1 * (column_block_1 + 1)) / 2
-                         + row_block_1)
-                        * block_size);
+              X_inv_local[parity]
+                = &(bilinear_pairings_X_inv_block + parity)->LockedMatrix();
+              Y_local[parity]
+                = &(bilinear_pairings_Y_block + parity)->LockedMatrix();
+            }
+          else
+            {
+              X_inv_star.emplace_back(
+                *(bilinear_pairings_X_inv_block + parity));
+              Y_star.emplace_back(*(bilinear_pairings_Y_block + parity));
+              X_inv_local[parity] = &X_inv_star.back().LockedMatrix();
+              Y_local[parity] = &Y_star.back().LockedMatrix();
+            }
+        }
 
-                      El::DistMatrix<El::BigFloat> result_sub_matrix(El::View(
-                        *schur_complement_block, result_row_offset,
-                        result_column_offset, block_size, block_size));
-                      Zero(result_sub_matrix);
+      El::Matrix<El::BigFloat> &local(schur_complement_block->Matrix());
+      thread_pool.parallel_for(
+        schur_complement_block->LocalWidth(),
+        [&](const size_t &column, const size_t &thread) {
+          El::BigFloat &product(products[thread]);
+          const size_t global_column(
+            schur_complement_block->GlobalCol(column));
+          const Schur_Index &index_1(indices[global_column]);
+          const size_t column_offset_1(index_1.s * block_size + index_1.k),
+            row_offset_1(index_1.r * block_size + index_1.k);
 
-                      El::DistMatrix<El::BigFloat> temp(
-                        block_size, block_size, result_sub_matrix.Grid());
+          // Only fill in the lower triangle
+          for(int64_t row
+              = schur_complement_block->LocalRowOffset(global_column);
+              row < schur_complement_block->LocalHeight(); ++row)
+            {
+              const Schur_Index &index_0(
+                indices[schur_complement_block->GlobalRow(row)]);
+              const size_t column_offset_0(index_0.s * block_size
+                                           + index_0.k),
+                row_offset_0(index_0.r * block_size + index_0.k);
 
-                      auto bilinear_X_inv(bilinear_pairings_X_inv_block);
-                      auto bilinear_Y(bilinear_pairings_Y_block);
-                      for(size_t bb(2 * block_index); bb < 2 * block_index + 2;
-                          ++bb)
-                        {
-                          multiply_submatrices(
-                            *bilinear_X_inv, *bilinear_Y, block_size,
-                            column_offset_0, row_offset_1, column_offset_1,
-                            row_offset_0, temp, result_sub_matrix);
-                          multiply_submatrices(
-                            *bilinear_X_inv, *bilinear_Y, block_size,
-                            row_offset_0, row_offset_1, column_offset_1,
-                            column_offset_0, temp, result_sub_matrix);
-                          multiply_submatrices(
-                            *bilinear_X_inv, *bilinear_Y, block_size,
-                            column_offset_0, column_offset_1, row_offset_1,
-                            row_offset_0, temp, result_sub_matrix);
-                          multiply_submatrices(
-                            *bilinear_X_inv, *bilinear_Y, block_size,
-                            row_offset_0, column_offset_1, row_offset_1,
-                            column_offset_0, temp, result_sub_matrix);
-                          ++bilinear_X_inv;
-                          ++bilinear_Y;
-                        }
-                    }
+              El::BigFloat &element(local(row, column));
+              mpf_set_ui(element.gmp_float.get_mpf_t(), 0);
+              for(size_t parity = 0; parity < 2; ++parity)
+                {
+                  const El::Matrix<El::BigFloat> &X_inv(*X_inv_local[parity]),
+                    &Y(*Y_local[parity]);
+                  add_product(X_inv(column_offset_0, row_offset_1),
+                              Y(column_offset_1, row_offset_0), product,
+                              element);
+                  add_product(X_inv(row_offset_0, row_offset_1),
+                              Y(column_offset_1, column_offset_0), product,
+                              element);
+                  add_product(X_inv(column_offset_0, column_offset_1),
+                              Y(row_offset_1, row_offset_0), product,
+                              element);
+                  add_product(X_inv(row_offset_0, column_offset_1),
+                              Y(row_offset_1, column_offset_0), product,
+                              element);
                 }
+              // Divide by 4
+              mpf_div_2exp(element.gmp_float.get_mpf_t(),
+                           element.gmp_float.get_mpf_t(), 2);
             }
-        }
+        });
 
-      El::MakeSymmetric(El::UpperOrLower::LOWER, *schur_complement_block);
+      if(is_local)
+        {
+          El::MakeSymmetric(El::UpperOrLower::LOWER, local);
+        }
+      else
+        {
+          El::MakeSymmetric(El::UpperOrLower::LOWER, *schur_complement_block);
+        }
       ++schur_complement_block;
       ++bilinear_pairings_X_inv_block;
       ++bilinear_pairings_X_inv_block;
       ++bilinear_pairings_Y_block;
       ++bilinear_pairings_Y_block;
+      timers.add_block_elapsed("schur_complement", block,
+                               Timers::Clock::now() - start);
     }
   schur_complement_timer.stop();
 }
@@ -1,68 +1,136 @@
 #include "../../../../SDP.hxx"
 #include "../../../../Block_Diagonal_Matrix.hxx"
+#include "../../../../Multiply_Backend.hxx"
+#include "../../../../Precision_Scope.hxx"
+#include "../../../../Synchronize_Q_Plan.hxx"
+#include "../../../../Thread_Pool.hxx"
 #include "../../../../../Timers.hxx"
 
+void initialize_Q_group_local(
+  const SDP &sdp, const Block_Info &block_info,
+  Block_Matrix &schur_off_diagonal,
+  Block_Diagonal_Matrix &schur_complement_cholesky,
+  const Multiply_Backend &multiply_backend, Thread_Pool &thread_pool,
+  El::DistMatrix<El::BigFloat> &Q_group,
+  std::list<Synchronize_Q_Plan> &synchronize_Q_plans,
+  El::DistMatrix<El::BigFloat> &Q, Timers &timers);
+
+// On input, schur_complement_cholesky holds the Schur complement.  It
+// is overwritten with its Cholesky decomposition.
+//
+// Q_group is computed one column panel at a time, in the panels of
+// synchronize_Q_plans.  As soon as a panel is finished, its reduction
+// into Q is started, and the reductions in flight are advanced after
+// every block of the following panels.  synchronize_Q then only has
+// to wait for whatever is left.
+
 void initialize_Q_group(const SDP &sdp, const Block_Info &block_info,
-                        const Block_Diagonal_Matrix &schur_complement,
                         Block_Matrix &schur_off_diagonal,
                         Block_Diagonal_Matrix &schur_complement_cholesky,
-                        El::DistMatrix<El::BigFloat> &Q_group, Timers &timers)
+                        const Multiply_Backend &multiply_backend,
+                        Thread_Pool &thread_pool,
+                        El::DistMatrix<El::BigFloat> &Q_group,
+                        std::list<Synchronize_Q_Plan> &synchronize_Q_plans,
+                        El::DistMatrix<El::BigFloat> &Q, Timers &timers)
 {
-  // Explicitly deallocate the lower half of Q_group.  This
-  // significantly reduces the total amount of memory required.
+  // The lower half of Q_group is deallocated (see
+  // SDP_Solver_Workspace), so only zero the upper half.
   El::Matrix<El::BigFloat> &local(Q_group.Matrix());
-  for(int64_t row = 0; row < Q_group.Height(); ++row)
-    for(int64_t column = 0; column < row; ++column)
-      {
-        if(Q_group.IsLocal(row, column))
-          {
-            mpf_clear(local(Q_group.LocalRow(row), Q_group.LocalCol(column))
-                        .gmp_float.get_mpf_t());
-            local(Q_group.LocalRow(row), Q_group.LocalCol(column))
-              .gmp_float.get_mpf_t()[0]
-              ._mp_d
-              = nullptr;
-          }
-      }
+  for(int64_t column = 0; column < Q_group.LocalWidth(); ++column)
+    {
+      const int64_t global_column(Q_group.GlobalCol(column));
+      for(int64_t row = 0; row < Q_group.LocalHeight(); ++row)
+        {
+          if(Q_group.GlobalRow(row) > global_column)
+            {
+              break;
+            }
+          mpf_set_ui(local(row, column).gmp_float.get_mpf_t(), 0);
+        }
+    }
+
+  if(Q_group.Grid().Size() == 1)
+    {
+      initialize_Q_group_local(sdp, block_info, schur_off_diagonal,
+                               schur_complement_cholesky, multiply_backend,
+                               thread_pool, Q_group, synchronize_Q_plans, Q,
+                               timers);
+      return;
+    }
 
-  schur_off_diagonal.blocks.clear();
-  schur_off_diagonal.blocks.reserve(schur_complement_cholesky.blocks.size());
-  
   for(size_t block = 0; block < schur_complement_cholesky.blocks.size();
       ++block)
     {
       auto &cholesky_timer(timers.add_and_start(
         "run.step.initializeSchurComplementSolver.Q.cholesky_"
         + std::to_string(block_info.block_indices[block])));
-      schur_complement_cholesky.blocks[block] = schur_complement.blocks[block];
-
       Cholesky(El::UpperOrLowerNS::LOWER,
                schur_complement_cholesky.blocks[block]);
       cholesky_timer.stop();
+      timers.add_block_elapsed("cholesky", block,
+                               cholesky_timer.stop_time
+                                 - cholesky_timer.start_time);
 
       // schur_off_diagonal = L^{-1} B
       auto &solve_timer(timers.add_and_start(
         "run.step.initializeSchurComplementSolver.Q.solve_"
         + std::to_string(block_info.block_indices[block])));
 
-      schur_off_diagonal.blocks.push_back(sdp.free_var_matrix.blocks[block]);
+      copy_rounded(sdp.free_var_matrix.blocks[block],
+                   schur_off_diagonal.blocks[block]);
       El::Trsm(El::LeftOrRightNS::LEFT, El::UpperOrLowerNS::LOWER,
                El::OrientationNS::NORMAL, El::UnitOrNonUnitNS::NON_UNIT,
                El::BigFloat(1), schur_complement_cholesky.blocks[block],
                schur_off_diagonal.blocks[block]);
 
       solve_timer.stop();
+      timers.add_block_elapsed("solve", block,
+                               solve_timer.stop_time - solve_timer.start_time);
+    }
 
-      // Q = (L^{-1} B)^T (L^{-1} B) = schur_off_diagonal^T schur_off_diagonal
-      auto &syrk_timer(timers.add_and_start(
-        "run.step.initializeSchurComplementSolver.Q.syrk_"
-        + std::to_string(block_info.block_indices[block])));
-      El::DistMatrix<El::BigFloat> Q_group_view(
-        El::View(Q_group, 0, 0, schur_off_diagonal.blocks[block].Width(),
-                 schur_off_diagonal.blocks[block].Width()));
-      El::Syrk(El::UpperOrLowerNS::UPPER, El::OrientationNS::TRANSPOSE,
-               El::BigFloat(1), schur_off_diagonal.blocks[block],
-               El::BigFloat(1), Q_group_view);
-      syrk_timer.stop();
+  // Q = (L^{-1} B)^T (L^{-1} B) = schur_off_diagonal^T schur_off_diagonal
+  using Clock = std::chrono::high_resolution_clock;
+  std::vector<Clock::duration> syrk_elapsed(
+    schur_complement_cholesky.blocks.size(), Clock::duration(0));
+  for(auto &plan : synchronize_Q_plans)
+    {
+      const int64_t begin(plan.column_begin), end(plan.column_end);
+      El::DistMatrix<El::BigFloat> Q_rectangle(
+        El::View(Q_group, 0, begin, begin, end - begin)),
+        Q_square(El::View(Q_group, begin, begin, end - begin, end - begin));
+      for(size_t block = 0;
+          block < schur_off_diagonal.blocks.size() && begin != end; ++block)
+        {
+          auto start(Clock::now());
+          const El::DistMatrix<El::BigFloat> &A(
+            schur_off_diagonal.blocks[block]);
+          const El::DistMatrix<El::BigFloat> A_panel(
+            El::LockedView(A, 0, begin, A.Height(), end - begin));
+          if(begin != 0)
+            {
+              gemm(multiply_backend, El::OrientationNS::TRANSPOSE,
+                   El::OrientationNS::NORMAL,
+                   El::LockedView(A, 0, 0, A.Height(), begin), A_panel,
+                   El::BigFloat(1), Q_rectangle);
+            }
+          syrk(multiply_backend, El::UpperOrLowerNS::UPPER,
+               El::OrientationNS::TRANSPOSE, A_panel, El::BigFloat(1),
+               Q_square);
+          syrk_elapsed[block] += Clock::now() - start;
+
+          for(auto &in_flight : synchronize_Q_plans)
+            {
+              in_flight.progress(Q, false);
+            }
+        }
+      plan.start(Q_group, Q);
+    }
+
+  for(size_t block = 0; block < syrk_elapsed.size(); ++block)
+    {
+      timers.add_elapsed("run.step.initializeSchurComplementSolver.Q.syrk_"
+                           + std::to_string(block_info.block_indices[block]),
+                         syrk_elapsed[block]);
+      timers.add_block_elapsed("syrk", block, syrk_elapsed[block]);
     }
 }
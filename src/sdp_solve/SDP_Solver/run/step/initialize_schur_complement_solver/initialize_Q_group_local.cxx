@@ -0,0 +1,158 @@
+#include "../../../../SDP.hxx"
+#include "../../../../Block_Diagonal_Matrix.hxx"
+#include "../../../../Multiply_Backend.hxx"
+#include "../../../../Precision_Scope.hxx"
+#include "../../../../Synchronize_Q_Plan.hxx"
+#include "../../../../Thread_Pool.hxx"
+#include "../../../../../Timers.hxx"
+
+#include <cmath>
+
+// Threaded version of initialize_Q_group for when the whole group
+// lives on a single rank.  Everything is done with local matrices so
+// that the worker threads never call MPI.
+//
+// The Cholesky decompositions and solves are independent for each
+// block.  The Syrk's all accumulate into Q_group, so instead of
+// splitting by block we split each column panel of the upper triangle
+// of Q_group into column strips.  Each thread owns its strips and adds
+// the contributions of every block to them, so no two threads ever
+// write the same element.  The main thread also advances the
+// reductions of the panels that are already finished.
+
+namespace
+{
+  // Split the columns begin <= column < end of an upper triangle so
+  // that each strip has about the same number of elements.
+  std::vector<size_t> strip_boundaries(const size_t &begin, const size_t &end,
+                                       const size_t &num_strips)
+  {
+    std::vector<size_t> result(num_strips + 1, end);
+    result.front() = begin;
+    const double begin_squared(double(begin) * begin),
+      end_squared(double(end) * end);
+    for(size_t strip = 1; strip < num_strips; ++strip)
+      {
+        result[strip] = std::max(
+          result[strip - 1],
+          std::min(end, static_cast<size_t>(std::round(std::sqrt(
+                          begin_squared
+                          + (end_squared - begin_squared) * strip
+                              / num_strips)))));
+      }
+    return result;
+  }
+}
+
+void initialize_Q_group_local(
+  const SDP &sdp, const Block_Info &block_info,
+  Block_Matrix &schur_off_diagonal,
+  Block_Diagonal_Matrix &schur_complement_cholesky,
+  const Multiply_Backend &multiply_backend, Thread_Pool &thread_pool,
+  El::DistMatrix<El::BigFloat> &Q_group,
+  std::list<Synchronize_Q_Plan> &synchronize_Q_plans,
+  El::DistMatrix<El::BigFloat> &Q, Timers &timers)
+{
+  using Clock = std::chrono::high_resolution_clock;
+  const size_t num_blocks(schur_complement_cholesky.blocks.size());
+
+  for(size_t block = 0; block < num_blocks; ++block)
+    {
+      copy_rounded(sdp.free_var_matrix.blocks[block],
+                   schur_off_diagonal.blocks[block]);
+    }
+
+  std::vector<Clock::duration> cholesky_elapsed(num_blocks),
+    solve_elapsed(num_blocks);
+  thread_pool.parallel_for(num_blocks, [&](const size_t &block,
+                                           const size_t &) {
+    El::Matrix<El::BigFloat> &cholesky(
+      schur_complement_cholesky.blocks[block].Matrix());
+    auto start(Clock::now());
+    El::Cholesky(El::UpperOrLowerNS::LOWER, cholesky);
+    auto cholesky_end(Clock::now());
+    cholesky_elapsed[block] = cholesky_end - start;
+
+    // schur_off_diagonal = L^{-1} B
+    El::Trsm(El::LeftOrRightNS::LEFT, El::UpperOrLowerNS::LOWER,
+             El::OrientationNS::NORMAL, El::UnitOrNonUnitNS::NON_UNIT,
+             El::BigFloat(1), cholesky,
+             schur_off_diagonal.blocks[block].Matrix());
+    solve_elapsed[block] = Clock::now() - cholesky_end;
+  });
+
+  // Q = (L^{-1} B)^T (L^{-1} B) = schur_off_diagonal^T schur_off_diagonal
+  std::vector<std::vector<Clock::duration>> syrk_elapsed(
+    thread_pool.size(), std::vector<Clock::duration>(num_blocks));
+
+  El::Matrix<El::BigFloat> &Q_local(Q_group.Matrix());
+  for(auto &plan : synchronize_Q_plans)
+    {
+      const std::vector<size_t> boundaries(strip_boundaries(
+        plan.column_begin, plan.column_end, 4 * thread_pool.size()));
+      thread_pool.parallel_for(
+        boundaries.size() - 1,
+        [&](const size_t &strip, const size_t &thread) {
+          const size_t begin(boundaries[strip]), end(boundaries[strip + 1]);
+          if(begin == end)
+            {
+              return;
+            }
+          El::Matrix<El::BigFloat> Q_rectangle(
+            El::View(Q_local, 0, begin, begin, end - begin)),
+            Q_square(
+              El::View(Q_local, begin, begin, end - begin, end - begin));
+          for(size_t block = 0; block < num_blocks; ++block)
+            {
+              auto start(Clock::now());
+              const El::Matrix<El::BigFloat> &A(
+                schur_off_diagonal.blocks[block].LockedMatrix());
+              const El::Matrix<El::BigFloat> A_strip(
+                El::LockedView(A, 0, begin, A.Height(), end - begin));
+              if(begin != 0)
+                {
+                  gemm(multiply_backend, El::OrientationNS::TRANSPOSE,
+                       El::OrientationNS::NORMAL,
+                       El::LockedView(A, 0, 0, A.Height(), begin), A_strip,
+                       El::BigFloat(1), Q_rectangle);
+                }
+              syrk(multiply_backend, El::UpperOrLowerNS::UPPER,
+                   El::OrientationNS::TRANSPOSE, A_strip, El::BigFloat(1),
+                   Q_square);
+              syrk_elapsed[thread][block] += Clock::now() - start;
+
+              // Only the main thread may call MPI
+              if(thread == 0)
+                {
+                  for(auto &in_flight : synchronize_Q_plans)
+                    {
+                      in_flight.progress(Q, false);
+                    }
+                }
+            }
+        });
+      plan.start(Q_group, Q);
+    }
+
+  for(size_t block = 0; block < num_blocks; ++block)
+    {
+      const std::string index(std::to_string(block_info.block_indices[block]));
+      timers.add_elapsed(
+        "run.step.initializeSchurComplementSolver.Q.cholesky_" + index,
+        cholesky_elapsed[block]);
+      timers.add_elapsed(
+        "run.step.initializeSchurComplementSolver.Q.solve_" + index,
+        solve_elapsed[block]);
+      Clock::duration syrk_total(0);
+      for(auto &thread_elapsed : syrk_elapsed)
+        {
+          syrk_total += thread_elapsed[block];
+        }
+      timers.add_elapsed(
+        "run.step.initializeSchurComplementSolver.Q.syrk_" + index,
+        syrk_total);
+      timers.add_block_elapsed("cholesky", block, cholesky_elapsed[block]);
+      timers.add_block_elapsed("solve", block, solve_elapsed[block]);
+      timers.add_block_elapsed("syrk", block, syrk_total);
+    }
+}
@@ -1,5 +1,9 @@
 #include "../../../../SDP.hxx"
 #include "../../../../Block_Diagonal_Matrix.hxx"
+#include "../../../../Multiply_Backend.hxx"
+#include "../../../../Precision_Scope.hxx"
+#include "../../../../Synchronize_Q_Plan.hxx"
+#include "../../../../Thread_Pool.hxx"
 #include "../../../../../Timers.hxx"
 
 // Compute the quantities needed to solve the Schur complement
@@ -25,42 +29,56 @@
 // This data is sufficient to efficiently solve the above equation for
 // a given r,s.
 //
+// If schur_precision is nonzero, S is computed at the working
+// precision in schur_complement, and everything after that is done
+// at schur_precision.  The solution is then refined at the working
+// precision with S itself (see solve_schur_complement_refined).
+//
 // Inputs:
 // - BilinearPairingsXInv, BilinearPairingsY (these are members of
 //   SDPSolver, but we include them as arguments to emphasize that
 //   they must be computed first)
-// Workspace (members of SDPSolver which are modified by this method
-// and not used later):
-// - SchurComplement
-// Outputs (members of SDPSolver which are modified by this method and
-// used later):
-// - SchurComplementCholesky
+// Workspace (members of SDP_Solver_Workspace which are modified by
+// this method and not used later):
+// - Q_group
+// - synchronize_Q_plans (only their buffers)
+// Outputs (members of SDP_Solver_Workspace which are modified by this
+// method and used later):
+// - SchurComplementCholesky (S is computed in place and then factored)
 // - SchurOffDiagonal
+// - Q
+// - schur_complement, if schur_precision is nonzero
 //
 
 void compute_schur_complement(
   const Block_Info &block_info,
   const Block_Diagonal_Matrix &bilinear_pairings_X_inv,
-  const Block_Diagonal_Matrix &bilinear_pairings_Y,
+  const Block_Diagonal_Matrix &bilinear_pairings_Y, Thread_Pool &thread_pool,
   Block_Diagonal_Matrix &schur_complement, Timers &timers);
 
 void initialize_Q_group(const SDP &sdp, const Block_Info &block_info,
-                        const Block_Diagonal_Matrix &schur_complement,
                         Block_Matrix &schur_off_diagonal,
                         Block_Diagonal_Matrix &schur_complement_cholesky,
-                        El::DistMatrix<El::BigFloat> &Q_group, Timers &timers);
+                        const Multiply_Backend &multiply_backend,
+                        Thread_Pool &thread_pool,
+                        El::DistMatrix<El::BigFloat> &Q_group,
+                        std::list<Synchronize_Q_Plan> &synchronize_Q_plans,
+                        El::DistMatrix<El::BigFloat> &Q, Timers &timers);
 
 void synchronize_Q(El::DistMatrix<El::BigFloat> &Q,
-                   const El::DistMatrix<El::BigFloat> &Q_group,
+                   std::list<Synchronize_Q_Plan> &synchronize_Q_plans,
                    Timers &timers);
 
 void initialize_schur_complement_solver(
   const Block_Info &block_info, const SDP &sdp,
   const Block_Diagonal_Matrix &bilinear_pairings_X_inv,
-  const Block_Diagonal_Matrix &bilinear_pairings_Y, const El::Grid &group_grid,
+  const Block_Diagonal_Matrix &bilinear_pairings_Y,
+  const Multiply_Backend &multiply_backend, const size_t &schur_precision,
+  Thread_Pool &thread_pool, Block_Diagonal_Matrix &schur_complement,
   Block_Diagonal_Matrix &schur_complement_cholesky,
-  Block_Matrix &schur_off_diagonal, El::DistMatrix<El::BigFloat> &Q,
-  Timers &timers)
+  Block_Matrix &schur_off_diagonal, El::DistMatrix<El::BigFloat> &Q_group,
+  std::list<Synchronize_Q_Plan> &synchronize_Q_plans,
+  El::DistMatrix<El::BigFloat> &Q, Timers &timers)
 {
   auto &initialize_timer(
     timers.add_and_start("run.step.initializeSchurComplementSolver"));
@@ -68,24 +86,37 @@ void initialize_schur_complement_solver(
   // block for each 0 <= j < J.  SchurComplement.blocks[j] has dimension
   // (d_j+1)*m_j*(m_j+1)/2
   //
-  Block_Diagonal_Matrix schur_complement(
-    block_info.schur_block_sizes, block_info.block_indices,
-    block_info.schur_block_sizes.size(), group_grid);
-
-  compute_schur_complement(block_info, bilinear_pairings_X_inv,
-                           bilinear_pairings_Y, schur_complement, timers);
+  // Unless we refine the solution, S is only needed to compute its
+  // Cholesky decomposition, so we compute it directly in
+  // schur_complement_cholesky.
+  if(schur_precision == 0)
+    {
+      compute_schur_complement(block_info, bilinear_pairings_X_inv,
+                               bilinear_pairings_Y, thread_pool,
+                               schur_complement_cholesky, timers);
+    }
+  else
+    {
+      compute_schur_complement(block_info, bilinear_pairings_X_inv,
+                               bilinear_pairings_Y, thread_pool,
+                               schur_complement, timers);
+      for(size_t block = 0; block < schur_complement.blocks.size(); ++block)
+        {
+          copy_rounded(schur_complement.blocks[block],
+                       schur_complement_cholesky.blocks[block]);
+        }
+    }
+  Precision_Scope scope(schur_precision);
 
   auto &Q_computation_timer(
     timers.add_and_start("run.step.initializeSchurComplementSolver.Q"));
 
-  {
-    // FIXME: Change initialize_Q_group to initialize_Q and
-    // synchronize inside.
-    El::DistMatrix<El::BigFloat> Q_group(Q.Height(), Q.Width(), group_grid);
-    initialize_Q_group(sdp, block_info, schur_complement, schur_off_diagonal,
-                       schur_complement_cholesky, Q_group, timers);
-    synchronize_Q(Q, Q_group, timers);
-  }
+  // initialize_Q_group starts summing the panels of Q_group into Q
+  // as they are finished, and synchronize_Q waits for the rest.
+  initialize_Q_group(sdp, block_info, schur_off_diagonal,
+                     schur_complement_cholesky, multiply_backend, thread_pool,
+                     Q_group, synchronize_Q_plans, Q, timers);
+  synchronize_Q(Q, synchronize_Q_plans, timers);
   Q_computation_timer.stop();
 
   auto &Cholesky_timer(
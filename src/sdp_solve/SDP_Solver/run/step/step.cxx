@@ -1,26 +1,36 @@
 #include "../../../SDP_Solver.hxx"
 
-// Tr(A B), where A and B are symmetric
-El::BigFloat frobenius_product_symmetric(const Block_Diagonal_Matrix &A,
-                                         const Block_Diagonal_Matrix &B);
-
 void initialize_schur_complement_solver(
   const Block_Info &block_info, const SDP &sdp,
   const Block_Diagonal_Matrix &bilinear_pairings_X_inv,
-  const Block_Diagonal_Matrix &bilinear_pairings_Y, const El::Grid &block_grid,
+  const Block_Diagonal_Matrix &bilinear_pairings_Y,
+  const Multiply_Backend &multiply_backend, const size_t &schur_precision,
+  Thread_Pool &thread_pool, Block_Diagonal_Matrix &schur_complement,
   Block_Diagonal_Matrix &schur_complement_cholesky,
-  Block_Matrix &schur_off_diagonal, El::DistMatrix<El::BigFloat> &Q,
-  Timers &timers);
+  Block_Matrix &schur_off_diagonal, El::DistMatrix<El::BigFloat> &Q_group,
+  std::list<Synchronize_Q_Plan> &synchronize_Q_plans,
+  El::DistMatrix<El::BigFloat> &Q, Timers &timers);
 
 void compute_search_direction(
   const Block_Info &block_info, const SDP &sdp, const SDP_Solver &solver,
   const Block_Diagonal_Matrix &schur_complement_cholesky,
   const Block_Matrix &schur_off_diagonal,
-  const Block_Diagonal_Matrix &X_cholesky, const El::BigFloat beta,
+  const Block_Diagonal_Matrix &X_cholesky,
+  const Cholesky_Inverse &X_cholesky_inverse, const El::BigFloat beta,
   const El::BigFloat &mu, const Block_Vector &primal_residue_p,
-  const bool &is_corrector_phase, const El::DistMatrix<El::BigFloat> &Q,
+  const bool &is_corrector_phase, const Multiply_Backend &multiply_backend,
+  Thread_Pool &thread_pool, const El::DistMatrix<El::BigFloat> &Q,
+  const Block_Diagonal_Matrix &schur_complement,
+  const size_t &schur_precision, const size_t &max_schur_refinements,
+  Block_Diagonal_Matrix &work, Block_Diagonal_Matrix &R,
+  Block_Diagonal_Matrix &Z,
+  std::vector<El::DistMatrix<El::BigFloat>> &scaled_bases,
+  Block_Vector &schur_rhs_dx, Block_Vector &schur_rhs_dy,
+  Block_Vector &schur_residue_dx, Block_Vector &schur_residue_dy,
+  Block_Vector &schur_correction_dx, Block_Vector &schur_correction_dy,
   Block_Vector &dx, Block_Diagonal_Matrix &dX, Block_Vector &dy,
-  Block_Diagonal_Matrix &dY);
+  Block_Diagonal_Matrix &dY, size_t &num_schur_refinements,
+  El::BigFloat &schur_residue);
 
 El::BigFloat
 predictor_centering_parameter(const SDP_Solver_Parameters &parameters,
@@ -34,19 +44,35 @@ El::BigFloat corrector_centering_parameter(
 
 El::BigFloat
 step_length(const Block_Diagonal_Matrix &MCholesky,
+            const Cholesky_Inverse &MCholesky_inverse,
             const Block_Diagonal_Matrix &dM, const El::BigFloat &gamma,
-            const std::string &timer_name, Timers &timers);
+            Block_Diagonal_Matrix &MInvDM, const std::string &timer_name,
+            Timers &timers);
+
+void step_lengths(const Block_Diagonal_Matrix &X,
+                  const Block_Diagonal_Matrix &X_cholesky,
+                  const Cholesky_Inverse &X_cholesky_inverse,
+                  const Block_Diagonal_Matrix &dX,
+                  const Block_Diagonal_Matrix &Y,
+                  const Block_Diagonal_Matrix &Y_cholesky,
+                  const Block_Diagonal_Matrix &dY, const El::BigFloat &gamma,
+                  Thread_Pool &thread_pool, Block_Diagonal_Matrix &X_work,
+                  Block_Diagonal_Matrix &Y_work,
+                  El::BigFloat &primal_step_length,
+                  El::BigFloat &dual_step_length, Timers &timers);
 
 void SDP_Solver::step(const SDP_Solver_Parameters &parameters,
                       const std::size_t &total_psd_rows,
                       const bool &is_primal_and_dual_feasible,
                       const Block_Info &block_info, const SDP &sdp,
-                      const El::Grid &grid,
+                      Thread_Pool &thread_pool,
                       const Block_Diagonal_Matrix &X_cholesky,
+                      const Cholesky_Inverse &X_cholesky_inverse,
                       const Block_Diagonal_Matrix &Y_cholesky,
                       const Block_Diagonal_Matrix &bilinear_pairings_X_inv,
                       const Block_Diagonal_Matrix &bilinear_pairings_Y,
-                      const Block_Vector &primal_residue_p, El::BigFloat &mu,
+                      const Block_Vector &primal_residue_p,
+                      const El::BigFloat &mu,
                       El::BigFloat &beta_corrector,
                       El::BigFloat &primal_step_length,
                       El::BigFloat &dual_step_length,
@@ -55,21 +81,15 @@ void SDP_Solver::step(const SDP_Solver_Parameters &parameters,
   auto &step_timer(timers.add_and_start("run.step"));
   El::BigFloat beta_predictor;
 
-  // Search direction: These quantities have the same structure
-  // as (x, X, y, Y). They are computed twice each iteration:
-  // once in the predictor step, and once in the corrector step.
-  Block_Vector dx(x), dy(y);
-  Block_Diagonal_Matrix dX(X), dY(Y);
+  // The search direction, Schur complement solver data, and other
+  // temporaries live in 'workspace' so that they are only allocated
+  // once.  See SDP_Solver_Workspace.hxx for descriptions.
+  Block_Vector &dx(workspace.dx), &dy(workspace.dy);
+  Block_Diagonal_Matrix &dX(workspace.dX), &dY(workspace.dY);
   {
-    // SchurComplementCholesky = L', the Cholesky decomposition of the
-    // Schur complement matrix S.
-    Block_Diagonal_Matrix schur_complement_cholesky(
-      block_info.schur_block_sizes, block_info.block_indices,
-      block_info.schur_block_sizes.size(), grid);
-
-    // SchurOffDiagonal = L'^{-1} FreeVarMatrix, needed in solving the
-    // Schur complement equation.
-    Block_Matrix schur_off_diagonal;
+    Block_Diagonal_Matrix &schur_complement_cholesky(
+      workspace.schur_complement_cholesky);
+    Block_Matrix &schur_off_diagonal(workspace.schur_off_diagonal);
 
     // Q = B' L'^{-T} L'^{-1} B' - {{0, 0}, {0, 1}}, where B' =
     // (FreeVarMatrix U).  Q is needed in the factorization of the Schur
@@ -77,22 +97,24 @@ void SDP_Solver::step(const SDP_Solver_Parameters &parameters,
     //
     //   N' = cols(B) + cols(U) = N + cols(U)
     //
-    // where N is the dimension of the dual objective function.  Note
-    // that N' could change with each iteration.
-    El::DistMatrix<El::BigFloat> Q(sdp.dual_objective_b.Height(),
-                                   sdp.dual_objective_b.Height());
+    // where N is the dimension of the dual objective function.
+    El::DistMatrix<El::BigFloat> &Q(workspace.Q);
 
     // Compute SchurComplement and prepare to solve the Schur
     // complement equation for dx, dy
+    // If the Schur complement solver is factored at a lower
+    // precision, each search direction is refined with S itself.
+    const size_t schur_precision(
+      parameters.is_mixed_precision() ? parameters.schur_precision : 0);
     initialize_schur_complement_solver(
-      block_info, sdp, bilinear_pairings_X_inv, bilinear_pairings_Y, grid,
-      schur_complement_cholesky, schur_off_diagonal, Q, timers);
-
-    // Compute the complementarity mu = Tr(X Y)/X.dim
-    auto &frobenius_timer(
-      timers.add_and_start("run.step.frobenius_product_symmetric"));
-    mu = frobenius_product_symmetric(X, Y) / total_psd_rows;
-    frobenius_timer.stop();
+      block_info, sdp, bilinear_pairings_X_inv, bilinear_pairings_Y,
+      parameters.multiply_backend, schur_precision, thread_pool,
+      workspace.schur_complement, schur_complement_cholesky,
+      schur_off_diagonal, workspace.Q_group, workspace.synchronize_Q_plans,
+      Q, timers);
+
+    // The complementarity mu = Tr(X Y)/X.dim was computed in run(),
+    // along with the other scalars that need a reduction.
     if(mu > parameters.max_complementarity)
       {
         terminate_now = true;
@@ -105,9 +127,19 @@ void SDP_Solver::step(const SDP_Solver_Parameters &parameters,
     // Compute the predictor solution for (dx, dX, dy, dY)
     beta_predictor
       = predictor_centering_parameter(parameters, is_primal_and_dual_feasible);
-    compute_search_direction(block_info, sdp, *this, schur_complement_cholesky,
-                             schur_off_diagonal, X_cholesky, beta_predictor,
-                             mu, primal_residue_p, false, Q, dx, dX, dy, dY);
+    size_t predictor_refinements(0), corrector_refinements(0);
+    El::BigFloat predictor_residue(0), corrector_residue(0);
+    compute_search_direction(
+      block_info, sdp, *this, schur_complement_cholesky, schur_off_diagonal,
+      X_cholesky, X_cholesky_inverse, beta_predictor, mu, primal_residue_p,
+      false, parameters.multiply_backend, thread_pool, Q,
+      workspace.schur_complement, schur_precision,
+      parameters.max_schur_refinements, workspace.MInvDM, workspace.R,
+      workspace.Z, workspace.scaled_bases,
+      workspace.schur_rhs_dx, workspace.schur_rhs_dy,
+      workspace.schur_residue_dx, workspace.schur_residue_dy,
+      workspace.schur_correction_dx, workspace.schur_correction_dy, dx, dX,
+      dy, dY, predictor_refinements, predictor_residue);
     predictor_timer.stop();
 
     // Compute the corrector solution for (dx, dX, dy, dY)
@@ -117,19 +149,41 @@ void SDP_Solver::step(const SDP_Solver_Parameters &parameters,
       parameters, X, dX, Y, dY, mu, is_primal_and_dual_feasible,
       total_psd_rows);
 
-    compute_search_direction(block_info, sdp, *this, schur_complement_cholesky,
-                             schur_off_diagonal, X_cholesky, beta_corrector,
-                             mu, primal_residue_p, true, Q, dx, dX, dy, dY);
+    compute_search_direction(
+      block_info, sdp, *this, schur_complement_cholesky, schur_off_diagonal,
+      X_cholesky, X_cholesky_inverse, beta_corrector, mu, primal_residue_p,
+      true, parameters.multiply_backend, thread_pool, Q,
+      workspace.schur_complement, schur_precision,
+      parameters.max_schur_refinements, workspace.MInvDM, workspace.R,
+      workspace.Z, workspace.scaled_bases,
+      workspace.schur_rhs_dx, workspace.schur_rhs_dy,
+      workspace.schur_residue_dx, workspace.schur_residue_dy,
+      workspace.schur_correction_dx, workspace.schur_correction_dy, dx, dX,
+      dy, dY, corrector_refinements, corrector_residue);
     corrector_timer.stop();
+
+    num_schur_refinements = predictor_refinements + corrector_refinements;
+    schur_residue = El::Max(predictor_residue, corrector_residue);
   }
   // Compute step-lengths that preserve positive definiteness of X, Y
-  primal_step_length
-    = step_length(X_cholesky, dX, parameters.step_length_reduction,
-                  "run.step.stepLength(XCholesky)", timers);
-
-  dual_step_length
-    = step_length(Y_cholesky, dY, parameters.step_length_reduction,
-                  "run.step.stepLength(YCholesky)", timers);
+  if(parameters.step_length_method == Step_Length_Method::lanczos)
+    {
+      step_lengths(X, X_cholesky, X_cholesky_inverse, dX, Y, Y_cholesky, dY,
+                   parameters.step_length_reduction, thread_pool,
+                   workspace.MInvDM, workspace.R, primal_step_length,
+                   dual_step_length, timers);
+    }
+  else
+    {
+      primal_step_length = step_length(
+        X_cholesky, X_cholesky_inverse, dX, parameters.step_length_reduction,
+        workspace.MInvDM, "run.step.stepLength(XCholesky)", timers);
+
+      // L^{-1} is not cached for Y.
+      dual_step_length = step_length(
+        Y_cholesky, Cholesky_Inverse(), dY, parameters.step_length_reduction,
+        workspace.MInvDM, "run.step.stepLength(YCholesky)", timers);
+    }
 
   // If our problem is both dual-feasible and primal-feasible,
   // ensure we're following the true Newton direction.
@@ -0,0 +1,28 @@
+#include <El.hpp>
+
+// Minimum eigenvalue of a single block, which is assumed to be
+// symmetric.  The result is the same on every rank in the block's
+// grid.
+
+// Annoyingly, El::HermitianEig modifies 'block'.  It is OK, because
+// the callers pass in a temporary.  Still ugly.
+El::BigFloat block_min_eigenvalue(El::DistMatrix<El::BigFloat> &block)
+{
+  El::DistMatrix<El::BigFloat, El::VR, El::STAR> eigenvalues(block.Grid());
+  /// There is a bug in El::HermitianEig when there is more than
+  /// one level of recursion when computing eigenvalues.  One fix
+  /// is to increase the cutoff so that there is no more than one
+  /// level of recursion.
+
+  /// An alternate workaround is to compute both eigenvalues and
+  /// eigenvectors, but that seems to be significantly slower.
+  El::HermitianEigCtrl<El::BigFloat> hermitian_eig_ctrl;
+  hermitian_eig_ctrl.tridiagEigCtrl.dcCtrl.cutoff = block.Height() / 2 + 1;
+
+  /// The default number of iterations is 40.  That is sometimes
+  /// not enough, so we bump it up significantly.
+  hermitian_eig_ctrl.tridiagEigCtrl.dcCtrl.secularCtrl.maxIterations = 16384;
+  El::HermitianEig(El::UpperOrLowerNS::LOWER, block, eigenvalues,
+                   hermitian_eig_ctrl);
+  return El::Min(eigenvalues);
+}
@@ -1,16 +1,23 @@
-#include "../../../../Block_Diagonal_Matrix.hxx"
+#include "../../../../Cholesky_Inverse.hxx"
 
-// A := L^{-1} A L^{-T}
+// A := L^{-1} A L^{-T}, using L_inverse for the blocks where it is
+// cached.  Blocks on a single rank use the local matrices.
 void lower_triangular_inverse_congruence(const Block_Diagonal_Matrix &L,
+                                         const Cholesky_Inverse &L_inverse,
                                          Block_Diagonal_Matrix &A)
 {
   for(size_t b = 0; b < A.blocks.size(); b++)
     {
-      El::Trsm(El::LeftOrRight::RIGHT, El::UpperOrLowerNS::LOWER,
-               El::Orientation::TRANSPOSE, El::UnitOrNonUnit::NON_UNIT,
-               El::BigFloat(1), L.blocks[b], A.blocks[b]);
-      El::Trsm(El::LeftOrRight::LEFT, El::UpperOrLowerNS::LOWER,
-               El::Orientation::NORMAL, El::UnitOrNonUnit::NON_UNIT,
-               El::BigFloat(1), L.blocks[b], A.blocks[b]);
+      if(A.blocks[b].Grid().Size() == 1)
+        {
+          inverse_congruence_block(L.blocks[b].LockedMatrix(),
+                                   L_inverse.local_block(b),
+                                   A.blocks[b].Matrix());
+        }
+      else
+        {
+          inverse_congruence_block(L.blocks[b], L_inverse.block(b),
+                                   A.blocks[b]);
+        }
     }
 }
@@ -1,4 +1,5 @@
 #include "../../../../SDP_Solver.hxx"
+#include "../../../../Cholesky_Inverse.hxx"
 
 // min(gamma \alpha(M, dM), 1), where \alpha(M, dM) denotes the
 // largest positive real number such that M + \alpha dM is positive
@@ -11,30 +12,38 @@
 //
 // Inputs:
 // - MCholesky = L, the Cholesky decomposition of M (M itself is not needed)
+// - MCholesky_inverse, L^{-1} for the blocks where it is cached
 // - dM, a Block_Diagonal_Matrix with the same structure as M
 // Workspace:
-// - MInvDM (NB: overwritten when computing minEigenvalue)
+// - MInvDM, with the same structure as dM (NB: overwritten when
+//   computing minEigenvalue)
 // - eigenvalues, a Vector of eigenvalues for each block of M
 // Output:
 // - min(\gamma \alpha(M, dM), 1) (returned)
 
 // A := L^{-1} A L^{-T}
 void lower_triangular_inverse_congruence(const Block_Diagonal_Matrix &L,
+                                         const Cholesky_Inverse &L_inverse,
                                          Block_Diagonal_Matrix &A);
 
 El::BigFloat min_eigenvalue(Block_Diagonal_Matrix &A);
 
 El::BigFloat step_length(const Block_Diagonal_Matrix &MCholesky,
+                         const Cholesky_Inverse &MCholesky_inverse,
                          const Block_Diagonal_Matrix &dM,
                          const El::BigFloat &gamma,
+                         Block_Diagonal_Matrix &MInvDM,
                          const std::string &timer_name,
                          Timers &timers)
 {
   auto &step_length_timer(
         timers.add_and_start(timer_name));
   // MInvDM = L^{-1} dM L^{-T}, where M = L L^T
-  Block_Diagonal_Matrix MInvDM(dM);
-  lower_triangular_inverse_congruence(MCholesky, MInvDM);
+  {
+    Solver_Allocation_Scope allocation_scope;
+    MInvDM = dM;
+  }
+  lower_triangular_inverse_congruence(MCholesky, MCholesky_inverse, MInvDM);
   const El::BigFloat lambda(min_eigenvalue(MInvDM));
   step_length_timer.stop();
   if(lambda > -gamma)
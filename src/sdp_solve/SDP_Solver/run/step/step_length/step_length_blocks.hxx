@@ -0,0 +1,149 @@
+#pragma once
+
+#include <El.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+// The pieces of step_lengths() that work on one block.  These work
+// the same way for El::Matrix, for blocks that live on a single rank,
+// and for El::DistMatrix.
+
+void tridiagonal_min_eigenvalue(const std::vector<El::BigFloat> &alpha,
+                                const std::vector<El::BigFloat> &beta,
+                                El::BigFloat &eigenvalue,
+                                El::BigFloat &last_component);
+
+// An empty matrix on the same grid as A
+inline El::Matrix<El::BigFloat> matrix_like(const El::Matrix<El::BigFloat> &)
+{
+  return El::Matrix<El::BigFloat>();
+}
+
+inline El::DistMatrix<El::BigFloat>
+matrix_like(const El::DistMatrix<El::BigFloat> &A)
+{
+  return El::DistMatrix<El::BigFloat>(A.Grid());
+}
+
+// Blocks that need more iterations than this go to the dense path.
+constexpr int64_t max_lanczos_iterations(64);
+
+// Estimate the smallest eigenvalue of L^{-1} dM L^{-T} with the
+// Lanczos method.  L^{-1} dM L^{-T} is never formed: each iteration
+// only needs two triangular solves and one matrix-vector product with
+// dM.  Every new vector is orthogonalized twice against all of the
+// previous ones, so that no spurious copies of the eigenvalue show
+// up.
+//
+// The estimate is the smallest eigenvalue theta of the tridiagonal
+// matrix T from the Lanczos recurrence.  It is an upper bound on the
+// true eigenvalue, and is within the residual |beta_k s_k| of some
+// eigenvalue, where s is the eigenvector of T.  We stop when the
+// residual is below 2^{-precision/2} times the size of T, which makes
+// theta accurate to about the working precision.  Returns false if
+// that does not happen within max_lanczos_iterations.
+template <class Matrix>
+bool lanczos_min_eigenvalue(const Matrix &L, const Matrix &dM,
+                            El::BigFloat &eigenvalue)
+{
+  const int64_t height(L.Height()),
+    max_iterations(std::min(height, max_lanczos_iterations));
+  const El::BigFloat epsilon(El::limits::Epsilon<El::BigFloat>());
+  El::BigFloat tolerance(1);
+  mpf_div_2exp(tolerance.gmp_float.get_mpf_t(),
+               tolerance.gmp_float.get_mpf_t(), mpf_get_default_prec() / 2);
+
+  Matrix basis(matrix_like(L)), product(matrix_like(L)),
+    overlaps(matrix_like(L));
+  El::Zeros(basis, height, max_iterations + 1);
+
+  // A fixed but irregular starting vector, so that every rank in the
+  // grid agrees and runs are reproducible.
+  for(int64_t row = 0; row < height; ++row)
+    {
+      basis.Set(row, 0,
+                El::BigFloat(static_cast<double>((row * 7919) % 1009) / 504
+                             - 1));
+    }
+  {
+    Matrix first(El::View(basis, 0, 0, height, 1));
+    El::Scale(El::BigFloat(1) / El::Nrm2(first), first);
+  }
+
+  std::vector<El::BigFloat> alpha, beta;
+  El::BigFloat scale(0), last_component;
+  for(int64_t iteration = 0; iteration < max_iterations; ++iteration)
+    {
+      Matrix current(El::View(basis, 0, iteration, height, 1)),
+        next(El::View(basis, 0, iteration + 1, height, 1));
+
+      // next = L^{-1} dM L^{-T} current
+      El::Copy(current, product);
+      El::Trsm(El::LeftOrRight::LEFT, El::UpperOrLowerNS::LOWER,
+               El::Orientation::TRANSPOSE, El::UnitOrNonUnit::NON_UNIT,
+               El::BigFloat(1), L, product);
+      El::Gemv(El::Orientation::NORMAL, El::BigFloat(1), dM, product,
+               El::BigFloat(0), next);
+      El::Trsm(El::LeftOrRight::LEFT, El::UpperOrLowerNS::LOWER,
+               El::Orientation::NORMAL, El::UnitOrNonUnit::NON_UNIT,
+               El::BigFloat(1), L, next);
+      alpha.push_back(El::Dot(current, next));
+
+      // This also takes out the alpha and beta terms of the usual
+      // three term recurrence.
+      const Matrix previous(
+        El::LockedView(basis, 0, 0, height, iteration + 1));
+      for(size_t pass = 0; pass < 2; ++pass)
+        {
+          El::Zeros(overlaps, iteration + 1, 1);
+          El::Gemv(El::Orientation::TRANSPOSE, El::BigFloat(1), previous,
+                   next, El::BigFloat(0), overlaps);
+          El::Gemv(El::Orientation::NORMAL, El::BigFloat(-1), previous,
+                   overlaps, El::BigFloat(1), next);
+        }
+      const El::BigFloat next_norm(El::Nrm2(next));
+
+      scale = El::Max(scale, El::Abs(alpha.back()));
+      scale = El::Max(scale, next_norm);
+
+      // If next vanishes, the basis spans an invariant subspace and
+      // T is exact.  Otherwise, T is only solved every few
+      // iterations, since that takes about as long as a few
+      // matrix-vector products.
+      const bool breakdown(next_norm <= epsilon * scale);
+      if(breakdown || (iteration + 1) % 8 == 0
+         || iteration + 1 == max_iterations)
+        {
+          tridiagonal_min_eigenvalue(alpha, beta, eigenvalue,
+                                     last_component);
+          if(breakdown || next_norm * last_component <= tolerance * scale)
+            {
+              return true;
+            }
+        }
+      El::Scale(El::BigFloat(1) / next_norm, next);
+      beta.push_back(next_norm);
+    }
+  return false;
+}
+
+// Whether M + step dM is numerically positive definite, according to
+// whether its Cholesky decomposition succeeds.  work is overwritten.
+template <class Matrix>
+bool is_positive_definite_step(const Matrix &M, const Matrix &dM,
+                               const El::BigFloat &step, Matrix &work)
+{
+  El::Copy(M, work);
+  El::Axpy(step, dM, work);
+  try
+    {
+      El::Cholesky(El::UpperOrLowerNS::LOWER, work);
+    }
+  catch(std::exception &)
+    {
+      return false;
+    }
+  return true;
+}
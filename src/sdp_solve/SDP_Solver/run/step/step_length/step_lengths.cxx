@@ -0,0 +1,272 @@
+#include "step_length_blocks.hxx"
+#include "../../../../Cholesky_Inverse.hxx"
+#include "../../../../Thread_Pool.hxx"
+#include "../../../../../Timers.hxx"
+
+#include <array>
+
+// The primal and dual step lengths min(gamma \alpha(X, dX), 1) and
+// min(gamma \alpha(Y, dY), 1), as in step_length(), but without
+// computing every eigenvalue of L^{-1} dM L^{-T}.
+//
+// 1. Estimate the smallest eigenvalue lambda of each block with
+//    lanczos_min_eigenvalue.  Blocks where Lanczos does not converge
+//    use the dense eigenvalue solver instead.
+//
+// 2. The Lanczos estimates are upper bounds on lambda, so they can
+//    only make the step too long.  Lower each estimate by a relative
+//    margin of 2^{-precision/4}, which is larger than the error of a
+//    converged estimate.  Take the minimum over all blocks and ranks,
+//    for X and Y at the same time, and turn it into a step length.
+//
+// 3. Check each estimated block with a trial Cholesky decomposition
+//    of M + (step/gamma) dM.  This passes only if step/gamma is
+//    shorter than \alpha(M, dM), so the step that is taken is never
+//    longer than the gamma \alpha(M, dM) that step_length() would
+//    give.  Blocks that fail are redone with the dense eigenvalue
+//    solver, and the minimum is taken again.
+//
+// The dense solver uses X_cholesky_inverse for the blocks of X where
+// it is cached.  Lanczos always uses triangular solves, since it only
+// works with vectors, and a triangular solve with a vector costs the
+// same as a multiplication by L^{-1}.
+//
+// Blocks of X and Y that live on a single rank are spread over the
+// threads in thread_pool.  The rest need MPI, so they are done by the
+// main thread.  X_work and Y_work have the same structure as X, and
+// are overwritten.  The time for each block is added to timers as the
+// "step_length" stage.
+
+El::BigFloat block_min_eigenvalue(El::DistMatrix<El::BigFloat> &block);
+
+namespace
+{
+  // The smallest eigenvalue of L^{-1} dM L^{-T}, using
+  // El::HermitianEig.
+  El::BigFloat
+  dense_min_eigenvalue(const El::DistMatrix<El::BigFloat> &L,
+                       const El::DistMatrix<El::BigFloat> *L_inverse,
+                       const El::DistMatrix<El::BigFloat> &dM,
+                       El::DistMatrix<El::BigFloat> &work)
+  {
+    {
+      Solver_Allocation_Scope allocation_scope;
+      work = dM;
+    }
+    inverse_congruence_block(L, L_inverse, work);
+    return block_min_eigenvalue(work);
+  }
+
+  // Turn the smallest eigenvalue of L^{-1} dM L^{-T} into a step
+  // length.
+  El::BigFloat
+  step_from_eigenvalue(const El::BigFloat &lambda, const El::BigFloat &gamma)
+  {
+    if(lambda > -gamma)
+      {
+        return 1;
+      }
+    else
+      {
+        return -gamma / lambda;
+      }
+  }
+}
+
+void step_lengths(const Block_Diagonal_Matrix &X,
+                  const Block_Diagonal_Matrix &X_cholesky,
+                  const Cholesky_Inverse &X_cholesky_inverse,
+                  const Block_Diagonal_Matrix &dX,
+                  const Block_Diagonal_Matrix &Y,
+                  const Block_Diagonal_Matrix &Y_cholesky,
+                  const Block_Diagonal_Matrix &dY, const El::BigFloat &gamma,
+                  Thread_Pool &thread_pool, Block_Diagonal_Matrix &X_work,
+                  Block_Diagonal_Matrix &Y_work,
+                  El::BigFloat &primal_step_length,
+                  El::BigFloat &dual_step_length, Timers &timers)
+{
+  auto &step_length_timer(timers.add_and_start("run.step.stepLength"));
+
+  // Index 0 is X, and index 1 is Y.  L^{-1} is not cached for Y.
+  const Cholesky_Inverse no_inverse;
+  const std::array<const Block_Diagonal_Matrix *, 2> M{&X, &Y},
+    M_cholesky{&X_cholesky, &Y_cholesky}, dM{&dX, &dY};
+  const std::array<const Cholesky_Inverse *, 2> M_cholesky_inverse{
+    &X_cholesky_inverse, &no_inverse};
+  const std::array<Block_Diagonal_Matrix *, 2> work{&X_work, &Y_work};
+
+  struct Task
+  {
+    size_t matrix, block;
+  };
+  std::vector<Task> local_tasks, distributed_tasks, all_tasks;
+  for(size_t matrix = 0; matrix < 2; ++matrix)
+    for(size_t block = 0; block < dM[matrix]->blocks.size(); ++block)
+      {
+        const El::DistMatrix<El::BigFloat> &dM_block(
+          dM[matrix]->blocks[block]);
+        if(dM_block.Height() == 0)
+          {
+            continue;
+          }
+        (dM_block.Grid().Size() == 1 ? local_tasks : distributed_tasks)
+          .push_back({matrix, block});
+        all_tasks.push_back({matrix, block});
+      }
+
+  // The estimate of lambda for each block, whether it came from
+  // Lanczos, and whether it passed the trial Cholesky check.  'char'
+  // rather than 'bool' so that the threads can write to different
+  // elements at the same time.
+  std::array<std::vector<El::BigFloat>, 2> eigenvalues;
+  std::array<std::vector<char>, 2> is_estimate, is_certified;
+  std::array<std::vector<Timers::Clock::duration>, 2> elapsed;
+  for(size_t matrix = 0; matrix < 2; ++matrix)
+    {
+      eigenvalues[matrix].resize(dM[matrix]->blocks.size(),
+                                 El::limits::Max<El::BigFloat>());
+      is_estimate[matrix].resize(dM[matrix]->blocks.size(), 0);
+      is_certified[matrix].resize(dM[matrix]->blocks.size(), 1);
+      elapsed[matrix].resize(dM[matrix]->blocks.size(),
+                             Timers::Clock::duration(0));
+    }
+
+  auto &lanczos_timer(timers.add_and_start("run.step.stepLength.lanczos"));
+  thread_pool.parallel_for(
+    local_tasks.size(), [&](const size_t &index, const size_t &) {
+      const Task &task(local_tasks[index]);
+      const auto start(Timers::Clock::now());
+      is_estimate[task.matrix][task.block] = lanczos_min_eigenvalue(
+        M_cholesky[task.matrix]->blocks[task.block].LockedMatrix(),
+        dM[task.matrix]->blocks[task.block].LockedMatrix(),
+        eigenvalues[task.matrix][task.block]);
+      elapsed[task.matrix][task.block] += Timers::Clock::now() - start;
+    });
+  for(auto &task : distributed_tasks)
+    {
+      const auto start(Timers::Clock::now());
+      is_estimate[task.matrix][task.block] = lanczos_min_eigenvalue(
+        M_cholesky[task.matrix]->blocks[task.block],
+        dM[task.matrix]->blocks[task.block],
+        eigenvalues[task.matrix][task.block]);
+      elapsed[task.matrix][task.block] += Timers::Clock::now() - start;
+    }
+  El::BigFloat margin(1);
+  mpf_div_2exp(margin.gmp_float.get_mpf_t(), margin.gmp_float.get_mpf_t(),
+               mpf_get_default_prec() / 4);
+  for(auto &task : all_tasks)
+    {
+      if(is_estimate[task.matrix][task.block])
+        {
+          El::BigFloat &eigenvalue(eigenvalues[task.matrix][task.block]);
+          eigenvalue -= El::Abs(eigenvalue) * margin;
+        }
+    }
+  lanczos_timer.stop();
+
+  auto &dense_timer(timers.add_and_start("run.step.stepLength.dense"));
+  for(auto &task : all_tasks)
+    {
+      if(!is_estimate[task.matrix][task.block])
+        {
+          const auto start(Timers::Clock::now());
+          eigenvalues[task.matrix][task.block] = dense_min_eigenvalue(
+            M_cholesky[task.matrix]->blocks[task.block],
+            M_cholesky_inverse[task.matrix]->block(task.block),
+            dM[task.matrix]->blocks[task.block],
+            work[task.matrix]->blocks[task.block]);
+          elapsed[task.matrix][task.block] += Timers::Clock::now() - start;
+        }
+    }
+  dense_timer.stop();
+
+  // The minimum over all blocks and ranks, turned into step lengths
+  std::array<El::BigFloat, 2> steps;
+  auto reduce_steps([&]() {
+    std::array<El::BigFloat, 2> lambdas;
+    for(size_t matrix = 0; matrix < 2; ++matrix)
+      {
+        lambdas[matrix] = El::limits::Max<El::BigFloat>();
+        for(auto &eigenvalue : eigenvalues[matrix])
+          {
+            lambdas[matrix] = El::Min(lambdas[matrix], eigenvalue);
+          }
+      }
+    El::mpi::AllReduce(lambdas.data(), 2, El::mpi::MIN, El::mpi::COMM_WORLD);
+    for(size_t matrix = 0; matrix < 2; ++matrix)
+      {
+        steps[matrix] = step_from_eigenvalue(lambdas[matrix], gamma);
+      }
+  });
+  reduce_steps();
+
+  std::array<El::BigFloat, 2> trial_steps;
+  for(size_t matrix = 0; matrix < 2; ++matrix)
+    {
+      trial_steps[matrix] = steps[matrix] / gamma;
+    }
+
+  auto &certify_timer(timers.add_and_start("run.step.stepLength.certify"));
+  thread_pool.parallel_for(
+    local_tasks.size(), [&](const size_t &index, const size_t &) {
+      const Task &task(local_tasks[index]);
+      if(is_estimate[task.matrix][task.block])
+        {
+          const auto start(Timers::Clock::now());
+          is_certified[task.matrix][task.block] = is_positive_definite_step(
+            M[task.matrix]->blocks[task.block].LockedMatrix(),
+            dM[task.matrix]->blocks[task.block].LockedMatrix(),
+            trial_steps[task.matrix],
+            work[task.matrix]->blocks[task.block].Matrix());
+          elapsed[task.matrix][task.block] += Timers::Clock::now() - start;
+        }
+    });
+  for(auto &task : distributed_tasks)
+    {
+      if(is_estimate[task.matrix][task.block])
+        {
+          const auto start(Timers::Clock::now());
+          is_certified[task.matrix][task.block] = is_positive_definite_step(
+            M[task.matrix]->blocks[task.block],
+            dM[task.matrix]->blocks[task.block], trial_steps[task.matrix],
+            work[task.matrix]->blocks[task.block]);
+          elapsed[task.matrix][task.block] += Timers::Clock::now() - start;
+        }
+    }
+  certify_timer.stop();
+
+  // Every rank has to take part in the second reduction, even if all
+  // of its own blocks passed.
+  auto &recheck_timer(timers.add_and_start("run.step.stepLength.recheck"));
+  int num_failed(0);
+  for(auto &task : all_tasks)
+    {
+      if(!is_certified[task.matrix][task.block])
+        {
+          ++num_failed;
+          const auto start(Timers::Clock::now());
+          eigenvalues[task.matrix][task.block] = dense_min_eigenvalue(
+            M_cholesky[task.matrix]->blocks[task.block],
+            M_cholesky_inverse[task.matrix]->block(task.block),
+            dM[task.matrix]->blocks[task.block],
+            work[task.matrix]->blocks[task.block]);
+          elapsed[task.matrix][task.block] += Timers::Clock::now() - start;
+        }
+    }
+  if(El::mpi::AllReduce(num_failed, El::mpi::SUM, El::mpi::COMM_WORLD) > 0)
+    {
+      reduce_steps();
+    }
+  recheck_timer.stop();
+
+  // Both parities of a block are at 2*block and 2*block + 1.
+  for(auto &task : all_tasks)
+    {
+      timers.add_block_elapsed("step_length", task.block / 2,
+                               elapsed[task.matrix][task.block]);
+    }
+
+  primal_step_length = steps[0];
+  dual_step_length = steps[1];
+  step_length_timer.stop();
+}
@@ -0,0 +1,123 @@
+#include <El.hpp>
+
+#include <vector>
+
+// The smallest eigenvalue of the symmetric tridiagonal matrix T with
+// diagonal alpha and off-diagonal beta, and the absolute value of the
+// last component of the corresponding normalized eigenvector.
+//
+// The eigenvalue is found by bisection on the Sturm count: the number
+// of eigenvalues of T less than x is the number of negative pivots in
+// the LDL^T factorization of T - x I.  This converges to the working
+// precision, and cannot pick up a larger eigenvalue by mistake.  The
+// eigenvector comes from two steps of inverse iteration.
+//
+// T is at most a few hundred rows, so this is cheap compared to
+// anything done with the blocks themselves.
+
+namespace
+{
+  // Replace an exactly zero pivot with a tiny one, as in LAPACK's
+  // dstebz.
+  void guard_pivot(const El::BigFloat &tiny, El::BigFloat &pivot)
+  {
+    if(pivot == 0)
+      {
+        pivot = tiny;
+      }
+  }
+}
+
+void tridiagonal_min_eigenvalue(const std::vector<El::BigFloat> &alpha,
+                                const std::vector<El::BigFloat> &beta,
+                                El::BigFloat &eigenvalue,
+                                El::BigFloat &last_component)
+{
+  const size_t size(alpha.size());
+
+  // Gershgorin bounds on the spectrum
+  El::BigFloat lower(alpha[0]), upper(alpha[0]);
+  for(size_t row = 0; row < size; ++row)
+    {
+      El::BigFloat radius(0);
+      if(row > 0)
+        {
+          radius += El::Abs(beta[row - 1]);
+        }
+      if(row + 1 < size)
+        {
+          radius += El::Abs(beta[row]);
+        }
+      lower = El::Min(lower, alpha[row] - radius);
+      upper = El::Max(upper, alpha[row] + radius);
+    }
+  const El::BigFloat scale(El::Max(El::Abs(lower), El::Abs(upper))),
+    tiny(El::limits::Epsilon<El::BigFloat>() * scale);
+  if(scale == 0)
+    {
+      eigenvalue = 0;
+      last_component = 1;
+      return;
+    }
+
+  while(upper - lower > tiny)
+    {
+      const El::BigFloat middle((lower + upper) / 2);
+      if(middle == lower || middle == upper)
+        {
+          break;
+        }
+      size_t num_negative(0);
+      El::BigFloat pivot(alpha[0] - middle);
+      for(size_t row = 0;; ++row)
+        {
+          guard_pivot(tiny, pivot);
+          if(pivot < 0)
+            {
+              ++num_negative;
+            }
+          if(row + 1 == size)
+            {
+              break;
+            }
+          pivot = alpha[row + 1] - middle - beta[row] * beta[row] / pivot;
+        }
+      (num_negative > 0 ? upper : lower) = middle;
+    }
+  eigenvalue = upper;
+
+  // Inverse iteration: solve (T - eigenvalue I) x = v with the
+  // tridiagonal LU factorization, starting from v = (1, ..., 1).
+  std::vector<El::BigFloat> vector(size, El::BigFloat(1)), ratios(size),
+    solution(size);
+  for(size_t iteration = 0; iteration < 2; ++iteration)
+    {
+      El::BigFloat pivot(alpha[0] - eigenvalue);
+      guard_pivot(tiny, pivot);
+      solution[0] = vector[0] / pivot;
+      for(size_t row = 1; row < size; ++row)
+        {
+          ratios[row - 1] = beta[row - 1] / pivot;
+          pivot = alpha[row] - eigenvalue - beta[row - 1] * ratios[row - 1];
+          guard_pivot(tiny, pivot);
+          solution[row]
+            = (vector[row] - beta[row - 1] * solution[row - 1]) / pivot;
+        }
+      for(size_t row = size - 1; row > 0; --row)
+        {
+          solution[row - 1] -= ratios[row - 1] * solution[row];
+        }
+
+      El::BigFloat norm(0);
+      for(auto &element : solution)
+        {
+          norm += element * element;
+        }
+      norm = El::Sqrt(norm);
+      for(size_t row = 0; row < size; ++row)
+        {
+          vector[row] = solution[row] / norm;
+        }
+    }
+  last_component = El::Abs(vector.back());
+}
@@ -0,0 +1,141 @@
+#include <El.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// result[p] -= Tr(A_p M)
+//
+// for each p = (j,r,s,k) in one block j, where M[0] and M[1] are the
+// two parity blocks of a Block_Diagonal_Matrix belonging to j, and
+//
+//   A_(j,r,s,k) = \sum_{b \in blocks[j]}
+//                     Block_b(v_{b,k} v_{b,k}^T \otimes E^{rs})
+//
+// as in constraint_matrix_weighted_sum.  The (r,s) sub-blocks of M[b]
+// have the same height as the bilinear base v_b.
+//
+// If bases is null, v_{b,k} is the k-th unit vector, so that
+//
+//   Tr(A_(j,r,s,k) M) = \sum_b (1/2) (M[b]_{ej r + k, ej s + k}
+//                                     + swap (r <-> s))
+//
+// where ej = d_j + 1.  This is how the dual residues get Tr(A_p Y)
+// from bilinear_pairings_Y.  Otherwise bases[0] and bases[1] are
+// complete local copies of the bilinear bases, and M must be
+// symmetric, so that only the sub-blocks with r <= s are read.  This
+// is how the Schur complement RHS gets Tr(A_p Z).
+//
+// Every element of M that lives on this rank is read once, without
+// any temporary matrices.  For each local column of the (r,s)
+// sub-blocks, \sum_i M_{ij} (v_k)_i is accumulated over the local
+// rows into a small buffer, which is then multiplied by (v_k)_j and
+// added to traces.  traces then holds this rank's share of every
+// Tr(A_p M) in the block, and a single reduction over the grid of M
+// gives the totals.  traces is only workspace.
+
+void subtract_constraint_traces(const El::DistMatrix<El::BigFloat> *M,
+                                const El::Matrix<El::BigFloat> *bases,
+                                const size_t &dimension,
+                                El::Matrix<El::BigFloat> &traces,
+                                El::DistMatrix<El::BigFloat> &result)
+{
+  const size_t K(result.Height() / ((dimension * (dimension + 1)) / 2));
+  El::Zeros(traces, result.Height(), 1);
+
+  El::BigFloat product;
+  std::vector<El::BigFloat> partial(bases == nullptr ? 0 : dimension * K);
+  for(size_t parity = 0; parity < 2; ++parity)
+    {
+      const El::DistMatrix<El::BigFloat> &block(M[parity]);
+      const El::Matrix<El::BigFloat> &block_local(block.LockedMatrix());
+      const size_t H(bases == nullptr ? K : bases[parity].Height());
+
+      for(int64_t column = 0; column < block.LocalWidth(); ++column)
+        {
+          const size_t global_column(block.GlobalCol(column)),
+            s(global_column / H), jj(global_column % H);
+
+          if(bases == nullptr)
+            {
+              for(int64_t row = 0; row < block.LocalHeight(); ++row)
+                {
+                  const size_t global_row(block.GlobalRow(row));
+                  if(global_row % H != jj)
+                    {
+                      continue;
+                    }
+                  const size_t r(global_row / H);
+                  El::BigFloat &trace(traces(
+                    ((std::max(r, s) * (std::max(r, s) + 1)) / 2
+                     + std::min(r, s))
+                      * K
+                      + jj,
+                    0));
+                  if(r == s)
+                    {
+                      trace += block_local(row, column);
+                    }
+                  else
+                    {
+                      mpf_div_2exp(
+                        product.gmp_float.get_mpf_t(),
+                        block_local(row, column).gmp_float.get_mpf_t(), 1);
+                      trace += product;
+                    }
+                }
+              continue;
+            }
+
+          const El::Matrix<El::BigFloat> &V(bases[parity]);
+          for(size_t index = 0; index < (s + 1) * K; ++index)
+            {
+              mpf_set_ui(partial[index].gmp_float.get_mpf_t(), 0);
+            }
+          // The local rows are in increasing order, so we can stop at
+          // the first one below the (s,s) sub-block.
+          for(int64_t row = 0; row < block.LocalHeight(); ++row)
+            {
+              const size_t global_row(block.GlobalRow(row)),
+                r(global_row / H), ii(global_row % H);
+              if(r > s)
+                {
+                  break;
+                }
+              mpf_srcptr element(
+                block_local(row, column).gmp_float.get_mpf_t());
+              for(size_t k = 0; k < K; ++k)
+                {
+                  mpf_mul(product.gmp_float.get_mpf_t(), element,
+                          V(ii, k).gmp_float.get_mpf_t());
+                  mpf_add(partial[r * K + k].gmp_float.get_mpf_t(),
+                          partial[r * K + k].gmp_float.get_mpf_t(),
+                          product.gmp_float.get_mpf_t());
+                }
+            }
+          for(size_t r = 0; r <= s; ++r)
+            for(size_t k = 0; k < K; ++k)
+              {
+                El::BigFloat &trace(
+                  traces(((s * (s + 1)) / 2 + r) * K + k, 0));
+                mpf_mul(product.gmp_float.get_mpf_t(),
+                        partial[r * K + k].gmp_float.get_mpf_t(),
+                        V(jj, k).gmp_float.get_mpf_t());
+                mpf_add(trace.gmp_float.get_mpf_t(),
+                        trace.gmp_float.get_mpf_t(),
+                        product.gmp_float.get_mpf_t());
+              }
+        }
+    }
+
+  if(result.Grid().Size() > 1)
+    {
+      El::mpi::AllReduce(traces.Buffer(), traces.Height(), El::mpi::SUM,
+                         result.Grid().Comm());
+    }
+  El::Matrix<El::BigFloat> &result_local(result.Matrix());
+  for(int64_t row = 0; row < result.LocalHeight(); ++row)
+    for(int64_t column = 0; column < result.LocalWidth(); ++column)
+      {
+        result_local(row, column) -= traces(result.GlobalRow(row), 0);
+      }
+}
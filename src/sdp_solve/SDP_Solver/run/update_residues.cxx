@@ -0,0 +1,33 @@
+#include "../../Block_Diagonal_Matrix.hxx"
+#include "../../Block_Vector.hxx"
+
+// Update the residues after a step, instead of recomputing them.
+//
+// The search direction solves the linearized equations
+//
+//   \sum_p A_p dx_p - dX = -PrimalResidues
+//   Tr(A_p dY) + (B dy)_p = dualResidues_p
+//
+// so after the step (x, X) += primalStepLength (dx, dX) and
+// (y, Y) += dualStepLength (dy, dY), the residues are
+//
+//   PrimalResidues = (1 - primalStepLength) PrimalResidues
+//   dualResidues = (1 - dualStepLength) dualResidues
+//
+// This only holds up to the rounding errors in the search direction,
+// and in the Schur complement solve in particular, so the residues
+// drift away from the true ones.  SDP_Solver::run() recomputes them
+// from scratch every so often, and reports the drift.
+
+void update_residues(const El::BigFloat &primal_step_length,
+                     const El::BigFloat &dual_step_length,
+                     Block_Diagonal_Matrix &primal_residues,
+                     Block_Vector &dual_residues)
+{
+  primal_residues *= 1 - primal_step_length;
+  const El::BigFloat dual_scale(1 - dual_step_length);
+  for(auto &block : dual_residues.blocks)
+    {
+      El::Scale(dual_scale, block);
+    }
+}
@@ -5,6 +5,9 @@
 
 #include "Verbosity.hxx"
 #include "Write_Solution.hxx"
+#include "Multiply_Backend.hxx"
+#include "Bilinear_Pairings_Y_Method.hxx"
+#include "Step_Length_Method.hxx"
 
 #include <El.hpp>
 #include <boost/filesystem.hpp>
@@ -16,11 +19,18 @@ struct SDP_Solver_Parameters
 {
   int64_t max_iterations, max_runtime, checkpoint_interval;
   bool no_final_checkpoint, find_primal_feasible, find_dual_feasible,
-    detect_primal_feasible_jump, detect_dual_feasible_jump;
+    detect_primal_feasible_jump, detect_dual_feasible_jump,
+    cache_cholesky_inverse, timing_run;
   bool require_initial_checkpoint = false;
-  size_t precision, procs_per_node, proc_granularity;
+  size_t precision, procs_per_node, proc_granularity, num_threads;
+  size_t schur_precision, max_schur_refinements, initial_precision,
+    residue_recompute_interval, rebalance_interval, max_memory_per_node;
+  double rebalance_threshold;
   Write_Solution write_solution;
   Verbosity verbosity;
+  Multiply_Backend multiply_backend;
+  Bilinear_Pairings_Y_Method bilinear_pairings_Y_method;
+  Step_Length_Method step_length_method;
 
   El::BigFloat duality_gap_threshold, primal_error_threshold,
     dual_error_threshold, initial_matrix_scale_primal,
@@ -28,10 +38,40 @@ struct SDP_Solver_Parameters
     infeasible_centering_parameter, step_length_reduction, max_complementarity;
 
   boost::filesystem::path sdp_directory, out_directory, checkpoint_in,
-    checkpoint_out, param_file;
+    checkpoint_out, cost_profile_directory, param_file;
 
   SDP_Solver_Parameters(int argc, char *argv[]);
   bool is_valid() const { return !sdp_directory.empty(); }
+
+  // Whether the Schur complement solver is factored at a lower
+  // precision and refined (see solve_schur_complement_refined).
+  bool is_mixed_precision() const
+  {
+    return schur_precision != 0 && schur_precision < precision;
+  }
+
+  // Whether the working precision starts low and is raised as the
+  // solver converges (see scheduled_precision).
+  bool is_adaptive_precision() const
+  {
+    return initial_precision != 0 && initial_precision < precision;
+  }
+
+  // Whether the residues are updated from the step, and only
+  // recomputed from scratch every residue_recompute_interval
+  // iterations (see update_residues).
+  bool is_incremental_residues() const
+  {
+    return residue_recompute_interval > 1;
+  }
+
+  // Whether the block costs are measured while running, and the
+  // blocks are moved to new groups of processes when they are too
+  // unbalanced (see is_imbalanced).
+  bool is_rebalancing() const
+  {
+    return rebalance_threshold > 0 && rebalance_interval > 0;
+  }
 };
 
 std::ostream &operator<<(std::ostream &os, const SDP_Solver_Parameters &p);
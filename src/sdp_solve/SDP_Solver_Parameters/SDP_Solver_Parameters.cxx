@@ -5,10 +5,14 @@
 
 namespace po = boost::program_options;
 
+size_t to_bytes(const std::string &size, const std::string &option_name);
+
 SDP_Solver_Parameters::SDP_Solver_Parameters(int argc, char *argv[])
 {
   int int_verbosity;
-  std::string write_solution_string;
+  std::string write_solution_string, multiply_backend_string,
+    bilinear_pairings_Y_method_string, step_length_method_string,
+    max_memory_per_node_string;
   using namespace std::string_literals;
 
   po::options_description required_options("Required options");
@@ -78,10 +82,109 @@ SDP_Solver_Parameters::SDP_Solver_Parameters(int argc, char *argv[])
     "longer.  "
     "This option is generally useful only when trying to fit a large problem "
     "in a small machine.");
+  basic_options.add_options()(
+    "timingRun", po::bool_switch(&timing_run)->default_value(false),
+    "When running in parallel without a block_timings file, measure the "
+    "cost of each block with a two iteration timing run, and write the "
+    "results to block_timings in checkpointDir.  Without this option, the "
+    "costs are estimated with an analytic model of the operation counts, "
+    "calibrated by timing a few small multiplications and Cholesky "
+    "decompositions at startup.");
+  basic_options.add_options()(
+    "costProfileDir",
+    po::value<boost::filesystem::path>(&cost_profile_directory),
+    "A directory of cost profiles shared between runs.  If set, write the "
+    "measured cost of each stage of each block, normalized by the speed of "
+    "a multiplication at the working precision, to a profile named after "
+    "the structure of the SDP.  Later runs on SDPs with the same block "
+    "dimensions, degrees and number of free variables allocate their "
+    "blocks from it, instead of from the analytic model or a timing run, "
+    "and refine it with their own measurements.  A block_timings file "
+    "still takes precedence.");
+  basic_options.add_options()(
+    "rebalanceThreshold",
+    po::value<double>(&rebalance_threshold)->default_value(0),
+    "If larger than 0, keep measuring the time for each block while "
+    "running.  Every rebalanceInterval iterations, compute a new "
+    "allocation of blocks to groups of processes from the measurements "
+    "since the last check.  If the slowest group currently takes more than "
+    "rebalanceThreshold times as long as the slowest group of the new "
+    "allocation would, move x, X, y and Y to the new groups, reload the "
+    "SDP, and continue.  The measurements are written to block_timings in "
+    "checkpointDir, so that later runs start from the new allocation.  "
+    "A threshold of 1 or less moves the blocks at every check, which is "
+    "only useful for testing.");
+  basic_options.add_options()(
+    "rebalanceInterval",
+    po::value<size_t>(&rebalance_interval)->default_value(10),
+    "The number of iterations between the checks for rebalanceThreshold.");
+  basic_options.add_options()(
+    "maxMemoryPerNode",
+    po::value<std::string>(&max_memory_per_node_string)->default_value("0"s),
+    "The memory available to SDPB on each node, in bytes, or with a "
+    "suffix K, M, G or T, e.g. '192G'.  If nonzero, the memory for the "
+    "matrices of each block is estimated at the configured precision, "
+    "and blocks are only allocated so that every node stays within this "
+    "limit.  If that is not possible, SDPB stops before reading the SDP, "
+    "and reports how much memory each node would need.  The estimate "
+    "only counts the solver's matrices, so leave some room for MPI, "
+    "Elemental, and temporaries.");
+  basic_options.add_options()(
+    "numThreads", po::value<size_t>(&num_threads)->default_value(1),
+    "The number of threads used by each MPI process.  Blocks that live on a "
+    "single process have their Schur complement, bilinear pairings, "
+    "Cholesky decompositions, and contributions to Q computed by a pool of "
+    "this many threads.  Running fewer processes per node with more threads "
+    "each reduces the memory used by replicated data.  procsPerNode should "
+    "be the number of MPI processes per node, not the number of cores.");
   basic_options.add_options()("verbosity",
                               po::value<int>(&int_verbosity)->default_value(1),
                               "Verbosity.  0 -> no output, 1 -> regular "
                               "output, 2 -> debug output");
+  basic_options.add_options()(
+    "multiplyBackend",
+    po::value<std::string>(&multiply_backend_string)->default_value("gmp"s),
+    "How to compute the large matrix multiplications in the Schur "
+    "complement and bilinear pairings.\n"
+    "'gmp' uses Elemental's arbitrary precision routines.\n"
+    "'mpmat' splits each number into double precision limbs and multiplies "
+    "them with BLAS.  This is usually much faster, but uses roughly "
+    "precision/10 times as much memory for temporary matrices.  It is only "
+    "used for blocks that live on a single core.\n"
+    "'mpmat_check' is like 'mpmat', but also computes the 'gmp' result and "
+    "stops if they disagree.  This is only useful for debugging.");
+  basic_options.add_options()(
+    "bilinearPairingsY",
+    po::value<std::string>(&bilinear_pairings_Y_method_string)
+      ->default_value("gemm"s),
+    "How to compute the bilinear pairings of Y.\n"
+    "'gemm' multiplies Y by the bilinear bases on both sides.\n"
+    "'cholesky' uses the Cholesky decomposition Y = L L^T, with one "
+    "triangular multiply by L^T and one Syrk.  This uses fewer operations "
+    "for blocks with small dimensions.\n"
+    "'cholesky_check' is like 'cholesky', but also computes the 'gemm' "
+    "result and stops if they disagree.  This is only useful for "
+    "debugging.");
+  basic_options.add_options()(
+    "stepLengthMethod",
+    po::value<std::string>(&step_length_method_string)
+      ->default_value("eig"s),
+    "How to compute the step lengths that keep X and Y positive definite.\n"
+    "'eig' computes all of the eigenvalues of each block.\n"
+    "'lanczos' estimates the smallest eigenvalue of each block with a short "
+    "Lanczos iteration and checks the step with a Cholesky decomposition.  "
+    "Blocks where that fails fall back to 'eig'.  The steps can be slightly "
+    "shorter than with 'eig'.");
+  basic_options.add_options()(
+    "cacheCholeskyInverse",
+    po::bool_switch(&cache_cholesky_inverse)->default_value(false),
+    "Compute the inverse of the Cholesky decomposition of each block of X "
+    "once per iteration, and use it instead of triangular solves in the "
+    "bilinear pairings, the search direction and the step length.  "
+    "Multiplications are faster than triangular solves at high precision, "
+    "especially with multiplyBackend=mpmat, but this uses memory for "
+    "another copy of X.  Blocks where the inverse would lose more than "
+    "half of the precision still use triangular solves.");
 
   // We set default parameters using El::BigFloat("1e-10",10)
   // rather than a straight double precision 1e-10 so that results
@@ -96,6 +199,35 @@ SDP_Solver_Parameters::SDP_Solver_Parameters(int argc, char *argv[])
     " This should be less than or equal to the precision used when "
     "preprocessing the XML input files with 'pvm2sdp'.  GMP will round "
     "this up to a multiple of 32 or 64, depending on the system.");
+  solver_options.add_options()(
+    "schurPrecision", po::value<size_t>(&schur_precision)->default_value(0),
+    "If nonzero and less than 'precision', factor the Schur complement "
+    "matrix and Q at this lower precision, and recover the search "
+    "direction at the full precision with iterative refinement.  The "
+    "number of refinement steps and the final relative residual are "
+    "printed for every iteration.");
+  solver_options.add_options()(
+    "maxSchurRefinements",
+    po::value<size_t>(&max_schur_refinements)->default_value(10),
+    "The largest number of iterative refinement steps for each solve "
+    "of the Schur complement equation when 'schurPrecision' is set.");
+  solver_options.add_options()(
+    "initialPrecision",
+    po::value<size_t>(&initial_precision)->default_value(0),
+    "If nonzero and less than 'precision', start the iterations at this "
+    "lower working precision, and raise it towards 'precision' as the "
+    "duality gap and the primal and dual errors shrink.  The SDP is kept "
+    "at 'precision', and the iterates are rounded whenever the working "
+    "precision changes.  The working precision is printed for every "
+    "iteration.");
+  solver_options.add_options()(
+    "residueRecomputeInterval",
+    po::value<size_t>(&residue_recompute_interval)->default_value(1),
+    "If larger than 1, update the primal and dual residues from the step "
+    "in the other iterations, instead of recomputing them from the "
+    "constraint matrices, and only recompute them every this many "
+    "iterations.  The drift between the updated and recomputed residues is "
+    "printed for every iteration.");
   solver_options.add_options()(
     "findPrimalFeasible",
     po::bool_switch(&find_primal_feasible)->default_value(false),
@@ -273,6 +405,17 @@ SDP_Solver_Parameters::SDP_Solver_Parameters(int argc, char *argv[])
             }
 
           write_solution = Write_Solution(write_solution_string);
+          if(num_threads == 0)
+            {
+              throw std::runtime_error("numThreads must be at least 1");
+            }
+          multiply_backend = to_multiply_backend(multiply_backend_string);
+          bilinear_pairings_Y_method = to_bilinear_pairings_Y_method(
+            bilinear_pairings_Y_method_string);
+          step_length_method
+            = to_step_length_method(step_length_method_string);
+          max_memory_per_node
+            = to_bytes(max_memory_per_node_string, "maxMemoryPerNode");
 
           if(El::mpi::Rank() == 0)
             {
@@ -6,6 +6,7 @@ std::ostream &operator<<(std::ostream &os, const SDP_Solver_Parameters &p)
      << "out directory   : " << p.out_directory << '\n'
      << "checkpoint in   : " << p.checkpoint_in << '\n'
      << "checkpoint out  : " << p.checkpoint_out << '\n'
+     << "cost profiles   : " << p.cost_profile_directory << '\n'
      << "\nParameters:\n"
      << std::boolalpha << "maxIterations                = " << p.max_iterations
      << '\n'
@@ -21,6 +22,11 @@ std::ostream &operator<<(std::ostream &os, const SDP_Solver_Parameters &p)
      << '\n'
      << "precision(actual)            = " << p.precision << "("
      << mpf_get_default_prec() << ")" << '\n'
+     << "schurPrecision               = " << p.schur_precision << '\n'
+     << "maxSchurRefinements          = " << p.max_schur_refinements << '\n'
+     << "initialPrecision             = " << p.initial_precision << '\n'
+     << "residueRecomputeInterval     = " << p.residue_recompute_interval
+     << '\n'
 
      << "dualityGapThreshold          = " << p.duality_gap_threshold << '\n'
      << "primalErrorThreshold         = " << p.primal_error_threshold << '\n'
@@ -37,7 +43,17 @@ std::ostream &operator<<(std::ostream &os, const SDP_Solver_Parameters &p)
      << "maxComplementarity           = " << p.max_complementarity << '\n'
      << "procsPerNode                 = " << p.procs_per_node << '\n'
      << "procGranularity              = " << p.proc_granularity << '\n'
+     << "timingRun                    = " << p.timing_run << '\n'
+     << "rebalanceThreshold           = " << p.rebalance_threshold << '\n'
+     << "rebalanceInterval            = " << p.rebalance_interval << '\n'
+     << "maxMemoryPerNode             = " << p.max_memory_per_node << '\n'
+     << "numThreads                   = " << p.num_threads << '\n'
      << "verbosity                    = " << static_cast<int>(p.verbosity)
-     << '\n';
+     << '\n'
+     << "multiplyBackend              = " << p.multiply_backend << '\n'
+     << "bilinearPairingsY            = " << p.bilinear_pairings_Y_method
+     << '\n'
+     << "stepLengthMethod             = " << p.step_length_method << '\n'
+     << "cacheCholeskyInverse         = " << p.cache_cholesky_inverse << '\n';
   return os;
 }
@@ -0,0 +1,35 @@
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+// Convert a size like "512M", "64G" or "1.5T" into bytes.  The
+// suffixes K, M, G and T are powers of 1024, and a plain number is in
+// bytes.
+
+size_t to_bytes(const std::string &size, const std::string &option_name)
+{
+  const std::string units("KMGT");
+  size_t end(0), power(0);
+  double result(-1);
+  try
+    {
+      result = std::stod(size, &end);
+    }
+  catch(std::exception &)
+    {}
+  if(end + 1 == size.size())
+    {
+      // npos + 1 == 0, which is not a valid power.
+      power = units.find(std::toupper(static_cast<unsigned char>(size.back())))
+              + 1;
+    }
+  if(result < 0 || (end != size.size() && power == 0))
+    {
+      throw std::runtime_error("Invalid argument for " + option_name
+                               + ".  Expected a number of bytes, optionally "
+                                 "followed by K, M, G or T, but found: "
+                               + size);
+    }
+  return static_cast<size_t>(result * std::pow(1024.0, power));
+}
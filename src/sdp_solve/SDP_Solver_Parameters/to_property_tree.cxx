@@ -9,6 +9,7 @@ to_property_tree(const SDP_Solver_Parameters &p)
   result.put("outDir", p.out_directory.string());
   result.put("initialCheckpointDir", p.checkpoint_in.string());
   result.put("checkpointDir", p.checkpoint_out.string());
+  result.put("costProfileDir", p.cost_profile_directory.string());
   result.put("maxIterations", p.max_iterations);
   result.put("maxRuntime", p.max_runtime);
   result.put("checkpointInterval", p.checkpoint_interval);
@@ -20,6 +21,10 @@ to_property_tree(const SDP_Solver_Parameters &p)
   result.put("detectDualFeasibleJump", p.detect_dual_feasible_jump);
   result.put("precision", p.precision);
   result.put("precision_actual", mpf_get_default_prec());
+  result.put("schurPrecision", p.schur_precision);
+  result.put("maxSchurRefinements", p.max_schur_refinements);
+  result.put("initialPrecision", p.initial_precision);
+  result.put("residueRecomputeInterval", p.residue_recompute_interval);
   result.put("dualityGapThreshold", p.duality_gap_threshold);
   result.put("primalErrorThreshold", p.primal_error_threshold);
   result.put("dualErrorThreshold", p.dual_error_threshold);
@@ -31,7 +36,16 @@ to_property_tree(const SDP_Solver_Parameters &p)
   result.put("maxComplementarity", p.max_complementarity);
   result.put("procsPerNode", p.procs_per_node);
   result.put("procGranularity", p.proc_granularity);
+  result.put("timingRun", p.timing_run);
+  result.put("rebalanceThreshold", p.rebalance_threshold);
+  result.put("rebalanceInterval", p.rebalance_interval);
+  result.put("maxMemoryPerNode", p.max_memory_per_node);
+  result.put("numThreads", p.num_threads);
   result.put("verbosity", static_cast<int>(p.verbosity));
+  result.put("multiplyBackend", p.multiply_backend);
+  result.put("bilinearPairingsY", p.bilinear_pairings_Y_method);
+  result.put("stepLengthMethod", p.step_length_method);
+  result.put("cacheCholeskyInverse", p.cache_cholesky_inverse);
 
   return result;
 }
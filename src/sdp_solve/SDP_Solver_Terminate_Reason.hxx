@@ -15,6 +15,7 @@ enum class SDP_Solver_Terminate_Reason
   MaxComplementarityExceeded,
   MaxIterationsExceeded,
   MaxRuntimeExceeded,
+  RebalanceBlocks,
 };
 
 std::ostream &
@@ -29,6 +29,9 @@ operator<<(std::ostream &os, const SDP_Solver_Terminate_Reason &r)
     case SDP_Solver_Terminate_Reason::MaxComplementarityExceeded:
       os << "maxComplementarity exceeded";
       break;
+    case SDP_Solver_Terminate_Reason::RebalanceBlocks:
+      os << "blocks need to be rebalanced";
+      break;
     }
   return os;
 }
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Block_Diagonal_Matrix.hxx"
+#include "Block_Matrix.hxx"
+#include "Block_Vector.hxx"
+#include "Block_Info.hxx"
+#include "Synchronize_Q_Plan.hxx"
+
+// Temporaries used inside each iteration of SDP_Solver::run.  Every
+// El::BigFloat is a separate heap allocation, so allocating these
+// from scratch each iteration means millions of calls to malloc and
+// free.  Instead, they are allocated once, with sizes taken from
+// Block_Info, and overwritten in every iteration.
+struct SDP_Solver_Workspace
+{
+  // Search direction: These quantities have the same structure
+  // as (x, X, y, Y). They are computed twice each iteration:
+  // once in the predictor step, and once in the corrector step.
+  Block_Vector dx, dy;
+  Block_Diagonal_Matrix dX, dY;
+
+  // p = b - B^T x, with the same structure as y
+  Block_Vector primal_residue_p;
+
+  // SchurComplementCholesky = L', the Cholesky decomposition of the
+  // Schur complement matrix S.  S itself is computed in place, unless
+  // the solver is factored at a lower precision (see below).
+  //
+  // schur_complement_cholesky, schur_off_diagonal, Q and Q_group are
+  // allocated at schur_precision.
+  Block_Diagonal_Matrix schur_complement_cholesky;
+
+  // SchurOffDiagonal = L'^{-1} FreeVarMatrix, needed in solving the
+  // Schur complement equation.
+  Block_Matrix schur_off_diagonal;
+
+  // Q = B' L'^{-T} L'^{-1} B' - {{0, 0}, {0, 1}}, and the
+  // contributions to Q from the blocks in this group.  Only the upper
+  // half of Q_group is allocated.
+  El::DistMatrix<El::BigFloat> Q, Q_group;
+
+  // Which elements of Q_group go where when summing them into Q, for
+  // each column panel of Q.  Q is computed and summed one panel at a
+  // time, so that the reduction of a panel overlaps the computation
+  // of the next.
+  std::list<Synchronize_Q_Plan> synchronize_Q_plans;
+
+  // R and Z in compute_search_direction, and MInvDM in step_length.
+  // R must not be touched between the predictor and corrector calls
+  // of compute_search_direction, which reuse -X Y from it.
+  // compute_search_direction also uses MInvDM as scratch space for
+  // multiplying by a cached L^{-1}.  step_lengths uses MInvDM and R as
+  // scratch space for X and Y afterwards.  These have the same
+  // structure as X.
+  Block_Diagonal_Matrix R, Z, MInvDM;
+
+  // Scratch space for constraint_matrix_weighted_sum, with the same
+  // shape as sdp.bilinear_bases_dist.  This is allocated on first use,
+  // since Block_Info does not have the shape.
+  std::vector<El::DistMatrix<El::BigFloat>> scaled_bases;
+
+  // Only used when the Schur complement solver is factored at a
+  // lower precision, and empty otherwise (see
+  // solve_schur_complement_refined).  S at the working precision, the
+  // right-hand side and residues of the Schur complement equation,
+  // and the corrections, which are at schur_precision.
+  Block_Diagonal_Matrix schur_complement;
+  Block_Vector schur_rhs_dx, schur_rhs_dy, schur_residue_dx,
+    schur_residue_dy, schur_correction_dx, schur_correction_dy;
+
+  // schur_precision == 0 means the working precision.
+  SDP_Solver_Workspace(const Block_Info &block_info, const El::Grid &grid,
+                       const size_t &dual_objective_b_height,
+                       const size_t &schur_precision);
+
+  // Round every member to the working precision, after it changed.
+  // If schur_precision is nonzero, the members at schur_precision are
+  // left alone.
+  void round_to_working_precision(const size_t &schur_precision);
+};
@@ -0,0 +1,99 @@
+#include "../SDP_Solver_Workspace.hxx"
+#include "../Precision_Scope.hxx"
+
+namespace
+{
+  // The blocks of the refinement workspace, which is only allocated
+  // when the Schur complement solver is at a lower precision.
+  std::vector<size_t> refinement_block_indices(const Block_Info &block_info,
+                                               const size_t &schur_precision)
+  {
+    return schur_precision == 0 ? std::vector<size_t>()
+                                : block_info.block_indices;
+  }
+}
+
+SDP_Solver_Workspace::SDP_Solver_Workspace(
+  const Block_Info &block_info, const El::Grid &grid,
+  const size_t &dual_objective_b_height, const size_t &schur_precision)
+    : dx(block_info.schur_block_sizes, block_info.block_indices,
+         block_info.schur_block_sizes.size(), grid),
+      dy(std::vector<size_t>(block_info.schur_block_sizes.size(),
+                             dual_objective_b_height),
+         block_info.block_indices, block_info.schur_block_sizes.size(), grid),
+      dX(block_info.psd_matrix_block_sizes, block_info.block_indices,
+         block_info.schur_block_sizes.size(), grid),
+      dY(dX), primal_residue_p(dy),
+      schur_complement_cholesky(at_precision(schur_precision, [&]() {
+        return Block_Diagonal_Matrix(block_info.schur_block_sizes,
+                                     block_info.block_indices,
+                                     block_info.schur_block_sizes.size(),
+                                     grid);
+      })),
+      schur_off_diagonal(at_precision(schur_precision, [&]() {
+        return Block_Matrix(block_info.schur_block_sizes,
+                            dual_objective_b_height, block_info.block_indices,
+                            block_info.schur_block_sizes.size(), grid);
+      })),
+      Q(at_precision(schur_precision, [&]() {
+        return El::DistMatrix<El::BigFloat>(dual_objective_b_height,
+                                            dual_objective_b_height);
+      })),
+      Q_group(at_precision(schur_precision, [&]() {
+        return El::DistMatrix<El::BigFloat>(dual_objective_b_height,
+                                            dual_objective_b_height, grid);
+      })),
+      R(dX), Z(dX), MInvDM(dX),
+      schur_complement(block_info.schur_block_sizes,
+                       refinement_block_indices(block_info, schur_precision),
+                       block_info.schur_block_sizes.size(), grid),
+      schur_rhs_dx(block_info.schur_block_sizes,
+                   refinement_block_indices(block_info, schur_precision),
+                   block_info.schur_block_sizes.size(), grid),
+      schur_rhs_dy(std::vector<size_t>(block_info.schur_block_sizes.size(),
+                                       dual_objective_b_height),
+                   refinement_block_indices(block_info, schur_precision),
+                   block_info.schur_block_sizes.size(), grid),
+      schur_residue_dx(schur_rhs_dx), schur_residue_dy(schur_rhs_dy),
+      schur_correction_dx(at_precision(schur_precision, [&]() {
+        return Block_Vector(
+          block_info.schur_block_sizes,
+          refinement_block_indices(block_info, schur_precision),
+          block_info.schur_block_sizes.size(), grid);
+      })),
+      schur_correction_dy(at_precision(schur_precision, [&]() {
+        return Block_Vector(
+          std::vector<size_t>(block_info.schur_block_sizes.size(),
+                              dual_objective_b_height),
+          refinement_block_indices(block_info, schur_precision),
+          block_info.schur_block_sizes.size(), grid);
+      }))
+{
+  // Explicitly deallocate the lower half of Q_group.  This
+  // significantly reduces the total amount of memory required.
+  El::Matrix<El::BigFloat> &local(Q_group.Matrix());
+  for(int64_t row = 0; row < Q_group.Height(); ++row)
+    for(int64_t column = 0; column < row; ++column)
+      {
+        if(Q_group.IsLocal(row, column))
+          {
+            mpf_clear(local(Q_group.LocalRow(row), Q_group.LocalCol(column))
+                        .gmp_float.get_mpf_t());
+            local(Q_group.LocalRow(row), Q_group.LocalCol(column))
+              .gmp_float.get_mpf_t()[0]
+              ._mp_d
+              = nullptr;
+          }
+      }
+
+  // With only one rank there is nothing to overlap.  The buffers are
+  // sized for Q_group's precision.
+  Precision_Scope scope(schur_precision);
+  const std::vector<int64_t> panels(upper_triangle_panels(
+    Q.Height(), El::mpi::Size(El::mpi::COMM_WORLD) == 1 ? 1 : 4));
+  for(size_t panel = 0; panel + 1 < panels.size(); ++panel)
+    {
+      synchronize_Q_plans.emplace_back(Q, Q_group, panels[panel],
+                                       panels[panel + 1]);
+    }
+}
@@ -0,0 +1,26 @@
+#include "../SDP_Solver_Workspace.hxx"
+#include "../round_to_precision.hxx"
+
+void SDP_Solver_Workspace::round_to_working_precision(
+  const size_t &schur_precision)
+{
+  for(auto *v : {&dx, &dy, &primal_residue_p, &schur_rhs_dx, &schur_rhs_dy,
+                 &schur_residue_dx, &schur_residue_dy})
+    {
+      round_to_precision(*v);
+    }
+  for(auto *A : {&dX, &dY, &R, &Z, &MInvDM, &schur_complement})
+    {
+      round_to_precision(*A);
+    }
+  round_to_precision(scaled_bases);
+
+  // The synchronize_Q plans resize their buffers on their own.
+  if(schur_precision == 0)
+    {
+      round_to_precision(schur_complement_cholesky);
+      round_to_precision(schur_off_diagonal);
+      round_to_precision(Q);
+      round_to_precision(Q_group);
+    }
+}
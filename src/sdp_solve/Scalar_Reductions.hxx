@@ -0,0 +1,29 @@
+#pragma once
+
+#include <El.hpp>
+
+#include <vector>
+
+// Scalars that are summed or maximized over all ranks.  Each
+// computation registers this rank's contribution, and reduce() then
+// finishes all of them with one AllReduce for each operation, rather
+// than one collective for each quantity.  The registered scalars are
+// overwritten in place, so they must stay alive until reduce() is
+// called.
+struct Scalar_Reductions
+{
+  std::vector<El::BigFloat *> sums, maxima;
+  // Reused from one call of reduce() to the next
+  std::vector<El::BigFloat> buffer;
+
+  void add_sum(El::BigFloat &local_value) { sums.push_back(&local_value); }
+  void add_max(El::BigFloat &local_value)
+  {
+    maxima.push_back(&local_value);
+  }
+
+  // Reduce everything over El::mpi::COMM_WORLD, and forget the
+  // registered scalars.  This is collective, and every rank must
+  // register the same scalars in the same order.
+  void reduce();
+};
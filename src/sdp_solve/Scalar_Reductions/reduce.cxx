@@ -0,0 +1,37 @@
+#include "../Scalar_Reductions.hxx"
+
+namespace
+{
+  void reduce_all(const El::mpi::Op &op, std::vector<El::BigFloat *> &values,
+                  std::vector<El::BigFloat> &buffer)
+  {
+    if(values.empty())
+      {
+        return;
+      }
+    buffer.resize(values.size());
+    for(size_t index = 0; index < values.size(); ++index)
+      {
+        // The size of the message depends on the working precision,
+        // which may have changed since the buffer was allocated.
+        mpf_ptr element(buffer[index].gmp_float.get_mpf_t());
+        if(mpf_get_prec(element) != mpf_get_default_prec())
+          {
+            mpf_set_prec(element, mpf_get_default_prec());
+          }
+        buffer[index] = *values[index];
+      }
+    El::mpi::AllReduce(buffer.data(), values.size(), op, El::mpi::COMM_WORLD);
+    for(size_t index = 0; index < values.size(); ++index)
+      {
+        *values[index] = buffer[index];
+      }
+    values.clear();
+  }
+}
+
+void Scalar_Reductions::reduce()
+{
+  reduce_all(El::mpi::SUM, sums, buffer);
+  reduce_all(El::mpi::MAX, maxima, buffer);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+// How to find the step lengths that keep X and Y positive definite.
+//
+// - eig: Compute all of the eigenvalues of L^{-1} dM L^{-T} with
+//   El::HermitianEig.  This is the default.
+//
+// - lanczos: Estimate the smallest eigenvalue of L^{-1} dM L^{-T} for
+//   each block with a short Lanczos iteration, and check the
+//   resulting step with a trial Cholesky decomposition.  Blocks where
+//   either one fails use eig.  X and Y are done together.  The steps
+//   are never longer than with eig, but may be slightly shorter.
+
+enum class Step_Length_Method
+{
+  lanczos,
+  eig
+};
+
+Step_Length_Method to_step_length_method(const std::string &name);
+
+std::ostream &operator<<(std::ostream &os, const Step_Length_Method &method);
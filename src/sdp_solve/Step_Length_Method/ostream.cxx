@@ -0,0 +1,11 @@
+#include "../Step_Length_Method.hxx"
+
+std::ostream &operator<<(std::ostream &os, const Step_Length_Method &method)
+{
+  switch(method)
+    {
+    case Step_Length_Method::lanczos: os << "lanczos"; break;
+    case Step_Length_Method::eig: os << "eig"; break;
+    }
+  return os;
+}
@@ -0,0 +1,18 @@
+#include "../Step_Length_Method.hxx"
+
+#include <stdexcept>
+
+Step_Length_Method to_step_length_method(const std::string &name)
+{
+  if(name == "lanczos")
+    {
+      return Step_Length_Method::lanczos;
+    }
+  else if(name == "eig")
+    {
+      return Step_Length_Method::eig;
+    }
+  throw std::runtime_error("Invalid argument for stepLengthMethod.  "
+                           "Expected one of lanczos or eig, but found: "
+                           + name);
+}
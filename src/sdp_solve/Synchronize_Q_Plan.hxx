@@ -0,0 +1,133 @@
+#pragma once
+
+#include <El.hpp>
+
+#include <array>
+#include <climits>
+#include <chrono>
+#include <list>
+#include <vector>
+
+// Communication plan for summing the Q_group contributions of every
+// group into the global Q, for the upper triangle elements in the
+// column panel column_begin <= column < column_end.  The owners of
+// the elements of Q and the local footprint of Q_group never change
+// during a run, so all of the index bookkeeping is done once here
+// rather than by scanning all of Q in every iteration.
+//
+// The reduction is hierarchical.  Every element of Q is assigned a
+// representative rank on each node: the rank whose node-local index
+// matches the node-local index of the element's owner.  First, every
+// rank packs the elements of Q_group that it actually holds into a
+// shared memory window, and the representatives add up the
+// contributions from all of the ranks on their node.  Then the
+// representatives run a ring reduce-scatter across nodes among the
+// ranks with the same node-local index, which always includes the
+// owner.
+//
+// Values are packed as fixed-size slots of raw GMP limbs, so there
+// is no serialization and no explicit zeros are sent for elements a
+// rank does not hold.  If the nodes do not all have the same number
+// of ranks, every rank is treated as its own node.
+//
+// The reduction is nonblocking.  start() takes a snapshot of the
+// panel of Q_group, and progress() advances it as far as possible
+// without waiting, so that the panels of Q that are finished can be
+// summed while later panels are still being computed.  Each plan has
+// its own communicators and buffers, so several panels may be in
+// flight at once.
+struct Synchronize_Q_Plan
+{
+  int64_t column_begin, column_end;
+
+  MPI_Comm node_comm, cross_comm;
+  int node_size, node_rank, cross_size, cross_rank;
+
+  // Local (row, column) of the upper triangle elements of Q_group
+  // held by this rank, grouped by the node rank of their
+  // representative.  representative_offsets has node_size+1 entries.
+  std::vector<int64_t> local_rows, local_columns;
+  std::vector<size_t> representative_offsets;
+
+  // For each rank j on this node, where its slice for this rank
+  // starts in its shared memory segment, and the accumulator index
+  // for each element in that slice.
+  std::vector<size_t> peer_offsets;
+  std::vector<std::vector<size_t>> peer_targets;
+
+  // Offsets into the accumulator of the elements owned by each rank
+  // in cross_comm.  This has cross_size+1 entries.
+  std::vector<size_t> destination_offsets;
+
+  // Local (row, column) in Q of the elements owned by this rank, in
+  // the same order as its segment of the accumulator.
+  std::vector<int64_t> Q_local_rows, Q_local_columns;
+
+  // Buffers, sized for slot_bytes bytes per element.
+  size_t slot_bytes;
+  MPI_Win window;
+  std::vector<El::byte *> peer_segments;
+  std::vector<El::BigFloat> accumulator;
+  std::array<std::vector<El::byte>, 2> ring_buffers;
+
+  // State of the reduction in flight.
+  enum class Stage
+  {
+    idle,
+    node,
+    ring,
+    finishing,
+    done
+  } stage;
+  MPI_Request node_request, window_request, send_request;
+  std::array<MPI_Request, 2> receive_requests;
+  int ring_step;
+  bool receive_posted;
+  std::chrono::high_resolution_clock::time_point start_time, done_time;
+
+  Synchronize_Q_Plan(const El::DistMatrix<El::BigFloat> &Q,
+                     const El::DistMatrix<El::BigFloat> &Q_group,
+                     const int64_t &column_begin, const int64_t &column_end);
+  ~Synchronize_Q_Plan();
+  Synchronize_Q_Plan(const Synchronize_Q_Plan &) = delete;
+  Synchronize_Q_Plan &operator=(const Synchronize_Q_Plan &) = delete;
+
+  // (Re)allocate the buffers if the precision changed.  This is
+  // collective over node_comm.
+  void allocate_buffers(const size_t &new_slot_bytes);
+
+  // Begin summing this panel of Q_group into Q.  Q_group may be
+  // modified as soon as this returns.
+  void start(const El::DistMatrix<El::BigFloat> &Q_group,
+             El::DistMatrix<El::BigFloat> &Q);
+
+  // Advance the reduction.  If wait is false, this never blocks.
+  // Returns whether this panel of Q is complete.
+  bool progress(El::DistMatrix<El::BigFloat> &Q, const bool &wait);
+
+  bool is_serial() const { return node_size == 1 && cross_size == 1; }
+
+private:
+  void start_ring();
+
+  // MPI uses 'int' for message sizes.
+  int message_size(const int &destination) const
+  {
+    const size_t result((destination_offsets[destination + 1]
+                         - destination_offsets[destination])
+                        * slot_bytes);
+    if(result > INT_MAX)
+      {
+        El::RuntimeError("Message too large in synchronize_Q: ", result,
+                         " bytes");
+      }
+    return result;
+  }
+};
+
+size_t synchronize_Q_slot_bytes();
+
+// Column boundaries that split the upper triangle of an N x N matrix
+// into num_panels panels with about the same number of elements.
+std::vector<int64_t>
+upper_triangle_panels(const int64_t &N, const size_t &num_panels);
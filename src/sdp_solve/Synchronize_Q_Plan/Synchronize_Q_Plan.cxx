@@ -0,0 +1,183 @@
+#include "../Synchronize_Q_Plan.hxx"
+#include "../check_mpi_error.hxx"
+
+#include <algorithm>
+
+Synchronize_Q_Plan::Synchronize_Q_Plan(
+  const El::DistMatrix<El::BigFloat> &Q,
+  const El::DistMatrix<El::BigFloat> &Q_group, const int64_t &column_begin,
+  const int64_t &column_end)
+    : column_begin(column_begin), column_end(column_end), slot_bytes(0),
+      window(MPI_WIN_NULL), stage(Stage::idle),
+      node_request(MPI_REQUEST_NULL), window_request(MPI_REQUEST_NULL),
+      send_request(MPI_REQUEST_NULL),
+      receive_requests({MPI_REQUEST_NULL, MPI_REQUEST_NULL}), ring_step(0),
+      receive_posted(false)
+{
+  const MPI_Comm world(El::mpi::COMM_WORLD.comm);
+  const int total_ranks(El::mpi::Size(El::mpi::COMM_WORLD)),
+    rank(El::mpi::Rank(El::mpi::COMM_WORLD));
+
+  check_mpi_error(MPI_Comm_split_type(world, MPI_COMM_TYPE_SHARED, rank,
+                                      MPI_INFO_NULL, &node_comm));
+  check_mpi_error(MPI_Comm_size(node_comm, &node_size));
+  {
+    int min_node_size, max_node_size;
+    check_mpi_error(MPI_Allreduce(&node_size, &min_node_size, 1, MPI_INT,
+                                  MPI_MIN, world));
+    check_mpi_error(MPI_Allreduce(&node_size, &max_node_size, 1, MPI_INT,
+                                  MPI_MAX, world));
+    if(min_node_size != max_node_size)
+      {
+        check_mpi_error(MPI_Comm_free(&node_comm));
+        check_mpi_error(MPI_Comm_dup(MPI_COMM_SELF, &node_comm));
+        node_size = 1;
+      }
+  }
+  check_mpi_error(MPI_Comm_rank(node_comm, &node_rank));
+  check_mpi_error(MPI_Comm_split(world, node_rank, rank, &cross_comm));
+  check_mpi_error(MPI_Comm_size(cross_comm, &cross_size));
+  check_mpi_error(MPI_Comm_rank(cross_comm, &cross_rank));
+
+  // The node rank of every rank in COMM_WORLD.  The rank of a
+  // process in cross_comm is the number of lower ranks with the same
+  // node rank.
+  std::vector<int> node_ranks(total_ranks);
+  check_mpi_error(MPI_Allgather(&node_rank, 1, MPI_INT, node_ranks.data(), 1,
+                                MPI_INT, world));
+  std::vector<int> cross_ranks(total_ranks);
+  {
+    std::vector<int> members(node_size, 0);
+    for(int other = 0; other < total_ranks; ++other)
+      {
+        cross_ranks[other] = members[node_ranks[other]]++;
+      }
+  }
+
+  // Count the upper triangle elements in the panel owned by each
+  // rank, and the offset of each owner's segment in the accumulator
+  // of its representatives.
+  std::vector<size_t> owned(total_ranks, 0);
+  for(int64_t column = column_begin; column < column_end; ++column)
+    for(int64_t row = 0; row <= column; ++row)
+      {
+        ++owned[Q.Owner(row, column)];
+      }
+  std::vector<size_t> owner_offsets(total_ranks);
+  {
+    std::vector<size_t> running(node_size, 0);
+    for(int other = 0; other < total_ranks; ++other)
+      {
+        owner_offsets[other] = running[node_ranks[other]];
+        running[node_ranks[other]] += owned[other];
+      }
+  }
+  destination_offsets.assign(cross_size + 1, 0);
+  for(int other = 0; other < total_ranks; ++other)
+    {
+      if(node_ranks[other] == node_rank)
+        {
+          destination_offsets[cross_ranks[other] + 1] = owner_offsets[other]
+                                                        + owned[other];
+        }
+    }
+  // In the serial case, Q_group is copied straight into Q.
+  if(!is_serial())
+    {
+      accumulator.resize(destination_offsets.back());
+    }
+
+  // Assign the local elements of Q_group to their representatives,
+  // and record where this rank's elements of Q go.
+  std::vector<std::vector<int64_t>> rows(node_size), columns(node_size);
+  std::vector<std::vector<size_t>> targets(node_size);
+  std::fill(owned.begin(), owned.end(), 0);
+  for(int64_t column = column_begin; column < column_end; ++column)
+    for(int64_t row = 0; row <= column; ++row)
+      {
+        const int owner(Q.Owner(row, column));
+        const size_t index(owned[owner]++);
+        if(Q_group.IsLocal(row, column))
+          {
+            const int representative(node_ranks[owner]);
+            rows[representative].push_back(Q_group.LocalRow(row));
+            columns[representative].push_back(Q_group.LocalCol(column));
+            targets[representative].push_back(owner_offsets[owner] + index);
+          }
+        if(owner == rank)
+          {
+            Q_local_rows.push_back(Q.LocalRow(row));
+            Q_local_columns.push_back(Q.LocalCol(column));
+          }
+      }
+
+  representative_offsets.assign(1, 0);
+  for(int representative = 0; representative < node_size; ++representative)
+    {
+      local_rows.insert(local_rows.end(), rows[representative].begin(),
+                        rows[representative].end());
+      local_columns.insert(local_columns.end(),
+                           columns[representative].begin(),
+                           columns[representative].end());
+      representative_offsets.push_back(local_rows.size());
+    }
+
+  // Tell every representative on this node how many elements to
+  // expect, where they start, and where they go.
+  std::vector<uint64_t> send_counts(node_size), send_offsets(node_size),
+    receive_counts(node_size), receive_offsets(node_size);
+  for(int representative = 0; representative < node_size; ++representative)
+    {
+      send_counts[representative] = targets[representative].size();
+      send_offsets[representative] = representative_offsets[representative];
+    }
+  check_mpi_error(MPI_Alltoall(send_counts.data(), 1, MPI_UINT64_T,
+                               receive_counts.data(), 1, MPI_UINT64_T,
+                               node_comm));
+  check_mpi_error(MPI_Alltoall(send_offsets.data(), 1, MPI_UINT64_T,
+                               receive_offsets.data(), 1, MPI_UINT64_T,
+                               node_comm));
+  peer_offsets.assign(receive_offsets.begin(), receive_offsets.end());
+
+  // Exchange the targets themselves.
+  peer_targets.resize(node_size);
+  std::vector<MPI_Request> requests;
+  for(int peer = 0; peer < node_size; ++peer)
+    {
+      peer_targets[peer].resize(receive_counts[peer]);
+      if(receive_counts[peer] > 0)
+        {
+          static_assert(sizeof(size_t) == sizeof(uint64_t),
+                        "size_t must be 64 bits");
+          requests.emplace_back();
+          check_mpi_error(MPI_Irecv(peer_targets[peer].data(),
+                                    receive_counts[peer], MPI_UINT64_T, peer,
+                                    0, node_comm, &requests.back()));
+        }
+    }
+  for(int representative = 0; representative < node_size; ++representative)
+    {
+      if(!targets[representative].empty())
+        {
+          requests.emplace_back();
+          check_mpi_error(MPI_Isend(
+            targets[representative].data(), targets[representative].size(),
+            MPI_UINT64_T, representative, 0, node_comm, &requests.back()));
+        }
+    }
+  check_mpi_error(
+    MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE));
+
+  allocate_buffers(synchronize_Q_slot_bytes());
+}
+
+Synchronize_Q_Plan::~Synchronize_Q_Plan()
+{
+  if(window != MPI_WIN_NULL)
+    {
+      MPI_Win_unlock_all(window);
+      MPI_Win_free(&window);
+    }
+  MPI_Comm_free(&cross_comm);
+  MPI_Comm_free(&node_comm);
+}
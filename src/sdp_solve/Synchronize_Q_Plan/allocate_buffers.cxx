@@ -0,0 +1,57 @@
+#include "../Synchronize_Q_Plan.hxx"
+#include "../check_mpi_error.hxx"
+
+#include <algorithm>
+
+void Synchronize_Q_Plan::allocate_buffers(const size_t &new_slot_bytes)
+{
+  if(new_slot_bytes == slot_bytes)
+    {
+      return;
+    }
+  slot_bytes = new_slot_bytes;
+  // Recreate the accumulator at the current precision
+  accumulator = std::vector<El::BigFloat>(accumulator.size());
+
+  if(window != MPI_WIN_NULL)
+    {
+      check_mpi_error(MPI_Win_unlock_all(window));
+      check_mpi_error(MPI_Win_free(&window));
+    }
+  // A shared memory window is only needed to sum within a node.
+  if(node_size > 1)
+    {
+      El::byte *base;
+      check_mpi_error(MPI_Win_allocate_shared(
+        std::max(size_t(1), local_rows.size() * slot_bytes), 1,
+        MPI_INFO_NULL, node_comm, &base, &window));
+      // The window is only accessed with loads and stores,
+      // synchronized by MPI_Win_sync and barriers on node_comm.
+      check_mpi_error(MPI_Win_lock_all(MPI_MODE_NOCHECK, window));
+
+      peer_segments.resize(node_size);
+      for(int peer = 0; peer < node_size; ++peer)
+        {
+          MPI_Aint size;
+          int displacement_unit;
+          check_mpi_error(MPI_Win_shared_query(window, peer, &size,
+                                               &displacement_unit,
+                                               &peer_segments[peer]));
+        }
+    }
+
+  size_t max_owned(0);
+  if(cross_size > 1)
+    {
+      for(int destination = 0; destination < cross_size; ++destination)
+        {
+          max_owned
+            = std::max(max_owned, destination_offsets[destination + 1]
+                                    - destination_offsets[destination]);
+        }
+    }
+  for(auto &buffer : ring_buffers)
+    {
+      buffer.resize(max_owned * slot_bytes);
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <El.hpp>
+
+#include <cstring>
+
+// Packing of El::BigFloat's into the fixed-size slots used by
+// Synchronize_Q_Plan.  A slot holds _mp_size and _mp_exp as 64 bit
+// integers, followed by the limbs.
+
+// Copy the size, exponent, and limbs of value into slot.
+inline void pack(const El::BigFloat &value, El::byte *slot)
+{
+  mpf_srcptr x(value.gmp_float.get_mpf_t());
+  const int64_t header[2] = {x->_mp_size, x->_mp_exp};
+  std::memcpy(slot, header, sizeof(header));
+  std::memcpy(slot + sizeof(header), x->_mp_d,
+              sizeof(mp_limb_t) * std::abs(x->_mp_size));
+}
+
+// value += the number packed in slot.  The limbs are used in place
+// rather than copied out.
+inline void add_packed(const El::byte *slot, El::BigFloat &value)
+{
+  int64_t header[2];
+  std::memcpy(header, slot, sizeof(header));
+  if(header[0] == 0)
+    {
+      return;
+    }
+  __mpf_struct packed;
+  packed._mp_size = header[0];
+  packed._mp_exp = header[1];
+  packed._mp_prec = std::abs(header[0]);
+  packed._mp_d = reinterpret_cast<mp_limb_t *>(
+    const_cast<El::byte *>(slot + sizeof(header)));
+  mpf_add(value.gmp_float.get_mpf_t(), value.gmp_float.get_mpf_t(), &packed);
+}
@@ -0,0 +1,132 @@
+#include "../Synchronize_Q_Plan.hxx"
+#include "../check_mpi_error.hxx"
+#include "pack.hxx"
+
+namespace
+{
+  // Whether request has finished, waiting for it if wait is true.
+  // We do not cancel requests, so no need to check status.
+  bool is_complete(MPI_Request &request, const bool &wait)
+  {
+    if(wait)
+      {
+        check_mpi_error(MPI_Wait(&request, MPI_STATUS_IGNORE));
+        return true;
+      }
+    int flag;
+    check_mpi_error(MPI_Test(&request, &flag, MPI_STATUS_IGNORE));
+    return flag != 0;
+  }
+}
+
+bool Synchronize_Q_Plan::progress(El::DistMatrix<El::BigFloat> &Q,
+                                  const bool &wait)
+{
+  if(stage == Stage::idle || stage == Stage::done)
+    {
+      return true;
+    }
+
+  if(stage == Stage::node)
+    {
+      if(!is_complete(node_request, wait))
+        {
+          return false;
+        }
+      check_mpi_error(MPI_Win_sync(window));
+      for(int peer = 0; peer < node_size; ++peer)
+        {
+          const El::byte *slice(peer_segments[peer]
+                                + peer_offsets[peer] * slot_bytes);
+          for(auto &target : peer_targets[peer])
+            {
+              add_packed(slice, accumulator[target]);
+              slice += slot_bytes;
+            }
+        }
+      // The segments may not be overwritten until everyone has read
+      // them.
+      check_mpi_error(MPI_Ibarrier(node_comm, &window_request));
+      start_ring();
+    }
+
+  if(stage == Stage::ring)
+    {
+      const int send_to_rank((cross_rank + 1) % cross_size),
+        receive_from_rank((cross_size + cross_rank - 1) % cross_size);
+      for(; ring_step < cross_size; ++ring_step)
+        {
+          // The next receive goes into the buffer that the previous
+          // send went out from.
+          if(!receive_posted)
+            {
+              if(!is_complete(send_request, wait))
+                {
+                  return false;
+                }
+              const int final_receive_destination(
+                (cross_size + cross_rank - (ring_step + 1)) % cross_size);
+              check_mpi_error(MPI_Irecv(
+                ring_buffers[(ring_step + 1) % 2].data(),
+                message_size(final_receive_destination), MPI_BYTE,
+                receive_from_rank, final_receive_destination, cross_comm,
+                &receive_requests[(ring_step + 1) % 2]));
+              receive_posted = true;
+            }
+
+          // This waits for the receive from a previous step, not the
+          // one we just initiated.
+          if(!is_complete(receive_requests[ring_step % 2], wait))
+            {
+              return false;
+            }
+          const int final_send_destination(
+            (cross_size + cross_rank - ring_step) % cross_size);
+          El::byte *buffer(ring_buffers[ring_step % 2].data());
+          for(size_t index(destination_offsets[final_send_destination]);
+              index < destination_offsets[final_send_destination + 1];
+              ++index, buffer += slot_bytes)
+            {
+              add_packed(buffer, accumulator[index]);
+              pack(accumulator[index], buffer);
+            }
+          check_mpi_error(MPI_Isend(ring_buffers[ring_step % 2].data(),
+                                    message_size(final_send_destination),
+                                    MPI_BYTE, send_to_rank,
+                                    final_send_destination, cross_comm,
+                                    &send_request));
+          receive_posted = false;
+        }
+
+      // Add the local contribution to the last message and put it
+      // into the global Q.
+      if(cross_size > 1
+         && !is_complete(receive_requests[cross_size % 2], wait))
+        {
+          return false;
+        }
+      El::Matrix<El::BigFloat> &Q_local(Q.Matrix());
+      const El::byte *received(ring_buffers[cross_size % 2].data());
+      for(size_t index(destination_offsets[cross_rank]), element(0);
+          index < destination_offsets[cross_rank + 1]; ++index, ++element)
+        {
+          El::BigFloat &sum(accumulator[index]);
+          if(cross_size > 1)
+            {
+              add_packed(received + element * slot_bytes, sum);
+            }
+          Q_local(Q_local_rows[element], Q_local_columns[element]) = sum;
+        }
+      stage = Stage::finishing;
+    }
+
+  // Q is done, but the buffers are still in use until the last send
+  // and the barrier on the window finish.
+  if(!is_complete(send_request, wait) || !is_complete(window_request, wait))
+    {
+      return false;
+    }
+  stage = Stage::done;
+  done_time = std::chrono::high_resolution_clock::now();
+  return true;
+}
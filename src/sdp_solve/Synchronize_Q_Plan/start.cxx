@@ -0,0 +1,105 @@
+#include "../Synchronize_Q_Plan.hxx"
+#include "../check_mpi_error.hxx"
+#include "pack.hxx"
+
+void Synchronize_Q_Plan::start(const El::DistMatrix<El::BigFloat> &Q_group,
+                               El::DistMatrix<El::BigFloat> &Q)
+{
+  if(stage != Stage::idle && stage != Stage::done)
+    {
+      El::RuntimeError("Internal error: synchronize_Q started a panel that "
+                       "is still in flight");
+    }
+  start_time = std::chrono::high_resolution_clock::now();
+  const El::Matrix<El::BigFloat> &Q_group_local(Q_group.LockedMatrix());
+
+  // Special case serial case
+  if(is_serial())
+    {
+      El::Matrix<El::BigFloat> &Q_local(Q.Matrix());
+      const std::vector<size_t> &targets(peer_targets.front());
+      for(size_t index = 0; index < targets.size(); ++index)
+        {
+          Q_local(Q_local_rows[targets[index]],
+                  Q_local_columns[targets[index]])
+            = Q_group_local(local_rows[index], local_columns[index]);
+        }
+      stage = Stage::done;
+      done_time = start_time;
+      return;
+    }
+
+  allocate_buffers(synchronize_Q_slot_bytes());
+  for(auto &element : accumulator)
+    {
+      mpf_set_ui(element.gmp_float.get_mpf_t(), 0);
+    }
+
+  if(node_size == 1)
+    {
+      const std::vector<size_t> &targets(peer_targets.front());
+      for(size_t index = 0; index < targets.size(); ++index)
+        {
+          accumulator[targets[index]]
+            = Q_group_local(local_rows[index], local_columns[index]);
+        }
+      start_ring();
+      return;
+    }
+
+  // Every rank on the node packs what it holds into the shared
+  // window.  The representatives add it up once everyone is done.
+  El::byte *segment(peer_segments[node_rank]);
+  for(size_t index = 0; index < local_rows.size(); ++index)
+    {
+      pack(Q_group_local(local_rows[index], local_columns[index]),
+           segment + index * slot_bytes);
+    }
+  check_mpi_error(MPI_Win_sync(window));
+  check_mpi_error(MPI_Ibarrier(node_comm, &node_request));
+  stage = Stage::node;
+}
+
+void Synchronize_Q_Plan::start_ring()
+{
+  stage = Stage::ring;
+  ring_step = 2;
+  receive_posted = true;
+  if(cross_size == 1)
+    {
+      ring_step = cross_size;
+      return;
+    }
+
+  // This is an re-implementation of MPI_Reduce_scatter using the
+  // ring algorithm as found in OpenMPI, across the ranks with the
+  // same node rank.  It avoids constructing the full send buffer
+  // beforehand, adds up El::BigFloat's directly from the packed
+  // limbs, and does not block, so it can be advanced in between
+  // other work by progress().
+  const int send_to_rank((cross_rank + 1) % cross_size),
+    receive_from_rank((cross_size + cross_rank - 1) % cross_size);
+  const int final_receive_destination((cross_size + cross_rank - 2)
+                                      % cross_size),
+    final_send_destination((cross_size + cross_rank - 1) % cross_size);
+
+  // Initial async receive
+  check_mpi_error(MPI_Irecv(ring_buffers[0].data(),
+                            message_size(final_receive_destination), MPI_BYTE,
+                            receive_from_rank, final_receive_destination,
+                            cross_comm, &receive_requests[0]));
+
+  // Initial fill of send buffer
+  El::byte *insertion_point(ring_buffers[1].data());
+  for(size_t index(destination_offsets[final_send_destination]);
+      index < destination_offsets[final_send_destination + 1];
+      ++index, insertion_point += slot_bytes)
+    {
+      pack(accumulator[index], insertion_point);
+    }
+  check_mpi_error(MPI_Isend(ring_buffers[1].data(),
+                            message_size(final_send_destination), MPI_BYTE,
+                            send_to_rank, final_send_destination, cross_comm,
+                            &send_request));
+  receive_posted = false;
+}
@@ -0,0 +1,12 @@
+#include "../Synchronize_Q_Plan.hxx"
+
+// The number of bytes needed to pack one El::BigFloat at the current
+// precision: _mp_size and _mp_exp, followed by at most _mp_prec+1
+// limbs.  This is a multiple of 8 so that every slot stays aligned.
+size_t synchronize_Q_slot_bytes()
+{
+  El::BigFloat sample;
+  return sizeof(int64_t) * 2
+         + sizeof(mp_limb_t)
+             * (sample.gmp_float.get_mpf_t()->_mp_prec + 1);
+}
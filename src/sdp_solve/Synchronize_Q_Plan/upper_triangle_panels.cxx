@@ -0,0 +1,20 @@
+#include "../Synchronize_Q_Plan.hxx"
+
+#include <cmath>
+
+// Column c of the upper triangle has c+1 elements, so the number of
+// elements to the left of column c grows like c^2.
+std::vector<int64_t>
+upper_triangle_panels(const int64_t &N, const size_t &num_panels)
+{
+  std::vector<int64_t> result(num_panels + 1, N);
+  result.front() = 0;
+  for(size_t panel = 1; panel < num_panels; ++panel)
+    {
+      result[panel] = std::max(
+        result[panel - 1],
+        std::min(N, static_cast<int64_t>(std::round(
+                      N * std::sqrt(double(panel) / num_panels)))));
+    }
+  return result;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+// A fixed set of worker threads used to parallelize the local
+// BigFloat loops inside a single MPI rank.
+//
+// Only the main thread may call MPI (directly or through a
+// distributed Elemental routine).  Work handed to the pool must only
+// touch local El::Matrix data and must not call Timers::add_and_start.
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Thread_Pool
+{
+public:
+  // num_threads includes the calling thread, so num_threads==1 runs
+  // everything serially without starting any workers.
+  explicit Thread_Pool(const size_t &num_threads);
+  ~Thread_Pool();
+  Thread_Pool(const Thread_Pool &) = delete;
+  Thread_Pool &operator=(const Thread_Pool &) = delete;
+
+  size_t size() const { return workers.size() + 1; }
+
+  // Call f(index, thread) for every 0 <= index < num_indices, where
+  // 0 <= thread < size() identifies the calling thread so that f can
+  // use per-thread scratch space.  Indices are handed out one at a
+  // time, so uneven work is balanced automatically.  Returns after
+  // all calls have finished.  The first exception thrown by f is
+  // rethrown here.
+  void
+  parallel_for(const size_t &num_indices,
+               const std::function<void(const size_t &, const size_t &)> &f);
+
+private:
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable start_condition, done_condition;
+
+  const std::function<void(const size_t &, const size_t &)> *job = nullptr;
+  size_t job_size = 0, generation = 0, num_working = 0;
+  std::atomic<size_t> next_index;
+  std::exception_ptr exception;
+  bool stopping = false;
+
+  void worker_loop(const size_t &thread);
+  void run_job(const size_t &thread);
+};
@@ -0,0 +1,68 @@
+#include "../Thread_Pool.hxx"
+
+Thread_Pool::Thread_Pool(const size_t &num_threads) : next_index(0)
+{
+  for(size_t thread = 1; thread < num_threads; ++thread)
+    {
+      workers.emplace_back(&Thread_Pool::worker_loop, this, thread);
+    }
+}
+
+Thread_Pool::~Thread_Pool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  start_condition.notify_all();
+  for(auto &worker : workers)
+    {
+      worker.join();
+    }
+}
+
+void Thread_Pool::worker_loop(const size_t &thread)
+{
+  size_t seen_generation(0);
+  std::unique_lock<std::mutex> lock(mutex);
+  while(true)
+    {
+      start_condition.wait(lock, [&]() {
+        return stopping || generation != seen_generation;
+      });
+      if(stopping)
+        {
+          return;
+        }
+      seen_generation = generation;
+      lock.unlock();
+      run_job(thread);
+      lock.lock();
+      --num_working;
+      if(num_working == 0)
+        {
+          done_condition.notify_one();
+        }
+    }
+}
+
+void Thread_Pool::run_job(const size_t &thread)
+{
+  for(size_t index(next_index++); index < job_size; index = next_index++)
+    {
+      try
+        {
+          (*job)(index, thread);
+        }
+      catch(...)
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if(!exception)
+            {
+              exception = std::current_exception();
+            }
+          // Stop handing out work
+          next_index = job_size;
+        }
+    }
+}
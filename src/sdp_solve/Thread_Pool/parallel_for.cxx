@@ -0,0 +1,39 @@
+#include "../Thread_Pool.hxx"
+
+void Thread_Pool::parallel_for(
+  const size_t &num_indices,
+  const std::function<void(const size_t &, const size_t &)> &f)
+{
+  if(workers.empty() || num_indices < 2)
+    {
+      for(size_t index = 0; index < num_indices; ++index)
+        {
+          f(index, 0);
+        }
+      return;
+    }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = &f;
+    job_size = num_indices;
+    next_index = 0;
+    exception = nullptr;
+    num_working = workers.size();
+    ++generation;
+  }
+  start_condition.notify_all();
+  run_job(0);
+
+  std::exception_ptr job_exception;
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    done_condition.wait(lock, [&]() { return num_working == 0; });
+    job = nullptr;
+    std::swap(job_exception, exception);
+  }
+  if(job_exception)
+    {
+      std::rethrow_exception(job_exception);
+    }
+}
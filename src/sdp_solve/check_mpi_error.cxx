@@ -0,0 +1,15 @@
+#include "check_mpi_error.hxx"
+
+#include <string>
+#include <vector>
+
+void check_mpi_error(const int &mpi_error)
+{
+  if(mpi_error != MPI_SUCCESS)
+    {
+      std::vector<char> error_string(MPI_MAX_ERROR_STRING);
+      int lengthOfErrorString;
+      MPI_Error_string(mpi_error, error_string.data(), &lengthOfErrorString);
+      El::RuntimeError(std::string(error_string.data()));
+    }
+}
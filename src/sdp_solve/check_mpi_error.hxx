@@ -0,0 +1,9 @@
+#pragma once
+
+#include <El.hpp>
+
+// Raise an El::RuntimeError with MPI's description of mpi_error,
+// unless it is MPI_SUCCESS.  For the raw MPI calls that Elemental
+// does not wrap.
+
+void check_mpi_error(const int &mpi_error);
@@ -0,0 +1,60 @@
+#pragma once
+
+// Multiply BigFloat matrices using double precision BLAS.
+//
+// Each element x of a row (or column) with maximum binary exponent E
+// is written as
+//
+//   x = 2^E \sum_{l=0}^{L-1} x_l 2^{-(l+1) b}
+//
+// where the limbs x_l are integers with |x_l| < 2^b, stored as
+// doubles.  The product of two matrices is then a sum of products of
+// limb matrices.  The limb size b is chosen small enough that every
+// limb product is computed exactly by dgemm, so the only error comes
+// from dropping the terms with l+m >= L.  The exact integer results
+// are accumulated in int64_t and then added into the BigFloat result.
+
+#include <El.hpp>
+
+#include <vector>
+
+// Number of bits per limb such that a dot product of length
+// 'inner_dimension' of limbs is exact in double precision.
+size_t mpmat_limb_bits(const size_t &inner_dimension);
+
+// Number of limbs needed to reach the current GMP precision.
+size_t mpmat_num_limbs(const size_t &limb_bits,
+                       const size_t &inner_dimension);
+
+// The binary exponent of the largest element in each column (or row)
+std::vector<long>
+mpmat_exponents(const El::Matrix<El::BigFloat> &A, const bool &by_column);
+
+void mpmat_split(const El::Matrix<El::BigFloat> &A, const bool &by_column,
+                 const std::vector<long> &exponents, const size_t &limb_bits,
+                 std::vector<El::Matrix<double>> &limbs);
+
+// C(i,j) += accumulator(i,j) 2^(row_exponents[i] + column_exponents[j]
+//                               - shift)
+//
+// Only the 'uplo' triangle is updated if is_triangular is set.
+void mpmat_add_accumulator(const std::vector<int64_t> &accumulator,
+                           const std::vector<long> &row_exponents,
+                           const std::vector<long> &column_exponents,
+                           const size_t &shift, const bool &is_triangular,
+                           const El::UpperOrLower &uplo,
+                           El::Matrix<El::BigFloat> &C);
+
+// C := op(A) op(B) + beta C
+void mpmat_gemm(const El::Orientation &orientation_A,
+                const El::Orientation &orientation_B,
+                const El::Matrix<El::BigFloat> &A,
+                const El::Matrix<El::BigFloat> &B, const El::BigFloat &beta,
+                El::Matrix<El::BigFloat> &C);
+
+// C := A^T A + beta C   (orientation == TRANSPOSE)
+// C := A A^T + beta C   (orientation == NORMAL)
+void mpmat_syrk(const El::UpperOrLower &uplo,
+                const El::Orientation &orientation,
+                const El::Matrix<El::BigFloat> &A, const El::BigFloat &beta,
+                El::Matrix<El::BigFloat> &C);
@@ -0,0 +1,54 @@
+#include "../mpmat.hxx"
+
+// C := op(A) op(B) + beta C
+void mpmat_gemm(const El::Orientation &orientation_A,
+                const El::Orientation &orientation_B,
+                const El::Matrix<El::BigFloat> &A,
+                const El::Matrix<El::BigFloat> &B, const El::BigFloat &beta,
+                El::Matrix<El::BigFloat> &C)
+{
+  const bool transpose_A(orientation_A != El::OrientationNS::NORMAL),
+    transpose_B(orientation_B != El::OrientationNS::NORMAL);
+  const size_t inner_dimension(transpose_A ? A.Height() : A.Width());
+  const size_t limb_bits(mpmat_limb_bits(inner_dimension)),
+    num_limbs(mpmat_num_limbs(limb_bits, inner_dimension));
+
+  // Rows of op(A) and columns of op(B) each get their own exponent.
+  const std::vector<long> row_exponents(mpmat_exponents(A, transpose_A)),
+    column_exponents(mpmat_exponents(B, !transpose_B));
+
+  std::vector<El::Matrix<double>> A_limbs(num_limbs), B_limbs(num_limbs);
+  mpmat_split(A, transpose_A, row_exponents, limb_bits, A_limbs);
+  mpmat_split(B, !transpose_B, column_exponents, limb_bits, B_limbs);
+
+  if(beta == El::BigFloat(0))
+    {
+      El::Zero(C);
+    }
+  else if(beta != El::BigFloat(1))
+    {
+      C *= beta;
+    }
+
+  El::Matrix<double> product;
+  std::vector<int64_t> accumulator(C.Height() * C.Width());
+  for(size_t limb_sum = 0; limb_sum < num_limbs; ++limb_sum)
+    {
+      std::fill(accumulator.begin(), accumulator.end(), 0);
+      for(size_t limb_A = 0; limb_A <= limb_sum; ++limb_A)
+        {
+          El::Zeros(product, C.Height(), C.Width());
+          El::Gemm(orientation_A, orientation_B, 1.0, A_limbs[limb_A],
+                   B_limbs[limb_sum - limb_A], 0.0, product);
+          for(int64_t column = 0; column < C.Width(); ++column)
+            for(int64_t row = 0; row < C.Height(); ++row)
+              {
+                accumulator[row + column * C.Height()]
+                  += static_cast<int64_t>(product(row, column));
+              }
+        }
+      mpmat_add_accumulator(accumulator, row_exponents, column_exponents,
+                            (limb_sum + 2) * limb_bits, false,
+                            El::UpperOrLowerNS::LOWER, C);
+    }
+}
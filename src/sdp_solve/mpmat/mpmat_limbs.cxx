@@ -0,0 +1,170 @@
+#include "../mpmat.hxx"
+
+#include <limits>
+#include <stdexcept>
+
+size_t mpmat_limb_bits(const size_t &inner_dimension)
+{
+  size_t log2_inner(0);
+  while((size_t(1) << log2_inner) < inner_dimension)
+    {
+      ++log2_inner;
+    }
+  if(log2_inner + 2 > size_t(std::numeric_limits<double>::digits))
+    {
+      throw std::runtime_error(
+        "mpmat: inner dimension too large for exact products: "
+        + std::to_string(inner_dimension));
+    }
+  return (std::numeric_limits<double>::digits - log2_inner) / 2;
+}
+
+size_t mpmat_num_limbs(const size_t &limb_bits, const size_t &inner_dimension)
+{
+  // Guard bits to cover the sum of the dropped terms.
+  size_t guard_bits(16);
+  for(size_t dimension(inner_dimension); dimension > 1; dimension /= 2)
+    {
+      ++guard_bits;
+    }
+  const size_t result(
+    (mpf_get_default_prec() + guard_bits + limb_bits - 1) / limb_bits + 1);
+
+  // The int64_t accumulators hold up to 'result' exact products of
+  // size 2^53.
+  if(result >= 1024)
+    {
+      throw std::runtime_error("mpmat: too many limbs required: "
+                               + std::to_string(result));
+    }
+  return result;
+}
+
+std::vector<long>
+mpmat_exponents(const El::Matrix<El::BigFloat> &A, const bool &by_column)
+{
+  std::vector<long> result(by_column ? A.Width() : A.Height(),
+                           std::numeric_limits<long>::min());
+  for(int64_t column = 0; column < A.Width(); ++column)
+    for(int64_t row = 0; row < A.Height(); ++row)
+      {
+        mpf_srcptr element(A(row, column).gmp_float.get_mpf_t());
+        if(mpf_sgn(element) != 0)
+          {
+            long exponent;
+            mpf_get_d_2exp(&exponent, element);
+            long &max_exponent(result[by_column ? column : row]);
+            max_exponent = std::max(max_exponent, exponent);
+          }
+      }
+  for(auto &exponent : result)
+    {
+      if(exponent == std::numeric_limits<long>::min())
+        {
+          exponent = 0;
+        }
+    }
+  return result;
+}
+
+namespace
+{
+  // Bits [start, start+count) of |z|, with count < GMP_NUMB_BITS
+  uint64_t extract_bits(mpz_srcptr z, const size_t &start, const size_t &count)
+  {
+    const size_t limb(start / GMP_NUMB_BITS), offset(start % GMP_NUMB_BITS);
+    uint64_t result(mpz_getlimbn(z, limb) >> offset);
+    if(offset + count > GMP_NUMB_BITS)
+      {
+        result |= mpz_getlimbn(z, limb + 1) << (GMP_NUMB_BITS - offset);
+      }
+    return result & ((uint64_t(1) << count) - 1);
+  }
+}
+
+void mpmat_split(const El::Matrix<El::BigFloat> &A, const bool &by_column,
+                 const std::vector<long> &exponents, const size_t &limb_bits,
+                 std::vector<El::Matrix<double>> &limbs)
+{
+  const size_t total_bits(limbs.size() * limb_bits);
+  for(auto &limb : limbs)
+    {
+      limb.Resize(A.Height(), A.Width());
+    }
+
+  mpf_class scaled;
+  mpz_class integer;
+  for(int64_t column = 0; column < A.Width(); ++column)
+    for(int64_t row = 0; row < A.Height(); ++row)
+      {
+        // integer = trunc(A(row,column) 2^(total_bits - exponent))
+        const long shift(total_bits
+                         - exponents[by_column ? column : row]);
+        mpf_srcptr element(A(row, column).gmp_float.get_mpf_t());
+        if(shift >= 0)
+          {
+            mpf_mul_2exp(scaled.get_mpf_t(), element, shift);
+          }
+        else
+          {
+            mpf_div_2exp(scaled.get_mpf_t(), element, -shift);
+          }
+        mpz_set_f(integer.get_mpz_t(), scaled.get_mpf_t());
+
+        const double sign(mpz_sgn(integer.get_mpz_t()) < 0 ? -1 : 1);
+        for(size_t limb = 0; limb < limbs.size(); ++limb)
+          {
+            limbs[limb](row, column)
+              = sign
+                * extract_bits(integer.get_mpz_t(),
+                               total_bits - (limb + 1) * limb_bits,
+                               limb_bits);
+          }
+      }
+}
+
+void mpmat_add_accumulator(const std::vector<int64_t> &accumulator,
+                           const std::vector<long> &row_exponents,
+                           const std::vector<long> &column_exponents,
+                           const size_t &shift, const bool &is_triangular,
+                           const El::UpperOrLower &uplo,
+                           El::Matrix<El::BigFloat> &C)
+{
+  mpf_class term;
+  for(int64_t column = 0; column < C.Width(); ++column)
+    {
+      int64_t row_begin(0), row_end(C.Height());
+      if(is_triangular)
+        {
+          if(uplo == El::UpperOrLowerNS::UPPER)
+            {
+              row_end = column + 1;
+            }
+          else
+            {
+              row_begin = column;
+            }
+        }
+      for(int64_t row = row_begin; row < row_end; ++row)
+        {
+          const int64_t value(accumulator[row + column * C.Height()]);
+          if(value == 0)
+            {
+              continue;
+            }
+          mpf_set_si(term.get_mpf_t(), value);
+          const long exponent(row_exponents[row] + column_exponents[column]
+                              - static_cast<long>(shift));
+          if(exponent >= 0)
+            {
+              mpf_mul_2exp(term.get_mpf_t(), term.get_mpf_t(), exponent);
+            }
+          else
+            {
+              mpf_div_2exp(term.get_mpf_t(), term.get_mpf_t(), -exponent);
+            }
+          mpf_ptr element(C(row, column).gmp_float.get_mpf_t());
+          mpf_add(element, element, term.get_mpf_t());
+        }
+    }
+}
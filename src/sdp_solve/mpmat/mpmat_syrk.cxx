@@ -0,0 +1,79 @@
+#include "../mpmat.hxx"
+
+// C := A^T A + beta C   (orientation == TRANSPOSE)
+// C := A A^T + beta C   (orientation == NORMAL)
+//
+// Only the 'uplo' triangle of C is referenced.  The cross terms
+// A_l^T A_m and A_m^T A_l are transposes of each other, so we only
+// compute one of them.
+void mpmat_syrk(const El::UpperOrLower &uplo,
+                const El::Orientation &orientation,
+                const El::Matrix<El::BigFloat> &A, const El::BigFloat &beta,
+                El::Matrix<El::BigFloat> &C)
+{
+  const bool transpose(orientation != El::OrientationNS::NORMAL);
+  const size_t inner_dimension(transpose ? A.Height() : A.Width());
+  const size_t limb_bits(mpmat_limb_bits(inner_dimension)),
+    num_limbs(mpmat_num_limbs(limb_bits, inner_dimension));
+
+  const std::vector<long> exponents(mpmat_exponents(A, transpose));
+  std::vector<El::Matrix<double>> A_limbs(num_limbs);
+  mpmat_split(A, transpose, exponents, limb_bits, A_limbs);
+
+  const El::Orientation cross_A(transpose ? El::OrientationNS::TRANSPOSE
+                                          : El::OrientationNS::NORMAL),
+    cross_B(transpose ? El::OrientationNS::NORMAL
+                      : El::OrientationNS::TRANSPOSE);
+  const bool is_upper(uplo == El::UpperOrLowerNS::UPPER);
+  const int64_t size(C.Height());
+
+  for(int64_t column = 0; column < size; ++column)
+    for(int64_t row = (is_upper ? 0 : column);
+        row < (is_upper ? column + 1 : size); ++row)
+      {
+        El::BigFloat &element(C(row, column));
+        if(beta == El::BigFloat(0))
+          {
+            mpf_set_ui(element.gmp_float.get_mpf_t(), 0);
+          }
+        else if(beta != El::BigFloat(1))
+          {
+            element *= beta;
+          }
+      }
+
+  El::Matrix<double> product;
+  std::vector<int64_t> accumulator(size * size);
+  for(size_t limb_sum = 0; limb_sum < num_limbs; ++limb_sum)
+    {
+      std::fill(accumulator.begin(), accumulator.end(), 0);
+      for(size_t limb_A = 0; 2 * limb_A <= limb_sum; ++limb_A)
+        {
+          const size_t limb_B(limb_sum - limb_A);
+          El::Zeros(product, size, size);
+          if(limb_A == limb_B)
+            {
+              El::Syrk(uplo, orientation, 1.0, A_limbs[limb_A], 0.0,
+                       product);
+            }
+          else
+            {
+              El::Gemm(cross_A, cross_B, 1.0, A_limbs[limb_A],
+                       A_limbs[limb_B], 0.0, product);
+            }
+          for(int64_t column = 0; column < size; ++column)
+            for(int64_t row = (is_upper ? 0 : column);
+                row < (is_upper ? column + 1 : size); ++row)
+              {
+                int64_t &sum(accumulator[row + column * size]);
+                sum += static_cast<int64_t>(product(row, column));
+                if(limb_A != limb_B)
+                  {
+                    sum += static_cast<int64_t>(product(column, row));
+                  }
+              }
+        }
+      mpmat_add_accumulator(accumulator, exponents, exponents,
+                            (limb_sum + 2) * limb_bits, true, uplo, C);
+    }
+}
@@ -0,0 +1,16 @@
+#include "round_to_precision.hxx"
+
+void round_to_precision(El::Matrix<El::BigFloat> &matrix)
+{
+  const mp_bitcnt_t precision(mpf_get_default_prec());
+  BigFloat_Slab_Scope slab_scope(matrix.Height() * matrix.Width());
+  for(int64_t column = 0; column < matrix.Width(); ++column)
+    for(int64_t row = 0; row < matrix.Height(); ++row)
+      {
+        mpf_ptr element(matrix(row, column).gmp_float.get_mpf_t());
+        if(element->_mp_d != nullptr)
+          {
+            mpf_set_prec(element, precision);
+          }
+      }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Block_Diagonal_Matrix.hxx"
+#include "Block_Matrix.hxx"
+#include "Block_Vector.hxx"
+
+#include <El.hpp>
+
+#include <vector>
+
+// Change the precision of existing numbers to the current working
+// precision, in place.  Raising the precision pads the mantissa with
+// zeros, and lowering it rounds towards zero.  The limbs of each
+// matrix are moved into a new slab, so they stay contiguous (see
+// BigFloat_Slab.hxx).  Elements that have been explicitly cleared,
+// like the lower half of Q_group, are left alone.
+//
+// Every El::BigFloat in an MPI message is assumed to have the working
+// precision, so everything that is communicated must be rounded
+// whenever the working precision changes.
+
+void round_to_precision(El::Matrix<El::BigFloat> &matrix);
+
+inline void round_to_precision(El::BigFloat &number)
+{
+  mpf_set_prec(number.gmp_float.get_mpf_t(), mpf_get_default_prec());
+}
+
+inline void round_to_precision(El::DistMatrix<El::BigFloat> &matrix)
+{
+  round_to_precision(matrix.Matrix());
+}
+
+template <class Matrix> void round_to_precision(std::vector<Matrix> &blocks)
+{
+  for(auto &block : blocks)
+    {
+      round_to_precision(block);
+    }
+}
+
+inline void round_to_precision(Block_Vector &v)
+{
+  round_to_precision(v.blocks);
+}
+
+inline void round_to_precision(Block_Matrix &A)
+{
+  round_to_precision(A.blocks);
+}
+
+inline void round_to_precision(Block_Diagonal_Matrix &A)
+{
+  round_to_precision(A.blocks);
+}
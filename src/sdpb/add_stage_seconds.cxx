@@ -0,0 +1,40 @@
+#include "../sdp_solve.hxx"
+#include "../sdp_solve/Cost_Profile.hxx"
+
+// Add the per-block stage times in timers, summed over all processes,
+// to stage_seconds(block, stage), and the number of iterations that
+// they cover to num_iterations.  Blocks are indexed as in the SDP, so
+// the times from runs with different mappings, before and after the
+// blocks are rebalanced, can be added together.
+//
+// Every process must call this.
+
+void add_stage_seconds(const Block_Info &block_info, const Timers &timers,
+                       El::Matrix<double> &stage_seconds,
+                       size_t &num_iterations)
+{
+  const std::vector<std::string> &stages(cost_profile_stages());
+  El::Matrix<double> seconds;
+  El::Zeros(seconds, block_info.dimensions.size(), stages.size());
+  for(size_t stage = 0; stage < stages.size(); ++stage)
+    {
+      auto total(timers.block_total.find(stages[stage]));
+      if(total == timers.block_total.end())
+        {
+          continue;
+        }
+      for(size_t block = 0; block < total->second.size(); ++block)
+        {
+          seconds(block_info.block_indices.at(block), stage)
+            = std::chrono::duration<double>(total->second[block]).count();
+        }
+    }
+  El::AllReduce(seconds, El::mpi::COMM_WORLD);
+
+  if(stage_seconds.Height() == 0)
+    {
+      El::Zeros(stage_seconds, seconds.Height(), seconds.Width());
+    }
+  stage_seconds += seconds;
+  num_iterations += timers.num_block_iterations;
+}
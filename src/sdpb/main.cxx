@@ -6,13 +6,33 @@
 //=======================================================================
 
 #include "../sdp_solve.hxx"
+#include "../sdp_solve/Block_Migration.hxx"
+#include "../sdp_solve/MPI_Thread_Environment.hxx"
 
 #include <El.hpp>
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 
-Timers
-solve(const Block_Info &block_info, const SDP_Solver_Parameters &parameters);
+Timers solve(const Block_Info &block_info,
+             const SDP_Solver_Parameters &parameters,
+             Block_Migration &migration);
+
+void write_block_timings(const boost::filesystem::path &checkpoint_out,
+                         const El::Matrix<int32_t> &block_timings);
+
+void write_estimated_block_timings(
+  const boost::filesystem::path &checkpoint_out,
+  const std::vector<Block_Cost> &estimated_costs);
+
+void add_stage_seconds(const Block_Info &block_info, const Timers &timers,
+                       El::Matrix<double> &stage_seconds,
+                       size_t &num_iterations);
+
+void write_cost_profile(const boost::filesystem::path &cost_profile_directory,
+                        const boost::filesystem::path &sdp_directory,
+                        const Block_Info &block_info,
+                        const El::Matrix<double> &stage_seconds,
+                        const size_t &num_iterations);
 
 void write_timing(const boost::filesystem::path &checkpoint_out,
                   const Block_Info &block_info, const Timers &timers,
@@ -20,6 +40,7 @@ void write_timing(const boost::filesystem::path &checkpoint_out,
 
 int main(int argc, char **argv)
 {
+  MPI_Thread_Environment mpi_env(argc, argv);
   El::Environment env(argc, argv);
 
   try
@@ -29,6 +50,7 @@ int main(int argc, char **argv)
         {
           return 0;
         }
+      mpi_env.check_num_threads(parameters.num_threads);
 
       El::gmp::SetPrecision(parameters.precision);
       if(parameters.verbosity >= Verbosity::regular && El::mpi::Rank() == 0)
@@ -39,14 +61,34 @@ int main(int argc, char **argv)
         }
 
       Block_Info block_info(parameters.sdp_directory, parameters.checkpoint_in,
+                            parameters.cost_profile_directory,
                             parameters.procs_per_node,
-                            parameters.proc_granularity, parameters.verbosity);
+                            parameters.proc_granularity,
+                            parameters.max_memory_per_node,
+                            parameters.verbosity);
+      if(!block_info.cost_profile_filename.empty()
+         && parameters.verbosity >= Verbosity::regular
+         && El::mpi::Rank() == 0)
+        {
+          std::cout << "Allocating blocks from the cost profile "
+                    << block_info.cost_profile_filename << "\n";
+        }
+      if(!block_info.estimated_costs.empty()
+         && parameters.verbosity >= Verbosity::debug)
+        {
+          write_estimated_block_timings(parameters.checkpoint_out,
+                                        block_info.estimated_costs);
+        }
       // Only generate a block_timings file if
-      // 1) We are running in parallel
-      // 2) We did not load a block_timings file
-      // 3) We are not going to load a checkpoint.
-      if(El::mpi::Size(El::mpi::COMM_WORLD) > 1
+      // 1) The user asked for a timing run
+      // 2) We are running in parallel
+      // 3) We did not load a block_timings file or a cost profile
+      // 4) We are not going to load a checkpoint.
+      // Otherwise, without a block_timings file, Block_Info estimates
+      // the costs of the blocks with a cost model.
+      if(parameters.timing_run && El::mpi::Size(El::mpi::COMM_WORLD) > 1
          && block_info.block_timings_filename.empty()
+         && block_info.cost_profile_filename.empty()
          && !exists(parameters.checkpoint_in / "checkpoint.0"))
         {
           if(parameters.verbosity >= Verbosity::regular
@@ -63,11 +105,15 @@ int main(int argc, char **argv)
           timing_parameters.duality_gap_threshold = 0;
           timing_parameters.primal_error_threshold = 0;
           timing_parameters.dual_error_threshold = 0;
+          timing_parameters.rebalance_threshold = 0;
+          // The timing run is cut short, so it does not add a sample.
+          timing_parameters.cost_profile_directory.clear();
           if(timing_parameters.verbosity != Verbosity::debug)
             {
               timing_parameters.verbosity = Verbosity::none;
             }
-          Timers timers(solve(block_info, timing_parameters));
+          Block_Migration migration;
+          Timers timers(solve(block_info, timing_parameters, migration));
 
           El::Matrix<int32_t> block_timings(block_info.dimensions.size(), 1);
           write_timing(timing_parameters.checkpoint_out, block_info, timers,
@@ -76,7 +122,8 @@ int main(int argc, char **argv)
           El::mpi::Barrier(El::mpi::COMM_WORLD);
           Block_Info new_info(
             parameters.sdp_directory, block_timings, parameters.procs_per_node,
-            parameters.proc_granularity, parameters.verbosity);
+            parameters.proc_granularity, parameters.max_memory_per_node,
+            parameters.verbosity);
           std::swap(block_info, new_info);
 
           parameters.max_runtime -= timers.front().second.elapsed_seconds();
@@ -93,7 +140,49 @@ int main(int argc, char **argv)
                         boost::filesystem::copy_option::overwrite_if_exists);
             }
         }
-      solve(block_info, parameters);
+      // The stage times of every part of the run, before and after
+      // any rebalancing, go into a single cost profile sample.
+      const bool is_profiling(!parameters.cost_profile_directory.empty());
+      El::Matrix<double> stage_seconds;
+      size_t stage_iterations(0);
+
+      Block_Migration migration;
+      Timers timers(solve(block_info, parameters, migration));
+      if(is_profiling)
+        {
+          add_stage_seconds(block_info, timers, stage_seconds,
+                            stage_iterations);
+        }
+      // Each time the solver stops because the blocks are unbalanced,
+      // allocate them again from the costs that it measured, and
+      // continue with the iterates in migration.
+      while(migration.is_pending)
+        {
+          write_block_timings(parameters.checkpoint_out,
+                              migration.block_timings);
+          Block_Info new_info(parameters.sdp_directory,
+                              migration.block_timings,
+                              parameters.procs_per_node,
+                              parameters.proc_granularity,
+                              parameters.max_memory_per_node,
+                              parameters.verbosity);
+          std::swap(block_info, new_info);
+
+          parameters.max_runtime -= timers.front().second.elapsed_seconds();
+          parameters.max_iterations -= migration.num_iterations;
+          timers = solve(block_info, parameters, migration);
+          if(is_profiling)
+            {
+              add_stage_seconds(block_info, timers, stage_seconds,
+                                stage_iterations);
+            }
+        }
+      if(is_profiling)
+        {
+          write_cost_profile(parameters.cost_profile_directory,
+                             parameters.sdp_directory, block_info,
+                             stage_seconds, stage_iterations);
+        }
     }
   catch(std::exception &e)
     {
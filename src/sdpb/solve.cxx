@@ -6,24 +6,55 @@
 //=======================================================================
 
 #include "../sdp_solve.hxx"
+#include "../sdp_solve/Block_Migration.hxx"
 #include "../set_stream_precision.hxx"
 
 #include <El.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/filesystem.hpp>
 
-Timers
-solve(const Block_Info &block_info, const SDP_Solver_Parameters &parameters)
+// If migration is pending, the solver continues from the iterates in
+// it instead of loading a checkpoint, and the SDP comes from it
+// instead of sdpDir.  If the solver stops to rebalance the blocks,
+// its iterates and SDP are saved in migration, and nothing is written
+// out.
+
+Timers solve(const Block_Info &block_info,
+             const SDP_Solver_Parameters &parameters,
+             Block_Migration &migration)
 {
   // Read an SDP from sdpFile and create a solver for it
   El::Grid grid(block_info.mpi_comm.value);
-  SDP sdp(parameters.sdp_directory, block_info, grid);
-  SDP_Solver solver(parameters, block_info, grid,
+  SDP sdp(migration.is_pending
+            ? SDP(migration.objective_const, migration.dual_objective_b,
+                  grid)
+            : SDP(parameters.sdp_directory, block_info, grid));
+  SDP_Solver_Parameters solver_parameters(parameters);
+  if(migration.is_pending)
+    {
+      solver_parameters.checkpoint_in.clear();
+    }
+  SDP_Solver solver(solver_parameters, block_info, grid,
                     sdp.dual_objective_b.Height());
+  if(migration.is_pending)
+    {
+      migration.restore(block_info, sdp, solver);
+      // Checkpoints written before the migration can only be read
+      // with the old mapping, so replace them.
+      if(solver.current_generation != 0)
+        {
+          solver.save_checkpoint(parameters);
+        }
+    }
 
   Timers timers(parameters.verbosity >= Verbosity::debug);
   SDP_Solver_Terminate_Reason reason
     = solver.run(parameters, block_info, sdp, grid, timers);
+  if(reason == SDP_Solver_Terminate_Reason::RebalanceBlocks)
+    {
+      migration.save(block_info, sdp, solver);
+      return timers;
+    }
 
   if(parameters.verbosity >= Verbosity::regular && El::mpi::Rank() == 0)
     {
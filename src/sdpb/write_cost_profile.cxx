@@ -0,0 +1,95 @@
+#include "../sdp_solve.hxx"
+#include "../sdp_solve/Cost_Profile.hxx"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/interprocess/sync/file_lock.hpp>
+
+// Add the per-block stage times in stage_seconds, from
+// add_stage_seconds, to the Cost_Profile for this SDP in
+// cost_profile_directory, as one sample.  The times are averaged over
+// the num_iterations iterations that they cover, and normalized by
+// the time for one multiply-add at the current precision.  Iterations
+// at a lower working precision, with initialPrecision, are normalized
+// as if they were at the full precision, which slightly lowers every
+// cost.
+//
+// Every process must call this, but only rank 0 writes.  A profile
+// that can not be read is replaced.
+//
+// Runs that finish at the same time would otherwise read the same
+// profile, and the last one to write it would drop the samples of
+// the others.  So the profile is read, updated and written while
+// holding a lock on a separate file next to it, with the profile's
+// name and ".lock" added.  If the file system does not support locks,
+// a warning is printed and the profile is updated without one, so
+// concurrent runs may lose samples.  Readers in read_block_costs do
+// not need the lock, because the profile is replaced by a rename.
+
+void calibrate_cost_model(double &gemm_seconds, double &cholesky_seconds);
+
+size_t
+read_dual_objective_b_height(const boost::filesystem::path &sdp_directory);
+
+void write_cost_profile(const boost::filesystem::path &cost_profile_directory,
+                        const boost::filesystem::path &sdp_directory,
+                        const Block_Info &block_info,
+                        const El::Matrix<double> &stage_seconds,
+                        const size_t &num_iterations)
+{
+  if(num_iterations == 0)
+    {
+      return;
+    }
+  Cost_Profile sample(read_dual_objective_b_height(sdp_directory),
+                      block_info.dimensions, block_info.degrees);
+  sample.stages = cost_profile_stages();
+
+  double gemm_seconds, cholesky_seconds;
+  calibrate_cost_model(gemm_seconds, cholesky_seconds);
+  if(El::mpi::Rank() != 0)
+    {
+      return;
+    }
+
+  sample.costs.resize(block_info.dimensions.size());
+  for(size_t block = 0; block < sample.costs.size(); ++block)
+    for(size_t stage = 0; stage < sample.stages.size(); ++stage)
+      {
+        sample.costs[block].push_back(stage_seconds(block, stage)
+                                      / num_iterations / gemm_seconds);
+      }
+  sample.num_samples = 1;
+
+  const boost::filesystem::path filename(
+    sample.filename(cost_profile_directory));
+  create_directories(cost_profile_directory);
+  const boost::filesystem::path lock_filename(filename.string() + ".lock");
+  boost::interprocess::file_lock lock;
+  try
+    {
+      boost::filesystem::ofstream(lock_filename, std::ios::app);
+      boost::interprocess::file_lock(lock_filename.string().c_str())
+        .swap(lock);
+      lock.lock();
+    }
+  catch(boost::interprocess::interprocess_exception &error)
+    {
+      std::cerr << "Updating " << filename << " without a lock: "
+                << error.what() << "\n";
+    }
+
+  Cost_Profile profile(sample.dual_objective_b_height, sample.dimensions,
+                       sample.degrees);
+  if(exists(filename))
+    {
+      try
+        {
+          profile = Cost_Profile(filename);
+        }
+      catch(std::exception &)
+        {}
+    }
+  profile.add_sample(sample);
+  profile.write(filename);
+}
@@ -0,0 +1,38 @@
+#include "../Block_Cost.hxx"
+
+#include <El.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+// Write the costs from the cost model in the same format as
+// block_timings, so that build/block_grid_mapping can compare the
+// mapping that they give with the one from a timing run.  This is
+// not named block_timings, because nothing should read it back.
+
+void write_estimated_block_timings(
+  const boost::filesystem::path &checkpoint_out,
+  const std::vector<Block_Cost> &estimated_costs)
+{
+  if(El::mpi::Rank() == 0)
+    {
+      boost::filesystem::create_directories(checkpoint_out);
+      boost::filesystem::path estimated_path(checkpoint_out
+                                             / "estimated_block_timings");
+      boost::filesystem::ofstream estimated_file(estimated_path);
+      std::vector<size_t> costs(estimated_costs.size(), 0);
+      for(auto &block_cost : estimated_costs)
+        {
+          costs.at(block_cost.index) = block_cost.cost;
+        }
+      for(auto &cost : costs)
+        {
+          estimated_file << cost << "\n";
+        }
+      if(!estimated_file.good())
+        {
+          throw std::runtime_error("Error when writing to: "
+                                   + estimated_path.string());
+        }
+    }
+}
@@ -1,7 +1,9 @@
 #include "../sdp_solve.hxx"
 
 #include <boost/filesystem.hpp>
-#include <boost/filesystem/fstream.hpp>
+
+void write_block_timings(const boost::filesystem::path &checkpoint_out,
+                         const El::Matrix<int32_t> &block_timings);
 
 void write_timing(const boost::filesystem::path &checkpoint_out,
                   const Block_Info &block_info, const Timers &timers,
@@ -30,20 +32,5 @@ void write_timing(const boost::filesystem::path &checkpoint_out,
                                     + std::to_string(index));
     }
   El::AllReduce(block_timings, El::mpi::COMM_WORLD);
-  if(El::mpi::Rank() == 0)
-    {
-      boost::filesystem::create_directories(checkpoint_out);
-      boost::filesystem::path block_timings_path(checkpoint_out
-                                                 / "block_timings");
-      boost::filesystem::ofstream block_timings_file(block_timings_path);
-      for(int64_t row = 0; row < block_timings.Height(); ++row)
-        {
-          block_timings_file << block_timings(row, 0) << "\n";
-        }
-      if(!block_timings_file.good())
-        {
-          throw std::runtime_error("Error when writing to: "
-                                   + block_timings_path.string());
-        }
-    }
+  write_block_timings(checkpoint_out, block_timings);
 }
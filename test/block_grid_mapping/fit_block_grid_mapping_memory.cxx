@@ -0,0 +1,195 @@
+#include "../../src/compute_block_grid_mapping.hxx"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+
+// Check fit_block_grid_mapping_memory on small mappings that need
+// each of its repairs (a swap, a move, and a split followed by a
+// move), on one that cannot fit, and on random mappings.  Every
+// result must keep each block exactly once, the same procs on each
+// node, and group costs that match their blocks.  If the result is
+// true, every node must also be within the limit.  Run from
+// run_test.sh, and returns nonzero if any check fails.
+
+namespace
+{
+  struct Case
+  {
+    std::string name;
+    std::vector<Block_Cost> costs;
+    std::vector<size_t> block_memory;
+    size_t group_memory = 0, proc_memory = 0, max_memory = 0;
+    std::vector<std::vector<Block_Map>> mapping;
+  };
+
+  size_t num_procs(const std::vector<Block_Map> &groups)
+  {
+    size_t result(0);
+    for(auto &block_map : groups)
+      {
+        result += block_map.num_procs;
+      }
+    return result;
+  }
+
+  bool is_consistent(const Case &test,
+                     const std::vector<std::vector<Block_Map>> &mapping,
+                     const bool &is_fit)
+  {
+    std::vector<size_t> costs(test.block_memory.size(), 0);
+    for(auto &block_cost : test.costs)
+      {
+        costs.at(block_cost.index) = block_cost.cost;
+      }
+    bool result(mapping.size() == test.mapping.size());
+    std::multiset<size_t> blocks;
+    for(size_t node = 0; result && node < mapping.size(); ++node)
+      {
+        result = num_procs(mapping[node]) == num_procs(test.mapping[node]);
+        for(auto &block_map : mapping[node])
+          {
+            size_t cost(0);
+            for(auto &block : block_map.block_indices)
+              {
+                blocks.insert(block);
+                cost += costs.at(block);
+              }
+            result = result && block_map.num_procs > 0
+                     && cost == block_map.cost;
+          }
+      }
+    for(size_t block = 0; result && block < costs.size(); ++block)
+      {
+        result = blocks.count(block) == 1;
+      }
+    if(result && is_fit)
+      {
+        const std::vector<size_t> node_memory(block_grid_mapping_memory(
+          mapping, test.block_memory, test.group_memory, test.proc_memory));
+        result = *std::max_element(node_memory.begin(), node_memory.end())
+                 <= test.max_memory;
+      }
+    return result;
+  }
+
+  bool check(const Case &test, const bool &expected)
+  {
+    std::vector<std::vector<Block_Map>> mapping(test.mapping);
+    const bool is_fit(fit_block_grid_mapping_memory(
+      test.costs, test.block_memory, test.group_memory, test.proc_memory,
+      test.max_memory, mapping));
+    const bool result(is_fit == expected
+                      && is_consistent(test, mapping, is_fit));
+    if(!result)
+      {
+        std::cerr << "FAIL fit_block_grid_mapping_memory: " << test.name
+                  << "\n";
+      }
+    return result;
+  }
+
+  // Block i has cost costs[i] and memory memory[i].
+  Case make_case(const std::string &name, const std::vector<size_t> &costs,
+                 const std::vector<size_t> &memory, const size_t &max_memory,
+                 const std::vector<std::vector<Block_Map>> &mapping)
+  {
+    Case result;
+    result.name = name;
+    for(size_t block = 0; block < costs.size(); ++block)
+      {
+        result.costs.emplace_back(costs[block], block);
+      }
+    result.block_memory = memory;
+    result.max_memory = max_memory;
+    result.mapping = mapping;
+    return result;
+  }
+}
+
+int main()
+{
+  bool result(true);
+
+  // Trading one of the large blocks for a small one balances the
+  // nodes.
+  result = check(make_case("swap", {1, 1, 1, 1}, {100, 100, 10, 10}, 150,
+                           {{Block_Map(1, 1, {0}), Block_Map(1, 1, {1})},
+                            {Block_Map(1, 1, {2}), Block_Map(1, 1, {3})}}),
+                 true)
+           && result;
+
+  // A swap would put too much on node 1, but moving one block fits.
+  result = check(make_case("move", {1, 1, 1}, {60, 60, 10}, 100,
+                           {{Block_Map(1, 2, {0, 1})},
+                            {Block_Map(1, 1, {2})}}),
+                 true)
+           && result;
+
+  // Node 1 has no single proc group to move a block into, so a proc
+  // is split off of its group first.
+  result
+    = check(make_case("split", {1, 1, 1, 1}, {50, 50, 10, 1}, 80,
+                      {{Block_Map(1, 2, {0, 1}), Block_Map(1, 1, {3})},
+                       {Block_Map(2, 1, {2})}}),
+            true)
+      && result;
+
+  // Every block is larger than the limit.
+  result = check(make_case("too large", {1, 1}, {100, 100}, 50,
+                           {{Block_Map(1, 1, {0})}, {Block_Map(1, 1, {1})}}),
+                 false)
+           && result;
+
+  // Random mappings from compute_block_grid_mapping, with limits
+  // between the average and the largest node.  Whether they fit is
+  // not known, so only the consistency of the result is checked.
+  std::mt19937 generator(2);
+  for(size_t trial = 0; trial < 1000; ++trial)
+    {
+      const size_t procs_per_node(1 + generator() % 8),
+        num_nodes(2 + generator() % 4), num_blocks(1 + generator() % 40);
+      Case test;
+      test.name = "random " + std::to_string(trial);
+      test.group_memory = 5;
+      test.proc_memory = 3;
+      for(size_t block = 0; block < num_blocks; ++block)
+        {
+          test.costs.emplace_back(generator() % 3 == 0
+                                    ? 1 + generator() % 100000
+                                    : 1 + generator() % 1000,
+                                  block);
+          test.block_memory.push_back(1 + generator() % 1000);
+        }
+      std::sort(test.costs.rbegin(), test.costs.rend());
+      test.mapping
+        = compute_block_grid_mapping(procs_per_node, num_nodes, test.costs);
+      const std::vector<size_t> node_memory(
+        block_grid_mapping_memory(test.mapping, test.block_memory,
+                                  test.group_memory, test.proc_memory));
+      size_t total(0);
+      for(auto &memory : node_memory)
+        {
+          total += memory;
+        }
+      const size_t largest(
+        *std::max_element(node_memory.begin(), node_memory.end()));
+      test.max_memory = total / num_nodes
+                        + (largest - total / num_nodes)
+                            * (50 + generator() % 50) / 100;
+
+      std::vector<std::vector<Block_Map>> mapping(test.mapping);
+      const bool is_fit(fit_block_grid_mapping_memory(
+        test.costs, test.block_memory, test.group_memory, test.proc_memory,
+        test.max_memory, mapping));
+      if(!is_consistent(test, mapping, is_fit))
+        {
+          std::cerr << "FAIL fit_block_grid_mapping_memory: " << test.name
+                    << "\n";
+          result = false;
+        }
+    }
+  return result ? 0 : 1;
+}
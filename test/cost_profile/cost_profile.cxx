@@ -0,0 +1,137 @@
+#include "../../src/sdp_solve/Cost_Profile.hxx"
+
+#include <boost/filesystem/fstream.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+// Write a Cost_Profile, read it back, add samples to it, and check
+// the block costs.  Run from run_test.sh, with a scratch directory as
+// the argument, and returns nonzero if any check fails.
+
+namespace
+{
+  bool is_close(const double &a, const double &b)
+  {
+    return std::abs(a - b) <= 1e-9 * std::max(std::abs(a), std::abs(b));
+  }
+
+  bool is_same(const Cost_Profile &a, const Cost_Profile &b)
+  {
+    bool result(a.is_same_structure(b) && a.stages == b.stages
+                && a.num_samples == b.num_samples
+                && a.costs.size() == b.costs.size());
+    for(size_t block = 0; result && block < a.costs.size(); ++block)
+      {
+        result = a.costs[block].size() == b.costs[block].size();
+        for(size_t stage = 0; result && stage < a.costs[block].size();
+            ++stage)
+          {
+            result = is_close(a.costs[block][stage], b.costs[block][stage]);
+          }
+      }
+    return result;
+  }
+
+  bool check(const bool &is_passed, const std::string &name)
+  {
+    if(!is_passed)
+      {
+        std::cerr << "FAIL Cost_Profile: " << name << "\n";
+      }
+    return is_passed;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if(argc != 2)
+    {
+      std::cerr << "Need 1 argument: a scratch directory\n";
+      exit(1);
+    }
+  const boost::filesystem::path directory(argv[1]);
+  create_directories(directory);
+  bool result(true);
+
+  Cost_Profile sample(7, {1, 2, 3}, {4, 5, 6});
+  sample.stages = {"cholesky", "syrk"};
+  sample.costs = {{1, 2}, {3, 4}, {5.25, 1e-7}};
+  sample.num_samples = 1;
+
+  // The name only depends on the structure.
+  const boost::filesystem::path filename(sample.filename(directory));
+  result = check(filename == Cost_Profile(7, {1, 2, 3}, {4, 5, 6})
+                                .filename(directory)
+                   && filename
+                        != Cost_Profile(8, {1, 2, 3}, {4, 5, 6})
+                             .filename(directory)
+                   && filename
+                        != Cost_Profile(7, {1, 2, 3}, {4, 5, 7})
+                             .filename(directory),
+                 "filename")
+           && result;
+
+  sample.write(filename);
+  result = check(is_same(Cost_Profile(filename), sample), "round trip")
+           && result;
+
+  // The first sample replaces an empty profile.  The second one is
+  // averaged in with weight 1/2, and a stage that only it has is
+  // added as is.
+  Cost_Profile profile(7, {1, 2, 3}, {4, 5, 6});
+  profile.add_sample(sample);
+  result = check(is_same(profile, sample), "first sample") && result;
+
+  Cost_Profile second(sample);
+  second.stages = {"syrk", "solve"};
+  second.costs = {{4, 10}, {6, 20}, {1e-7, 30}};
+  profile.add_sample(second);
+  Cost_Profile expected(sample);
+  expected.stages = {"cholesky", "syrk", "solve"};
+  expected.costs = {{1, 3, 10}, {3, 5, 20}, {5.25, 1e-7, 30}};
+  expected.num_samples = 2;
+  result = check(is_same(profile, expected), "second sample") && result;
+
+  profile.write(filename);
+  const Cost_Profile read_profile(filename);
+  result = check(is_same(read_profile, expected), "second round trip")
+           && result;
+
+  // Each block costs the rounded sum of its stages.
+  const std::vector<Block_Cost> block_costs(read_profile.block_costs());
+  result = check(block_costs.size() == 3 && block_costs[0].cost == 14
+                   && block_costs[0].index == 0 && block_costs[1].cost == 28
+                   && block_costs[1].index == 1
+                   && block_costs[2].cost == 35 && block_costs[2].index == 2,
+                 "block_costs")
+           && result;
+
+  // A sample from a different structure replaces the profile.
+  Cost_Profile other(7, {1, 2}, {4, 5});
+  other.stages = {"syrk"};
+  other.costs = {{1}, {2}};
+  other.num_samples = 1;
+  profile.add_sample(other);
+  result = check(is_same(profile, other), "different structure") && result;
+
+  // Anything else is rejected when read.
+  {
+    boost::filesystem::ofstream corrupt(directory / "corrupt");
+    corrupt << "block_timings 1\n";
+  }
+  bool is_rejected(false);
+  try
+    {
+      Cost_Profile corrupt(directory / "corrupt");
+    }
+  catch(std::runtime_error &)
+    {
+      is_rejected = true;
+    }
+  result = check(is_rejected, "unknown format") && result;
+
+  return result ? 0 : 1;
+}
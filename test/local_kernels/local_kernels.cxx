@@ -0,0 +1,408 @@
+#include "../../src/sdp_solve/Cholesky_Inverse.hxx"
+#include "../../src/sdp_solve/SDP_Solver/run/compute_bilinear_pairings/bilinear_pairing_blocks.hxx"
+#include "../../src/sdp_solve/SDP_Solver/run/step/compute_search_direction/search_direction_blocks.hxx"
+#include "../../src/sdp_solve/SDP_Solver/run/step/step_length/step_length_blocks.hxx"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Check that the local El::Matrix path for blocks on a single rank
+// gives exactly the same numbers as the El::DistMatrix path on a 1x1
+// grid, which is what those blocks used before.  Each check runs the
+// same code from the solver on El::Matrix copies of its inputs, and
+// on El::DistMatrix copies on a grid over COMM_SELF, and compares
+// every element of every matrix afterwards with mpf_cmp.  Scalar
+// results are stored in a small output matrix so that they are
+// compared the same way.
+//
+// The blocked algorithms in Elemental split their work into panels of
+// El::Blocksize(), so the sizes straddle multiples of it.  A block
+// size of 8 goes through the same panel boundaries as the default at
+// a fraction of the cost, and the default is also checked once.  Run
+// from run_test.sh, and returns nonzero if any check fails.
+//
+// The parts of the local path that are loops in SDPB itself
+// (compute_schur_complement, scale_columns, symmetrize_block) are the
+// same code for both paths, and are not checked separately.
+
+namespace
+{
+  using Local = El::Matrix<El::BigFloat>;
+  using Distributed = El::DistMatrix<El::BigFloat>;
+
+  gmp_randstate_t random_state;
+
+  // Uniform in [-1, 1), with every bit of the precision set.
+  El::BigFloat random_number()
+  {
+    El::BigFloat result;
+    mpf_urandomb(result.gmp_float.get_mpf_t(), random_state,
+                 mpf_get_default_prec());
+    return 2 * result - 1;
+  }
+
+  Local random_matrix(const int64_t &height, const int64_t &width)
+  {
+    Local result(height, width);
+    for(int64_t column = 0; column < width; ++column)
+      for(int64_t row = 0; row < height; ++row)
+        {
+          result(row, column) = random_number();
+        }
+    return result;
+  }
+
+  // A Cholesky factor, with a diagonal in [2, 4) and, like the output
+  // of El::Cholesky, garbage above the diagonal.
+  Local random_cholesky(const int64_t &size)
+  {
+    Local result(random_matrix(size, size));
+    for(int64_t index = 0; index < size; ++index)
+      {
+        result(index, index) = 3 + random_number();
+      }
+    return result;
+  }
+
+  // L L^T + size I, for a random lower triangular L
+  Local random_positive_definite(const int64_t &size)
+  {
+    Local lower(random_cholesky(size)), result;
+    El::MakeTrapezoidal(El::UpperOrLowerNS::LOWER, lower);
+    El::Zeros(result, size, size);
+    El::Gemm(El::Orientation::NORMAL, El::Orientation::TRANSPOSE,
+             El::BigFloat(1), lower, lower, El::BigFloat(0), result);
+    El::ShiftDiagonal(result, El::BigFloat(size));
+    return result;
+  }
+
+  // 1 \otimes base on and below the block diagonal, as from
+  // fill_bilinear_workspace, with garbage above it.
+  Local bilinear_workspace(const Local &base, const int64_t &m)
+  {
+    Local result(random_matrix(m * base.Height(), m * base.Width()));
+    for(int64_t s = 0; s < m; ++s)
+      for(int64_t column = 0; column < base.Width(); ++column)
+        for(int64_t row = (s + 1) * base.Height();
+            row < m * base.Height(); ++row)
+          {
+            result(row, s * base.Width() + column) = 0;
+          }
+    for(int64_t s = 0; s < m; ++s)
+      for(int64_t column = 0; column < base.Width(); ++column)
+        for(int64_t row = 0; row < base.Height(); ++row)
+          {
+            result(s * base.Height() + row, s * base.Width() + column)
+              = base(row, column);
+          }
+    return result;
+  }
+
+  bool is_equal(const Local &a, const Local &b)
+  {
+    bool result(a.Height() == b.Height() && a.Width() == b.Width());
+    for(int64_t column = 0; result && column < a.Width(); ++column)
+      for(int64_t row = 0; result && row < a.Height(); ++row)
+        {
+          result = (mpf_cmp(a(row, column).gmp_float.get_mpf_t(),
+                            b(row, column).gmp_float.get_mpf_t())
+                    == 0);
+        }
+    return result;
+  }
+
+  // Run local_kernel on El::Matrix copies of inputs, and
+  // distributed_kernel on El::DistMatrix copies on grid, and compare
+  // all of them afterwards.
+  template <typename Local_Kernel, typename Distributed_Kernel>
+  bool check(const std::string &name, const El::Grid &grid,
+             const std::vector<Local> &inputs, Local_Kernel local_kernel,
+             Distributed_Kernel distributed_kernel)
+  {
+    std::vector<Local> local(inputs);
+    std::vector<Distributed> distributed;
+    distributed.reserve(inputs.size());
+    for(auto &input : inputs)
+      {
+        distributed.emplace_back(input.Height(), input.Width(), grid);
+        for(int64_t column = 0; column < input.Width(); ++column)
+          for(int64_t row = 0; row < input.Height(); ++row)
+            {
+              distributed.back().SetLocal(row, column, input(row, column));
+            }
+      }
+
+    local_kernel(local);
+    distributed_kernel(distributed);
+
+    bool result(true);
+    for(size_t index = 0; index < inputs.size(); ++index)
+      {
+        result = is_equal(local[index], distributed[index].LockedMatrix())
+                 && result;
+      }
+    if(!result)
+      {
+        std::cerr << "FAIL local kernels: " << name
+                  << ", block size " << El::Blocksize() << ", size "
+                  << inputs.front().Height() << "\n";
+      }
+    return result;
+  }
+
+  template <typename Kernel>
+  bool check(const std::string &name, const El::Grid &grid,
+             const std::vector<Local> &inputs, Kernel kernel)
+  {
+    return check(name, grid, inputs, kernel, kernel);
+  }
+
+  bool check_all(const El::Grid &grid, const int64_t &n)
+  {
+    const Multiply_Backend gmp(Multiply_Backend::gmp);
+    const El::BigFloat beta_mu(random_number());
+    bool result(true);
+
+    // Cholesky_Inverse::compute, cholesky_solve_block and
+    // inverse_congruence_block, with and without L^{-1}
+    El::BigFloat max_condition(1);
+    mpf_mul_2exp(max_condition.gmp_float.get_mpf_t(),
+                 max_condition.gmp_float.get_mpf_t(),
+                 mpf_get_default_prec() / 2);
+    result = check("invert_lower_block", grid,
+                   {random_cholesky(n), random_matrix(n, n), Local(1, 1)},
+                   [&](auto &m) {
+                     m[2].Set(0, 0,
+                              invert_lower_block(m[0], max_condition, m[1])
+                                ? 1
+                                : 0);
+                   })
+             && result;
+
+    Local L(random_cholesky(n)), L_inverse(L);
+    El::MakeTrapezoidal(El::UpperOrLowerNS::LOWER, L_inverse);
+    El::TriangularInverse(El::UpperOrLowerNS::LOWER,
+                          El::UnitOrNonUnit::NON_UNIT, L_inverse);
+    for(const bool is_cached : {false, true})
+      {
+        const std::string suffix(is_cached ? " cached" : "");
+        result = check("cholesky_solve_block" + suffix, grid,
+                       {L, L_inverse, random_matrix(n, n),
+                        random_matrix(n, n)},
+                       [&](auto &m) {
+                         cholesky_solve_block(m[0],
+                                              is_cached ? &m[1] : nullptr,
+                                              gmp, m[2], m[3]);
+                       })
+                 && result;
+        result = check("inverse_congruence_block" + suffix, grid,
+                       {L, L_inverse, random_matrix(n, n)}, [&](auto &m) {
+                         inverse_congruence_block(
+                           m[0], is_cached ? &m[1] : nullptr, m[2]);
+                       })
+                 && result;
+
+        // compute_search_direction
+        for(const bool is_corrector : {false, true})
+          {
+            result
+              = check(std::string(is_corrector ? "corrector" : "predictor")
+                        + " R_and_Z_block" + suffix,
+                      grid,
+                      {random_matrix(n, n), random_matrix(n, n), L,
+                       L_inverse, random_matrix(n, n), random_matrix(n, n),
+                       random_matrix(n, n), random_matrix(n, n),
+                       random_matrix(n, n), random_matrix(n, n)},
+                      [&](auto &m) {
+                        R_and_Z_block(is_corrector, m[0], m[1], m[2],
+                                      is_cached ? &m[3] : nullptr, m[4],
+                                      m[5], m[6], beta_mu, gmp, m[7], m[8],
+                                      m[9]);
+                      })
+                && result;
+          }
+        result = check("dY_block" + suffix, grid,
+                       {random_matrix(n, n), L, L_inverse,
+                        random_matrix(n, n), random_matrix(n, n),
+                        random_matrix(n, n), random_matrix(n, n)},
+                       [&](auto &m) {
+                         dY_block(m[0], m[1], is_cached ? &m[2] : nullptr,
+                                  m[3], m[4], beta_mu, gmp, m[5], m[6]);
+                       })
+                 && result;
+      }
+
+    // The bilinear pairings, for a block with m = 2 and a base of
+    // n x (n + 1) / 2
+    {
+      const int64_t m(2), base_width((n + 1) / 2);
+      const Local base(random_matrix(n, base_width)),
+        workspace(bilinear_workspace(base, m)),
+        X_cholesky(random_cholesky(m * n));
+      Local X_cholesky_inverse(X_cholesky);
+      El::MakeTrapezoidal(El::UpperOrLowerNS::LOWER, X_cholesky_inverse);
+      El::TriangularInverse(El::UpperOrLowerNS::LOWER,
+                            El::UnitOrNonUnit::NON_UNIT, X_cholesky_inverse);
+      const Local result_block(random_matrix(m * base_width, m * base_width));
+      result = check("bilinear_pairings_X_inv_block", grid,
+                     {X_cholesky, workspace, result_block}, [&](auto &M) {
+                       bilinear_pairings_X_inv_block(M[0], n, base_width, gmp,
+                                                     M[1], M[2]);
+                     })
+               && result;
+      result = check("bilinear_pairings_X_inv_cached_block", grid,
+                     {X_cholesky_inverse, base, workspace, result_block},
+                     [&](auto &M) {
+                       bilinear_pairings_X_inv_cached_block(M[0], M[1], gmp,
+                                                            M[2], M[3]);
+                     })
+               && result;
+      result = check("bilinear_pairings_Y_block", grid,
+                     {random_positive_definite(m * n), base, workspace,
+                      result_block},
+                     [&](auto &M) {
+                       bilinear_pairings_Y_block(M[0], M[1], gmp, M[2], M[3]);
+                     })
+               && result;
+      result = check("bilinear_pairings_Y_cholesky_block", grid,
+                     {X_cholesky, base, workspace, result_block},
+                     [&](auto &M) {
+                       bilinear_pairings_Y_cholesky_block(M[0], M[1], gmp,
+                                                          M[2], M[3]);
+                     })
+               && result;
+
+      // constraint_matrix_weighted_sum: the diagonal and off-diagonal
+      // sub-blocks, and the final symmetrization.
+      result = check("constraint sub-blocks", grid,
+                     {base, random_matrix(n, base_width),
+                      random_matrix(2 * n, 2 * n)},
+                     [&](auto &M) {
+                       auto diagonal(El::View(M[2], 0, 0, n, n)),
+                         off_diagonal(El::View(M[2], 0, n, n, n));
+                       El::Trrk(El::UpperOrLowerNS::UPPER,
+                                El::Orientation::NORMAL,
+                                El::Orientation::TRANSPOSE, El::BigFloat(1),
+                                M[0], M[1], El::BigFloat(0), diagonal);
+                       El::Gemm(El::Orientation::NORMAL,
+                                El::Orientation::TRANSPOSE,
+                                El::BigFloat(0.5), M[0], M[1],
+                                El::BigFloat(0), off_diagonal);
+                       El::MakeSymmetric(El::UpperOrLowerNS::UPPER, M[2]);
+                     })
+               && result;
+    }
+
+    // step_lengths
+    {
+      const Local M(random_positive_definite(n)), dM(random_matrix(n, n));
+      Local M_cholesky(M);
+      El::Cholesky(El::UpperOrLowerNS::LOWER, M_cholesky);
+      result = check("lanczos_min_eigenvalue", grid,
+                     {M_cholesky, dM, Local(2, 1)}, [&](auto &m) {
+                       El::BigFloat eigenvalue(0);
+                       const bool is_converged(
+                         lanczos_min_eigenvalue(m[0], m[1], eigenvalue));
+                       m[2].Set(0, 0, eigenvalue);
+                       m[2].Set(1, 0, is_converged ? 1 : 0);
+                     })
+               && result;
+      for(const double step : {0.5, 100.0})
+        {
+          result = check("is_positive_definite_step", grid,
+                         {M, dM, random_matrix(n, n), Local(1, 1)},
+                         [&](auto &m) {
+                           m[3].Set(0, 0,
+                                    is_positive_definite_step(
+                                      m[0], m[1], El::BigFloat(step), m[2])
+                                      ? 1
+                                      : 0);
+                         })
+                   && result;
+        }
+    }
+
+    // initialize_Q_group: the Cholesky decomposition and solve of
+    // each block, and then Q_group from column strips.  The local path
+    // splits Q_group into a number of strips that depends on the
+    // number of threads, and the distributed one into the panels of
+    // the Synchronize_Q_Plan's, so the splits differ on purpose.
+    {
+      const int64_t width(n + 3);
+      result = check("Schur complement Cholesky and solve", grid,
+                     {random_positive_definite(n), random_matrix(n, width)},
+                     [&](auto &m) {
+                       El::Cholesky(El::UpperOrLowerNS::LOWER, m[0]);
+                       El::Trsm(El::LeftOrRightNS::LEFT,
+                                El::UpperOrLowerNS::LOWER,
+                                El::OrientationNS::NORMAL,
+                                El::UnitOrNonUnitNS::NON_UNIT,
+                                El::BigFloat(1), m[0], m[1]);
+                     })
+               && result;
+
+      auto Q_group_strips([&](const std::vector<int64_t> &boundaries) {
+        return [&, boundaries](auto &m) {
+          for(size_t strip = 0; strip + 1 < boundaries.size(); ++strip)
+            {
+              const int64_t begin(boundaries[strip]),
+                end(boundaries[strip + 1]);
+              auto Q_rectangle(El::View(m[2], 0, begin, begin, end - begin)),
+                Q_square(
+                  El::View(m[2], begin, begin, end - begin, end - begin));
+              for(size_t block = 0; block < 2; ++block)
+                {
+                  const auto A_strip(El::LockedView(
+                    m[block], 0, begin, m[block].Height(), end - begin));
+                  if(begin != 0)
+                    {
+                      gemm(gmp, El::OrientationNS::TRANSPOSE,
+                           El::OrientationNS::NORMAL,
+                           El::LockedView(m[block], 0, 0, m[block].Height(),
+                                          begin),
+                           A_strip, El::BigFloat(1), Q_rectangle);
+                    }
+                  syrk(gmp, El::UpperOrLowerNS::UPPER,
+                       El::OrientationNS::TRANSPOSE, A_strip,
+                       El::BigFloat(1), Q_square);
+                }
+            }
+        };
+      });
+      Local Q_group;
+      El::Zeros(Q_group, width, width);
+      result = check("Q_group strips", grid,
+                     {random_matrix(n, width), random_matrix(n + 1, width),
+                      Q_group},
+                     Q_group_strips({0, 1, width / 2 + 1, width - 1, width}),
+                     Q_group_strips({0, width / 3, width}))
+               && result;
+    }
+    return result;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  El::Environment env(argc, argv);
+  El::gmp::SetPrecision(1024);
+  gmp_randinit_default(random_state);
+  gmp_randseed_ui(random_state, 2);
+
+  const El::Grid grid(El::mpi::COMM_SELF);
+  bool result(true);
+
+  const int64_t default_block_size(El::Blocksize()), block_size(8);
+  El::SetBlocksize(block_size);
+  for(const int64_t n : {int64_t(1), block_size - 1, block_size,
+                         block_size + 1, 2 * block_size + 3})
+    {
+      result = check_all(grid, n) && result;
+    }
+  El::SetBlocksize(default_block_size);
+  result = check_all(grid, default_block_size + 1) && result;
+
+  gmp_randclear(random_state);
+  return result ? 0 : 1;
+}
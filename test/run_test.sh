@@ -3,6 +3,59 @@
 # Run this from the top level directory
 result=0
 
+# Compare two files of numbers, number by number, to a relative
+# tolerance of $3.  Fails if either file is missing or empty, or if
+# they differ in the number of lines or of numbers on a line.
+compare_numbers() {
+    paste -d '|' "$1" "$2" | awk -F '|' -v tolerance="$3" '
+        function abs(v) {return v < 0 ? -v : v}
+        {
+            n = split($1, a, " ")
+            if(NF != 2 || n == 0 || split($2, b, " ") != n)
+                exit 1
+            for(i = 1; i <= n; ++i)
+                if(abs(a[i] - b[i]) > tolerance * (abs(a[i]) > abs(b[i]) ? abs(a[i]) : abs(b[i])) + 1e-30)
+                    exit 1
+        }
+        END {if(NR == 0) exit 1}'
+}
+
+# Compare x_0.txt and y.txt in two output directories to a relative
+# tolerance of 1e-10.  Runs that move blocks between procs sum Q and
+# the reductions in a different order, so their results only agree to
+# within rounding, which the remaining iterations can amplify.
+compare_solution() {
+    for file in x_0.txt y.txt
+    do
+        compare_numbers "$1/$file" "$2/$file" 1e-10 || return 1
+    done
+}
+
+# Print the primal and dual objectives in $1/out.txt.
+objectives() {
+    grep -E '^(primal|dual)Objective' "$1/out.txt" | sed 's/.*= *//; s/;$//'
+}
+
+# Compare an output directory with test/test_out_orig.  The symmetric
+# kernels add up the Frobenius products and traces over the lower
+# triangle, and the scalar reductions are batched, so the rounding
+# differs from the run that wrote test_out_orig.  primalError and
+# dualError are at the level of that rounding, around 1e-305, and the
+# last digits of everything else differ too, so an exact diff cannot
+# pass.  Instead the terminateReason must match, which means that the
+# gap and errors are below their thresholds of 1e-30, and the
+# objectives and the solution must match to within the precision of a
+# double.
+compare_reference() {
+    [ -n "$(grep '^terminateReason' "$1/out.txt")" ] || return 1
+    [ "$(grep '^terminateReason' "$1/out.txt")" == "$(grep '^terminateReason' test/test_out_orig/out.txt)" ] || return 1
+    compare_numbers <(objectives "$1") <(objectives test/test_out_orig) 1e-14 || return 1
+    for file in x_0.txt y.txt
+    do
+        compare_numbers "$1/$file" "test/test_out_orig/$file" 1e-14 || return 1
+    done
+}
+
 rm -rf test/test/
 ./build/pvm2sdp 1024 test/file_list.nsv test/test/
 if [ $? == 0 ]
@@ -15,7 +68,7 @@ fi
 
 rm -f test/test.out
 ./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/test/ --verbosity=0
-diff test/test_out test/test_out_orig
+compare_reference test/test_out
 if [ $? == 0 ]
 then
     echo "PASS SDPB"
@@ -23,6 +76,188 @@ else
     echo "FAIL SDPB"
     result=1
 fi
+
+# Blocks on a single rank take the local El::Matrix path.  Check that
+# it gives exactly the same numbers as the El::DistMatrix path on a
+# 1x1 grid, kernel by kernel.
+./build/test_local_kernels
+if [ $? == 0 ]
+then
+    echo "PASS local kernels"
+else
+    echo "FAIL local kernels"
+    result=1
+fi
+
+# Each block is computed by one thread, and the split of Q into
+# strips, which depends on the number of threads, is checked above, so
+# the number of threads must not change the answer at all.
+rm -rf test/io_tests
+mkdir -p test/io_tests
+./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/test/ -c test/io_tests/ck -o test/io_tests/out --numThreads=2 --verbosity=0
+diff test/test_out test/io_tests/out
+if [ $? == 0 ]
+then
+    echo "PASS threads"
+else
+    echo "FAIL threads"
+    result=1
+fi
+rm -rf test/io_tests
+
+# Time the blocks with a timing run, and check that, with those
+# times, the slowest group of the mapping from the cost model is
+# within 10% of the slowest group of the mapping from the timing run.
+# The blocks of cost_model_test.xml have degrees from 10 to 80, so
+# their times differ by orders of magnitude, and a bad model would
+# put two of the large ones on the same proc.
+mkdir -p test/io_tests
+./build/pvm2sdp 1024 test/cost_model_test.xml test/io_tests/sdp
+mpirun -n 2 --quiet ./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/io_tests/sdp -c test/io_tests/timing -o test/io_tests/out --maxIterations=1 --timingRun --verbosity=0
+mpirun -n 2 --quiet ./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/io_tests/sdp -c test/io_tests/estimated -o test/io_tests/out --maxIterations=1 --verbosity=2 > /dev/null
+./build/block_grid_mapping 1 2 test/io_tests/timing/block_timings test/io_tests/estimated/estimated_block_timings > test/io_tests/mapping
+ratio=$(awk '/^Estimated \/ refined:/ {print $4}' test/io_tests/mapping)
+awk -v ratio="$ratio" 'BEGIN {exit !(ratio != "" && ratio <= 1.1)}'
+if [ $? == 0 ]
+then
+    echo "PASS cost model mapping"
+else
+    echo "FAIL cost model mapping"
+    result=1
+fi
+
+# The same check must fail for an estimate that gets the order of the
+# blocks wrong, and must not compare times that are all 0 ms.
+printf "100\n60\n40\n" > test/io_tests/timed
+printf "40\n60\n100\n" > test/io_tests/wrong
+printf "0\n0\n0\n" > test/io_tests/zero
+ratio=$(./build/block_grid_mapping 1 2 test/io_tests/timed test/io_tests/wrong | awk '/^Estimated \/ refined:/ {print $4}')
+awk -v ratio="$ratio" 'BEGIN {exit !(ratio != "" && ratio > 1.1)}' && ! ./build/block_grid_mapping 1 2 test/io_tests/zero test/io_tests/wrong > /dev/null 2>&1
+if [ $? == 0 ]
+then
+    echo "PASS cost model mapping check"
+else
+    echo "FAIL cost model mapping check"
+    result=1
+fi
+rm -rf test/io_tests
+
+# Move the blocks of an SDP with several blocks every 5 iterations,
+# and check that x and y agree with a run that does not move them.
+mkdir -p test/io_tests
+./build/pvm2sdp 1024 test/cost_model_test.xml test/io_tests/sdp
+mpirun -n 2 --quiet ./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/io_tests/sdp -c test/io_tests/ck_fixed -o test/io_tests/out_fixed --maxIterations=20 --verbosity=0
+mpirun -n 2 --quiet ./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/io_tests/sdp -c test/io_tests/ck -o test/io_tests/out --maxIterations=20 --rebalanceThreshold=0.5 --rebalanceInterval=5 --verbosity=0
+compare_solution test/io_tests/out_fixed test/io_tests/out
+if [ $? == 0 ]
+then
+    echo "PASS rebalance"
+else
+    echo "FAIL rebalance"
+    result=1
+fi
+rm -rf test/io_tests
+
+# Check that the checkpoint written after the blocks moved can be
+# read back, and that the solver finishes with the same x and y.
+mkdir -p test/io_tests
+mpirun -n 2 --quiet ./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/test/ -c test/io_tests/ck_fixed -o test/io_tests/out_fixed --verbosity=0
+mpirun -n 2 --quiet ./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/test/ -c test/io_tests/ck -o test/io_tests/out --checkpointInterval=0 --rebalanceThreshold=0.5 --rebalanceInterval=5 --verbosity=0
+mpirun -n 2 --quiet ./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/test/ -c test/io_tests/ck -o test/io_tests/out_restart --verbosity=0 && compare_solution test/io_tests/out_fixed test/io_tests/out_restart
+if [ $? == 0 ]
+then
+    echo "PASS rebalance checkpoint"
+else
+    echo "FAIL rebalance checkpoint"
+    result=1
+fi
+rm -rf test/io_tests
+
+./build/test_fit_block_grid_mapping_memory
+if [ $? == 0 ]
+then
+    echo "PASS fit memory"
+else
+    echo "FAIL fit memory"
+    result=1
+fi
+
+# Two blocks of cost 50 take 50 on 1 proc and 25 on 2 procs, but the
+# 3 procs of a node together take 33.3 for both.  The refined mapping
+# must merge them into one group.
+slowest=$(./build/block_grid_mapping 3 2 50 50 50 1 1 1 1 | awk '/^Refined/ {refined=1} refined && /^Slowest group:/ {print $3}')
+awk -v slowest="$slowest" 'BEGIN {exit !(slowest != "" && slowest < 33.34)}'
+if [ $? == 0 ]
+then
+    echo "PASS merge groups"
+else
+    echo "FAIL merge groups"
+    result=1
+fi
+
+# The test SDP cannot fit in 1K, so sdpb must stop and say why.  It
+# easily fits in 1G, and must give the same answer as without a limit.
+mkdir -p test/io_tests
+mpirun -n 2 --quiet ./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/test/ -c test/io_tests/ck -o test/io_tests/out --maxMemoryPerNode=1K --verbosity=0 2> test/io_tests/error > /dev/null
+if [ $? != 0 ] && grep -q "does not fit in maxMemoryPerNode" test/io_tests/error
+then
+    echo "PASS maxMemoryPerNode report"
+else
+    echo "FAIL maxMemoryPerNode report"
+    result=1
+fi
+rm -rf test/io_tests
+
+mkdir -p test/io_tests
+./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/test/ -c test/io_tests/ck -o test/io_tests/out --maxMemoryPerNode=1G --verbosity=0
+diff test/test_out/x_0.txt test/io_tests/out/x_0.txt && diff test/test_out/y.txt test/io_tests/out/y.txt
+if [ $? == 0 ]
+then
+    echo "PASS maxMemoryPerNode"
+else
+    echo "FAIL maxMemoryPerNode"
+    result=1
+fi
+rm -rf test/io_tests
+
+./build/test_cost_profile test/io_tests
+if [ $? == 0 ]
+then
+    echo "PASS cost profile"
+else
+    echo "FAIL cost profile"
+    result=1
+fi
+rm -rf test/io_tests
+
+# The first run writes a cost profile.  The second one, with a new
+# checkpoint directory and so no block_timings, must allocate its
+# blocks from that profile, give the same answer, and add its sample.
+mkdir -p test/io_tests
+mpirun -n 2 --quiet ./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/test/ -c test/io_tests/ck_first -o test/io_tests/out_first --costProfileDir=test/io_tests/profiles --verbosity=0
+mpirun -n 2 --quiet ./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/test/ -c test/io_tests/ck -o test/io_tests/out --costProfileDir=test/io_tests/profiles --verbosity=1 > test/io_tests/output
+grep -q "Allocating blocks from the cost profile" test/io_tests/output && diff test/io_tests/out_first/y.txt test/io_tests/out/y.txt && grep -q "^samples 2$" test/io_tests/profiles/cost_profile.????????????????
+if [ $? == 0 ]
+then
+    echo "PASS cost profile reuse"
+else
+    echo "FAIL cost profile reuse"
+    result=1
+fi
+rm -rf test/io_tests
+
+# A run with a timing run, that also moves its blocks several times,
+# still adds only one sample.
+mkdir -p test/io_tests
+mpirun -n 2 --quiet ./build/sdpb --precision=1024 --noFinalCheckpoint --procsPerNode=1 -s test/test/ -c test/io_tests/ck -o test/io_tests/out --costProfileDir=test/io_tests/profiles --timingRun --checkpointInterval=0 --rebalanceThreshold=0.5 --rebalanceInterval=5 --verbosity=0
+grep -q "^samples 1$" test/io_tests/profiles/cost_profile.????????????????
+if [ $? == 0 ]
+then
+    echo "PASS cost profile samples"
+else
+    echo "FAIL cost profile samples"
+    result=1
+fi
 rm -rf test/io_tests
 
 mkdir -p test/io_tests